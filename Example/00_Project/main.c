@@ -7,10 +7,10 @@
 int main()
 {
 	NVIC_PriorityGroupConfig(NVIC_PriorityGroup_4);
-	//رJTAG
+	//关闭JTAG调试
 	RCC_APB2PeriphClockCmd(RCC_APB2Periph_AFIO ,ENABLE);
 	GPIO_PinRemapConfig(GPIO_Remap_SWJ_JTAGDisable, ENABLE);
-	//ʼ
+	//常用外设初始化
 	bsp_usart1_init(115200);
 	delay_init();
 	
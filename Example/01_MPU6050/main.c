@@ -1,6 +1,7 @@
 #include "main.h"
  
 #include "bsp_delay.h"
+#include "bsp_timebase.h"
 #include "bsp_usart.h"
 #include "bsp_sys.h" 
  
@@ -9,17 +10,129 @@
 #include "control.h" 
  
 #include "bsp_soft_i2c.h" 
+#include "bsp_hard_i2c.h"
+#include "bsp_i2c_queue.h"
+#include "bus_ops.h"
+#include "mpu6050.h"
+
+//1: MPU6050经硬件I2C1请求队列访问（PB6/PB7由硬件I2C接管）  0: 软件I2C1
+#define APP_MPU6050_I2C_QUEUE  0
+//1: 启动时对比软件I2C逐字节读取与块读取14字节的总线时间（需开启 I2C_TRACE_ENABLE）
+#define APP_SOFT_I2C_BENCH     0
+#define APP_BENCH_ROUNDS       32
+
+#if APP_SOFT_I2C_BENCH
+#include "bsp_i2c_trace.h"
+#if !I2C_TRACE_ENABLE || APP_MPU6050_I2C_QUEUE
+#error "APP_SOFT_I2C_BENCH 需要开启 I2C_TRACE_ENABLE 并使用软件I2C1"
+#endif
+
+/* 逐字节读取（块读取之前的做法），作为对照 */
+static uint8_t app_read_bytewise(uint8_t addr,uint8_t reg,uint8_t len,uint8_t *buf)
+{
+	uint8_t i;
+
+	if(soft_i2c_start(SOFT_I2C1))
+		return 1;
+	soft_i2c_send_byte(SOFT_I2C1,addr<<1);
+	if(soft_i2c_wait_ack(SOFT_I2C1))
+		return 1;
+	soft_i2c_send_byte(SOFT_I2C1,reg);
+	if(soft_i2c_wait_ack(SOFT_I2C1))
+		return 1;
+	if(soft_i2c_start(SOFT_I2C1))
+	{
+		soft_i2c_stop(SOFT_I2C1);
+		return 1;
+	}
+	soft_i2c_send_byte(SOFT_I2C1,(addr<<1)|1);
+	if(soft_i2c_wait_ack(SOFT_I2C1))
+		return 1;
+	for(i = 0; i < len; i++)
+		buf[i] = soft_i2c_read_byte(SOFT_I2C1,i + 1 < len);
+	soft_i2c_stop(SOFT_I2C1);
+	return 0;
+}
+
+/**
+  * @brief  测量14字节读取（START到STOP）的总线时间
+  * @note   时间取自跟踪记录的DWT周期数，每种方式读 APP_BENCH_ROUNDS 次取最小值，排除中断的影响
+  * @param  block: 1块读取 0逐字节读取
+  * @retval 最短一次的周期数，全部失败时为0
+  */
+static uint32_t app_bench_read(uint8_t block)
+{
+	i2c_trace_rec_t rec;
+	uint8_t buf[MPU6050_FRAME_LEN];
+	uint32_t best = 0;
+	uint8_t i;
+
+	for(i = 0; i < APP_BENCH_ROUNDS; i++)
+	{
+		if(block)
+			soft_i2c_read_dev_len_byte(SOFT_I2C1,MPU6050_ADDR,MPU_ACCEL_XOUTH_REG,MPU6050_FRAME_LEN,buf);
+		else
+			app_read_bytewise(MPU6050_ADDR,MPU_ACCEL_XOUTH_REG,MPU6050_FRAME_LEN,buf);
+		while(i2c_trace_read(&rec))
+		{
+			if(!(rec.flags & (I2C_TRACE_F_NACK | I2C_TRACE_F_ERR)) && (best == 0 || rec.cycles < best))
+				best = rec.cycles;
+		}
+	}
+	return best;
+}
+
+/**
+  * @brief  在标准、快速模式下对比逐字节读取与块读取，结果从串口输出
+  * @retval 无
+  */
+static void app_soft_i2c_bench(void)
+{
+	static const char *name[2] = {"100k", "400k"};
+	uint32_t mhz = SystemCoreClock / 1000000;
+	uint32_t t_byte, t_block;
+	uint8_t speed;
+
+	i2c_trace_init();
+	for(speed = SOFT_I2C_SPEED_STANDARD; speed <= SOFT_I2C_SPEED_FAST; speed++)
+	{
+		soft_i2c_set_speed(SOFT_I2C1,(SOFT_I2C_Speed_TypeDef)speed);
+		t_byte  = app_bench_read(0);
+		t_block = app_bench_read(1);
+		if(t_byte == 0 || t_block == 0)
+		{
+			printf("bench %s: read failed\r\n",name[speed]);
+			continue;
+		}
+		printf("bench %s: byte %lu us, block %lu us, -%lu%%\r\n",name[speed],
+		       (unsigned long)(t_byte / mhz),(unsigned long)(t_block / mhz),
+		       (unsigned long)((t_byte - t_block) * 100 / t_byte));
+	}
+	soft_i2c_set_speed(SOFT_I2C1,soft_i2c_bus[SOFT_I2C1].speed);
+}
+#endif
  
 int main()
 {
 	NVIC_PriorityGroupConfig(NVIC_PriorityGroup_4);
-	//رJTAG
+	//关闭JTAG调试
 	RCC_APB2PeriphClockCmd(RCC_APB2Periph_AFIO ,ENABLE);
 	GPIO_PinRemapConfig(GPIO_Remap_SWJ_JTAGDisable, ENABLE);
-	//ʼ
+	//常用外设初始化
 	bsp_usart1_init(115200);
 	delay_init();
+	timebase_init();
+#if APP_MPU6050_I2C_QUEUE
+	hard_i2c_init(HARD_I2C1, 400000);
+	i2c_queue_init(HARD_I2C1);
+	//MPU6050的FIFO_R_W地址不递增，经同一实例读取，不开启合并；一帧数据应在2ms内读完
+	mpu6050_set_bus(bus_i2c_queue(HARD_I2C1, 0, 0, 2000));
+#else
 	soft_i2c_init(SOFT_I2C1);
+#endif
+#if APP_SOFT_I2C_BENCH
+	app_soft_i2c_bench();
+#endif
 	app_run_main();
 	
 	while(1)
@@ -20,8 +20,8 @@ void exp_continuous_measure()
 		{
 			printf("continuous Light = %.2f lux\r\n", lux);
 		}
-		/* ߷ֱģʽ£ÿβ 120ms */
-        delay_ms(1000);  // 滻Ϊʱ
+		/* 高分辨率模式下，每次测量间隔至少 120ms */
+        delay_ms(1000);  // 请替换为您的延时函数
 	}
 }	
 
@@ -35,8 +35,8 @@ void exp_continuous_measure_ex()
 		{
 			printf("continuous ex Light = %.2f lux\r\n", lux);
 		}
-		/* ߷ֱģʽ£ÿβ 120ms */
-        delay_ms(1000);  // 滻Ϊʱ
+		/* 高分辨率模式下，每次测量间隔至少 120ms */
+        delay_ms(1000);  // 请替换为您的延时函数
 	}
 }	
 
@@ -49,8 +49,8 @@ void exp_single_measure()
 		{
 			printf("single Light = %.2f lux\r\n", lux);
 		}
-		/* ߷ֱģʽ£ÿβ 120ms */
-        delay_ms(1000);  // 滻Ϊʱ
+		/* 高分辨率模式下，每次测量间隔至少 120ms */
+        delay_ms(1000);  // 请替换为您的延时函数
 	}
 }	
  
@@ -63,8 +63,8 @@ void exp_single_measure_ex()
 		{
 			printf("single ex Light = %.2f lux\r\n", lux);
 		}
-		/* ߷ֱģʽ£ÿβ 120ms */
-        delay_ms(1000);  // 滻Ϊʱ
+		/* 高分辨率模式下，每次测量间隔至少 120ms */
+        delay_ms(1000);  // 请替换为您的延时函数
 	}
 }	
 
@@ -72,15 +72,15 @@ int main()
 {
 	NVIC_PriorityGroupConfig(NVIC_PriorityGroup_4);
  
-	//ʼ
+	//常用外设初始化
 	bsp_usart1_init(115200);
 	delay_init();
 	printf("\r\nBH1750 Measure Example\r\n");
 	soft_i2c_init(SOFT_I2C1);
 		
-	exp_continuous_measure(); //
-	//exp_single_measure(); // β
-	//exp_continuous_measure_ex(); // ޸
+	exp_continuous_measure(); //连续测量
+	//exp_single_measure(); // 单次测量
+	//exp_continuous_measure_ex(); // 修改灵敏度
 	//exp_single_measure_ex();
 	while(1)
 	{ 
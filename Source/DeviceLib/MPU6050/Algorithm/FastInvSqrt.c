@@ -0,0 +1,54 @@
+#include "FastInvSqrt.h"
+
+/**
+  * @brief   快速倒数平方根（浮点）
+  * @note    通过联合体读取浮点数的位模式，不违反严格别名规则，
+  *          并且固定使用32位整数，在long为64位的主机上结果同样正确
+  *          See: http://en.wikipedia.org/wiki/Fast_inverse_square_root
+  * @param   x 大于0
+  * @retval  1/sqrt(x)
+ **/
+float invSqrt(float x)
+{
+	union {
+		float f;
+		uint32_t i;
+	} u;
+	float halfx = 0.5f * x;
+	u.f = x;
+	u.i = 0x5f3759df - (u.i >> 1);
+	u.f = u.f * (1.5f - (halfx * u.f * u.f));
+#if INV_SQRT_NEWTON_STEPS > 1
+	u.f = u.f * (1.5f - (halfx * u.f * u.f));
+#endif
+	return u.f;
+}
+
+/* 1/sqrt(m) 的初值表，m∈[1,2) 和 [2,4) 各分8段，取每段中点的值（Q30） */
+static const uint32_t rsqrt_tab[16] = {
+	1041682578, 985333074, 937238702, 895562589, 858993459, 826566842, 797555404, 771398898,
+	 736580814, 696735698, 662727842, 633258380, 607400100, 584471019, 563956835, 545461392,
+};
+
+/**
+  * @brief   定点倒数平方根
+  * @note    查表得到误差约3%的初值，再做两次牛顿迭代 y = y*(3 - m*y*y)/2，相对误差约3e-6
+  * @param   m Q30格式，范围 [2^30, 2^32)，即实际值 [1,4)
+  * @retval  1/sqrt(m)，Q30格式，范围 (0.5,1]
+ **/
+q30_t q30_rsqrt(uint32_t m)
+{
+	uint32_t y, t;
+	int i;
+	if(m < 0x80000000u)
+		y = rsqrt_tab[(m >> 27) & 7];
+	else
+		y = rsqrt_tab[8 + ((m >> 28) & 7)];
+	for(i = 0; i < 2; i++)
+	{
+		t = (uint32_t)(((uint64_t)y * y) >> 30);
+		t = (uint32_t)(((uint64_t)m * t) >> 30);
+		y = (uint32_t)(((uint64_t)y * (0xC0000000u - t)) >> 31);
+	}
+	return (q30_t)y;
+}
@@ -0,0 +1,16 @@
+#ifndef _FAST_INV_SQRT_H
+#define _FAST_INV_SQRT_H
+
+#include <stdint.h>
+#include "FixedPoint.h"
+
+/****************** user port area start ****************/
+#ifndef INV_SQRT_NEWTON_STEPS
+#define INV_SQRT_NEWTON_STEPS   1     //牛顿迭代次数：1 相对误差约1.8e-3，2 约5e-6（多两次浮点乘法）
+#endif
+/****************** user port area end   ****************/
+
+float invSqrt(float x);
+q30_t q30_rsqrt(uint32_t m);
+
+#endif
@@ -0,0 +1,173 @@
+#include "FastTrig.h"
+#include "FastInvSqrt.h"
+#include <math.h>
+
+#if FAST_TRIG_ACCURACY < 2
+/**
+  * @brief   atan(z)，z∈[0,1]
+  * @param   z 
+  * @retval  弧度
+ **/
+static float fast_atan_unit(float z)
+{
+#if FAST_TRIG_ACCURACY == 0
+	return (FAST_TRIG_PI / 4) * z - z * (z - 1) * (0.2447f + 0.0663f * z);
+#else
+	float z2 = z * z;
+	return z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f + z2 * (-0.11643287f + z2 * (0.05265332f - 0.01172120f * z2)))));
+#endif
+}
+#endif
+
+/**
+  * @brief   快速 atan2
+  * @note    按八分圆把比值折算到 [0,1] 后用多项式近似，只有一次浮点除法
+  * @param   y x 
+  * @retval  弧度，范围 [-pi, pi]
+ **/
+float fast_atan2f(float y, float x)
+{
+#if FAST_TRIG_ACCURACY >= 2
+	return atan2f(y, x);
+#else
+	float ax = fabsf(x), ay = fabsf(y), a;
+	if(ax == 0.0f && ay == 0.0f)
+		return 0.0f;
+	if(ay <= ax)
+		a = fast_atan_unit(ay / ax);
+	else
+		a = FAST_TRIG_PI / 2 - fast_atan_unit(ax / ay);
+	if(x < 0.0f)
+		a = FAST_TRIG_PI - a;
+	return y < 0.0f ? -a : a;
+#endif
+}
+
+/**
+  * @brief   快速 asin
+  * @note    asin(x) = pi/2 - sqrt(1-x)*P(x)（Abramowitz & Stegun 4.4.45 / 4.4.46），平方根由 invSqrt 求得
+  * @param   x 超出 [-1,1] 时按边界处理
+  * @retval  弧度，范围 [-pi/2, pi/2]
+ **/
+float fast_asinf(float x)
+{
+#if FAST_TRIG_ACCURACY >= 2
+	if(x >= 1.0f) return FAST_TRIG_PI / 2;
+	if(x <= -1.0f) return -FAST_TRIG_PI / 2;
+	return asinf(x);
+#else
+	float ax = fabsf(x), t, r, p;
+	if(ax >= 1.0f)
+		return x > 0.0f ? FAST_TRIG_PI / 2 : -FAST_TRIG_PI / 2;
+	t = 1.0f - ax;
+	r = invSqrt(t);
+#if FAST_TRIG_ACCURACY == 0
+	p = 1.5707288f + ax * (-0.2121144f + ax * (0.0742610f - 0.0187293f * ax));
+#else
+	r = r * (1.5f - 0.5f * t * r * r);    //多一次牛顿迭代
+	p = 1.5707963050f + ax * (-0.2145988016f + ax * (0.0889789874f + ax * (-0.0501743046f + ax * (0.0308918810f
+	  + ax * (-0.0170881256f + ax * (0.0066700901f - 0.0012624911f * ax))))));
+#endif
+	p = FAST_TRIG_PI / 2 - t * r * p;     //t*r = sqrt(t)
+	return x < 0.0f ? -p : p;
+#endif
+}
+
+/**
+  * @brief   四元数换算为欧拉角
+  * @param   q0 q1 q2 q3 单位四元数
+  * @param   angle 输出：横滚、俯仰、偏航（度）
+  * @retval  
+ **/
+void fast_euler(float q0, float q1, float q2, float q3, float *angle)
+{
+	angle[0] = fast_atan2f(2 * (q2 * q3 + q0 * q1), 1 - 2 * (q1 * q1 + q2 * q2)) * FAST_TRIG_RAD2DEG;   // roll
+	angle[1] = fast_asinf(2 * (q0 * q2 - q1 * q3)) * FAST_TRIG_RAD2DEG;                                  // pitch
+	angle[2] = fast_atan2f(2 * (q0 * q3 + q1 * q2), q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3) * FAST_TRIG_RAD2DEG; // yaw
+}
+
+/* ---------------- 定点版本 ---------------- */
+#define Q30_RAD2DEG_Q24   961263669   //180/pi，Q24
+
+/**
+  * @brief   定点 atan2
+  * @note    先把较大的分量移位到 [2^23, 2^24)，比值用4次32位硬件除法逐段求到Q30（长除法，余数带入下一次），
+  *          多项式在Q30下计算，误差由多项式决定，与浮点版本1档相当（见 FAST_TRIG_Q16_ERR_DEG）
+  * @param   y x 任意定标，但必须相同
+  * @retval  角度（度，Q16），范围 [-180, 180]
+ **/
+q16_t fast_atan2_deg_q16(int32_t y, int32_t x)
+{
+	uint32_t ax = x < 0 ? -(uint32_t)x : (uint32_t)x;
+	uint32_t ay = y < 0 ? -(uint32_t)y : (uint32_t)y;
+	uint32_t mx = ax > ay ? ax : ay, mn = ax > ay ? ay : ax;
+	uint32_t rem, q;
+	uint8_t i, sh;
+	int64_t z, z2, p;
+	q16_t a;
+
+	if(mx == 0)
+		return 0;
+	while(mx >= 0x1000000u) { mx >>= 1; mn >>= 1; }
+	while(mx <  0x800000u)  { mx <<= 1; mn <<= 1; }
+
+	//每次左移8位（最后一次6位）后除一次，余数小于mx，左移8位不会溢出
+	rem = mn;
+	q = 0;
+	for(i = 0; i < 4; i++)
+	{
+		sh = i < 3 ? 8 : 6;
+		rem <<= sh;
+		q = (q << sh) | (rem / mx);
+		rem %= mx;
+	}
+	if(rem >= mx - rem)                                           //四舍五入
+		q++;
+
+	z  = (int64_t)q;                                              //Q30
+	z2 = (z * z) >> 30;
+	p  = Q30_FROM_FLOAT(0.05265332f) - ((Q30_FROM_FLOAT(0.01172120f) * z2) >> 30);
+	p  = Q30_FROM_FLOAT(-0.11643287f) + ((p * z2) >> 30);
+	p  = Q30_FROM_FLOAT(0.19354346f) + ((p * z2) >> 30);
+	p  = Q30_FROM_FLOAT(-0.33262347f) + ((p * z2) >> 30);
+	p  = Q30_FROM_FLOAT(0.99997726f) + ((p * z2) >> 30);
+	p  = (p * z) >> 30;                                           //弧度，Q30
+	a  = (q16_t)((p * Q30_RAD2DEG_Q24 + ((int64_t)1 << 37)) >> 38);  //度，Q16
+
+	if(ay > ax)
+		a = Q16_FROM_INT(90) - a;
+	if(x < 0)
+		a = Q16_FROM_INT(180) - a;
+	return y < 0 ? -a : a;
+}
+
+/**
+  * @brief   定点 asin
+  * @note    asin(x) = atan2(x, sqrt(1-x*x))
+  * @param   x Q30，超出 [-1,1] 时按边界处理
+  * @retval  角度（度，Q16）
+ **/
+q16_t fast_asin_deg_q16(q30_t x)
+{
+	int64_t c2;
+	if(x >= Q30_ONE) return Q16_FROM_INT(90);
+	if(x <= -Q30_ONE) return -Q16_FROM_INT(90);
+	c2 = (int64_t)Q30_ONE - (((int64_t)x * x) >> 30);
+	return fast_atan2_deg_q16(x, q30_sqrt((uint32_t)c2));
+}
+
+/**
+  * @brief   Q30四元数换算为欧拉角
+  * @param   q 单位四元数（Q30）
+  * @param   angle 输出：横滚、俯仰、偏航（度，Q16）
+  * @retval  
+ **/
+void fast_euler_q30(const q30_t *q, q16_t *angle)
+{
+	q30_t q0q0 = q30_mul(q[0], q[0]), q1q1 = q30_mul(q[1], q[1]);
+	q30_t q2q2 = q30_mul(q[2], q[2]), q3q3 = q30_mul(q[3], q[3]);
+	//分量可能超过±1，atan2只关心比值，统一除以2
+	angle[0] = fast_atan2_deg_q16(q30_mul(q[2], q[3]) + q30_mul(q[0], q[1]), (Q30_ONE >> 1) - q1q1 - q2q2);
+	angle[1] = fast_asin_deg_q16(2 * (q30_mul(q[0], q[2]) - q30_mul(q[1], q[3])));
+	angle[2] = fast_atan2_deg_q16(q30_mul(q[0], q[3]) + q30_mul(q[1], q[2]), (q0q0 + q1q1 - q2q2 - q3q3) >> 1);
+}
@@ -0,0 +1,42 @@
+#ifndef _FAST_TRIG_H
+#define _FAST_TRIG_H
+
+#include <stdint.h>
+#include "FixedPoint.h"
+
+/****************** user port area start ****************/
+/**
+  * 浮点版本的精度档位
+  * 0: 低阶多项式，atan2 误差约0.09度，asin 约0.16度，最快
+  * 1: 高阶多项式，atan2 误差约1e-4度，asin 约4e-4度（受单精度限制）
+  * 2: 标准库 atan2f/asinf
+  */
+#ifndef FAST_TRIG_ACCURACY
+#define FAST_TRIG_ACCURACY    1
+#endif
+/****************** user port area end   ****************/
+
+/* 定点版本与档位无关，atan2/asin 的误差上限（度） */
+#define FAST_TRIG_Q16_ERR_DEG 2e-4
+
+/**
+  * 精度表：主机扫描得到的最大误差（度）和主机耗时（x86 gcc -O2，只用于比较相对开销），由 Tools/host/trig_check.c 生成
+  *   实现        atan2     asin      atan2 ns/次  asin ns/次
+  *   浮点 0档    8.7e-2    1.6e-1    24.5         7.8
+  *   浮点 1档    1.1e-4    4.2e-4    24.5         9.8
+  *   浮点 2档    1.4e-5    5.2e-6    45.6         7.8
+  *   定点 Q16    1.1e-4    1.7e-4    39.2         47.4
+  */
+
+#define FAST_TRIG_PI          3.14159265358979f
+#define FAST_TRIG_RAD2DEG     57.2957795130823f
+
+float fast_atan2f(float y, float x);
+float fast_asinf(float x);
+void fast_euler(float q0, float q1, float q2, float q3, float *angle);
+
+q16_t fast_atan2_deg_q16(int32_t y, int32_t x);
+q16_t fast_asin_deg_q16(q30_t x);
+void fast_euler_q30(const q30_t *q, q16_t *angle);
+
+#endif
@@ -0,0 +1,73 @@
+#include "FixedPoint.h"
+#include "FastInvSqrt.h"
+
+/**
+  * @brief   求平方和的倒数平方根
+  * @param   sumsq 平方和（任意定标）
+  * @param   shift 输出：分量乘以返回值后需要右移的位数
+  * @retval  Q30尾数，0表示零向量
+ **/
+static q30_t q_rsqrt_sumsq(uint64_t sumsq, int *shift)
+{
+	int k = 0;
+	if(sumsq == 0)
+		return 0;
+	//移位偶数位，把 sumsq 归一化到 [2^30, 2^32)
+	while(sumsq >= ((uint64_t)1 << 32)) { sumsq >>= 2; k += 2; }
+	while(sumsq <  ((uint64_t)1 << 30)) { sumsq <<= 2; k -= 2; }
+	*shift = 15 + k / 2;
+	return q30_rsqrt((uint32_t)sumsq);
+}
+
+/**
+  * @brief   三维向量归一化
+  * @param   out 单位向量，Q30
+  * @param   x y z 输入分量，定标任意但必须相同
+  * @retval  0 成功 1 零向量
+ **/
+uint8_t q30_normalize3(q30_t out[3], int32_t x, int32_t y, int32_t z)
+{
+	int shift;
+	q30_t r = q_rsqrt_sumsq((uint64_t)((int64_t)x * x) + (uint64_t)((int64_t)y * y) + (uint64_t)((int64_t)z * z), &shift);
+	if(r == 0)
+		return 1;
+	out[0] = (q30_t)(((int64_t)x * r) >> shift);
+	out[1] = (q30_t)(((int64_t)y * r) >> shift);
+	out[2] = (q30_t)(((int64_t)z * r) >> shift);
+	return 0;
+}
+
+/**
+  * @brief   四维向量（四元数）原地归一化
+  * @param   v 输入任意定标，输出Q30单位向量；分量绝对值不超过2^31
+  * @retval  0 成功 1 零向量
+ **/
+uint8_t q30_normalize4(int32_t v[4])
+{
+	int shift, i;
+	uint64_t sumsq = 0;
+	q30_t r;
+	for(i = 0; i < 4; i++)
+		sumsq += (uint64_t)((int64_t)v[i] * v[i]) >> 2;   //预先除4，4个2^62相加不会溢出
+	r = q_rsqrt_sumsq(sumsq, &shift);
+	if(r == 0)
+		return 1;
+	shift += 1;                                           //补偿预先除的4
+	for(i = 0; i < 4; i++)
+		v[i] = (int32_t)(((int64_t)v[i] * r) >> shift);
+	return 0;
+}
+
+/**
+  * @brief   定点平方根
+  * @param   v Q30，范围 [0, 4)
+  * @retval  sqrt(v)，Q30
+ **/
+q30_t q30_sqrt(uint32_t v)
+{
+	int shift;
+	q30_t r = q_rsqrt_sumsq((uint64_t)v << 30, &shift);   //v * 2^30 即Q60表示，其平方根为Q30
+	if(r == 0)
+		return 0;
+	return (q30_t)(((int64_t)v * r) >> shift);
+}
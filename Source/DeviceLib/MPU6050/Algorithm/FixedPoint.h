@@ -0,0 +1,55 @@
+#ifndef _FIXED_POINT_H
+#define _FIXED_POINT_H
+
+#include <stdint.h>
+
+/*
+ * 定点数格式
+ * Q16: Q16.16，用于角速度(rad/s)、加速度(m/s2)、角度等，范围 ±32768，分辨率 1.5e-5
+ * Q30: Q2.30，用于四元数等模长不超过1的量，与DMP输出的四元数格式相同
+ * Cortex-M3 没有FPU，但有单周期的32位乘法和 SMULL(32x32->64)，定点运算比软件浮点快得多
+ */
+typedef int32_t q16_t;
+typedef int32_t q30_t;
+
+#define Q16_ONE              ((q16_t)0x00010000)
+#define Q30_ONE              ((q30_t)0x40000000)
+
+#define Q16_FROM_INT(x)      ((q16_t)((int32_t)(x) << 16))
+#define Q16_FROM_FLOAT(x)    ((q16_t)((x) * 65536.0f + ((x) >= 0 ? 0.5f : -0.5f)))      //常量用，编译期求值
+#define Q30_FROM_FLOAT(x)    ((q30_t)((x) * 1073741824.0f + ((x) >= 0 ? 0.5f : -0.5f)))
+
+/* 微秒换算为秒（Q30），用于采样间隔，2^50/10^6 = 1125899906.8，范围 0~2s */
+#define Q30_FROM_US(us)      ((q30_t)(((uint64_t)(us) * 1125899907u) >> 20))
+
+static __inline float q16_to_float(q16_t x) { return (float)x * (1.0f / 65536.0f); }
+static __inline float q30_to_float(q30_t x) { return (float)x * (1.0f / 1073741824.0f); }
+static __inline q16_t q16_from_float(float x) { return Q16_FROM_FLOAT(x); }
+static __inline q30_t q30_from_float(float x) { return Q30_FROM_FLOAT(x); }
+
+/* 乘法：64位中间结果，四舍五入 */
+static __inline q16_t q16_mul(q16_t a, q16_t b) { return (q16_t)(((int64_t)a * b + (1 << 15)) >> 16); }
+static __inline q30_t q30_mul(q30_t a, q30_t b) { return (q30_t)(((int64_t)a * b + (1 << 29)) >> 30); }
+
+/* Q30 与 Q16 相乘，结果为 Q16（例如四元数乘角速度） */
+static __inline q16_t q30_mul_q16(q30_t a, q16_t b) { return (q16_t)(((int64_t)a * b + (1 << 29)) >> 30); }
+
+static __inline q16_t q16_div(q16_t a, q16_t b) { return (q16_t)(((int64_t)a << 16) / b); }
+
+static __inline q16_t q30_to_q16(q30_t x) { return (x + (1 << 13)) >> 14; }
+static __inline q30_t q16_to_q30(q16_t x) { return x << 14; }   //调用者保证 |x| < 2
+
+/*
+ * 原始值乘常数再右移：raw * mul >> shift，结果四舍五入
+ * |raw| <= 32768、mul < 65536 时32位乘法不会溢出，不需要64位运算
+ */
+#define Q_SCALE(raw, mul, shift)  ((q16_t)(((int32_t)(raw) * (int32_t)(mul) + (1 << ((shift) - 1))) >> (shift)))
+
+/* 两个Q30相乘得到Q25（范围±64），用于中间结果可能超过±2的场合 */
+#define Q25_MUL(a, b)  ((int32_t)(((int64_t)(a) * (b)) >> 35))
+
+uint8_t q30_normalize3(q30_t out[3], int32_t x, int32_t y, int32_t z);
+uint8_t q30_normalize4(int32_t v[4]);
+q30_t q30_sqrt(uint32_t v);
+
+#endif
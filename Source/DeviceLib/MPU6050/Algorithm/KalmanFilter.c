@@ -12,6 +12,24 @@ Kalman_t KalmanY = {
     .R_measure = 0.03f,
 };
 
+Kalmanf_t KalmanfX = {
+    .Q_angle = 0.001f,
+    .Q_bias = 0.003f,
+    .R_measure = 0.03f
+};
+
+Kalmanf_t KalmanfY = {
+    .Q_angle = 0.001f,
+    .Q_bias = 0.003f,
+    .R_measure = 0.03f
+};
+
+Kalman2f_t KalmanXY = {
+    .Q_angle = 0.001f,
+    .Q_bias = 0.003f,
+    .R_measure = 0.03f
+};
+
 double Kalman_getAngle(Kalman_t *Kalman, double newAngle, double newRate, double dt)
 {
     double rate = newRate - Kalman->bias;
@@ -42,3 +60,130 @@ double Kalman_getAngle(Kalman_t *Kalman, double newAngle, double newRate, double
     return Kalman->angle;
 };
 
+float Kalmanf_getAngle(Kalmanf_t *Kalman, float newAngle, float newRate, float dt)
+{
+    float rate = newRate - Kalman->bias;
+    float dtP11 = dt * Kalman->P[1][1];
+    float S, K0, K1, y, P00_temp, P01_temp;
+
+    Kalman->angle += dt * rate;
+
+    Kalman->P[0][0] += dt * (dtP11 - Kalman->P[0][1] - Kalman->P[1][0] + Kalman->Q_angle);
+    Kalman->P[0][1] -= dtP11;
+    Kalman->P[1][0] -= dtP11;
+    Kalman->P[1][1] += Kalman->Q_bias * dt;
+
+    //一次除法，两个增益都乘倒数
+    S = 1.0f / (Kalman->P[0][0] + Kalman->R_measure);
+    K0 = Kalman->P[0][0] * S;
+    K1 = Kalman->P[1][0] * S;
+
+    y = newAngle - Kalman->angle;
+    Kalman->angle += K0 * y;
+    Kalman->bias  += K1 * y;
+
+    P00_temp = Kalman->P[0][0];
+    P01_temp = Kalman->P[0][1];
+
+    Kalman->P[0][0] -= K0 * P00_temp;
+    Kalman->P[0][1] -= K0 * P01_temp;
+    Kalman->P[1][0] -= K1 * P00_temp;
+    Kalman->P[1][1] -= K1 * P01_temp;
+
+    return Kalman->angle;
+}
+
+/**
+  * @brief   双轴卡尔曼滤波，协方差和增益两轴共用
+  * @param   newAngle 加速度计算得的角度[2]   newRate 角速度[2]   dt 采样间隔(s)
+  * @retval  void，结果在 Kalman->angle[0..1]
+ **/
+void Kalman2f_update(Kalman2f_t *Kalman, const float *newAngle, const float *newRate, float dt)
+{
+    float dtP11 = dt * Kalman->P[1][1];
+    float S, K0, K1, y, P00_temp, P01_temp;
+    int i;
+
+    Kalman->P[0][0] += dt * (dtP11 - Kalman->P[0][1] - Kalman->P[1][0] + Kalman->Q_angle);
+    Kalman->P[0][1] -= dtP11;
+    Kalman->P[1][0] -= dtP11;
+    Kalman->P[1][1] += Kalman->Q_bias * dt;
+
+    S = 1.0f / (Kalman->P[0][0] + Kalman->R_measure);
+    K0 = Kalman->P[0][0] * S;
+    K1 = Kalman->P[1][0] * S;
+
+    for(i = 0; i < 2; i++)
+    {
+        Kalman->angle[i] += dt * (newRate[i] - Kalman->bias[i]);
+        y = newAngle[i] - Kalman->angle[i];
+        Kalman->angle[i] += K0 * y;
+        Kalman->bias[i]  += K1 * y;
+    }
+
+    P00_temp = Kalman->P[0][0];
+    P01_temp = Kalman->P[0][1];
+
+    Kalman->P[0][0] -= K0 * P00_temp;
+    Kalman->P[0][1] -= K0 * P01_temp;
+    Kalman->P[1][0] -= K1 * P00_temp;
+    Kalman->P[1][1] -= K1 * P01_temp;
+}
+
+#define Q28_FROM_FLOAT(x)   ((int32_t)((x) * 268435456.0f + 0.5f))
+#define Q28_MUL_Q30(a, b)   ((int32_t)(((int64_t)(a) * (b)) >> 30))   //Q28 * Q30 -> Q28
+
+void Kalmanq_init(Kalmanq_t *Kalman, float Q_angle, float Q_bias, float R_measure)
+{
+    Kalman->Q_angle = Q28_FROM_FLOAT(Q_angle);
+    Kalman->Q_bias = Q28_FROM_FLOAT(Q_bias);
+    Kalman->R_measure = Q28_FROM_FLOAT(R_measure);
+    Kalman->angle = 0;
+    Kalman->bias = 0;
+    Kalman->P[0][0] = 0;
+    Kalman->P[0][1] = 0;
+    Kalman->P[1][0] = 0;
+    Kalman->P[1][1] = 0;
+}
+
+/**
+  * @brief   定点卡尔曼滤波
+  * @param   newAngle 加速度计算得的角度（度，Q16）   newRate 角速度（度/s，Q16）   dt 采样间隔（s，Q30）
+  * @retval  滤波后的角度（度，Q16）
+ **/
+q16_t Kalmanq_getAngle(Kalmanq_t *Kalman, q16_t newAngle, q16_t newRate, q30_t dt)
+{
+    q16_t rate = newRate - Kalman->bias;
+    int32_t dtP11 = Q28_MUL_Q30(Kalman->P[1][1], dt);
+    int32_t S, P00_temp, P01_temp;
+    q30_t K0, K1;
+    int32_t invS;
+    q16_t y;
+
+    Kalman->angle += (q16_t)(((int64_t)rate * dt) >> 30);
+
+    Kalman->P[0][0] += Q28_MUL_Q30(dtP11 - Kalman->P[0][1] - Kalman->P[1][0] + Kalman->Q_angle, dt);
+    Kalman->P[0][1] -= dtP11;
+    Kalman->P[1][0] -= dtP11;
+    Kalman->P[1][1] += Q28_MUL_Q30(Kalman->Q_bias, dt);
+
+    //一次除法：1/S 为Q24（S 不小于 R_measure，1/S 不超过 1/R_measure）
+    S = Kalman->P[0][0] + Kalman->R_measure;
+    invS = (int32_t)(((int64_t)1 << 52) / S);
+    K0 = (q30_t)(((int64_t)Kalman->P[0][0] * invS) >> 22);
+    K1 = (q30_t)(((int64_t)Kalman->P[1][0] * invS) >> 22);
+
+    y = newAngle - Kalman->angle;
+    Kalman->angle += (q16_t)(((int64_t)K0 * y) >> 30);
+    Kalman->bias  += (q16_t)(((int64_t)K1 * y) >> 30);
+
+    P00_temp = Kalman->P[0][0];
+    P01_temp = Kalman->P[0][1];
+
+    Kalman->P[0][0] -= Q28_MUL_Q30(P00_temp, K0);
+    Kalman->P[0][1] -= Q28_MUL_Q30(P01_temp, K0);
+    Kalman->P[1][0] -= Q28_MUL_Q30(P00_temp, K1);
+    Kalman->P[1][1] -= Q28_MUL_Q30(P01_temp, K1);
+
+    return Kalman->angle;
+}
@@ -2,6 +2,7 @@
 #define _KALMAN_FILTER_H
 
 #include "main.h"
+#include "FixedPoint.h"
 
 typedef struct {
     double Q_angle;
@@ -12,8 +13,47 @@ typedef struct {
     double P[2][2];
 } Kalman_t;
 
+/* 单精度版本：Cortex-M3 上 double 运算比 float 更慢 */
+typedef struct {
+    float Q_angle;
+    float Q_bias;
+    float R_measure;
+    float angle;
+    float bias;
+    float P[2][2];
+} Kalmanf_t;
+
+/**
+  * 横滚+俯仰双轴版本：两轴噪声参数相同时，协方差P和增益K的递推与测量值无关，
+  * 两轴完全相同，只需计算一次
+  */
+typedef struct {
+    float Q_angle;
+    float Q_bias;
+    float R_measure;
+    float angle[2];
+    float bias[2];
+    float P[2][2];
+} Kalman2f_t;
+
+/* 定点版本：角度、角速度为Q16（度、度/s），噪声参数和协方差为Q28（范围±8），R_measure 取值 0.01~4 */
+typedef struct {
+    int32_t Q_angle;
+    int32_t Q_bias;
+    int32_t R_measure;
+    q16_t angle;
+    q16_t bias;
+    int32_t P[2][2];
+} Kalmanq_t;
+
 extern Kalman_t KalmanX,KalmanY;
+extern Kalmanf_t KalmanfX,KalmanfY;
+extern Kalman2f_t KalmanXY;
+
 double Kalman_getAngle(Kalman_t *Kalman, double newAngle, double newRate, double dt);
- 
-#endif
+float Kalmanf_getAngle(Kalmanf_t *Kalman, float newAngle, float newRate, float dt);
+void Kalman2f_update(Kalman2f_t *Kalman, const float *newAngle, const float *newRate, float dt);
+void Kalmanq_init(Kalmanq_t *Kalman, float Q_angle, float Q_bias, float R_measure);
+q16_t Kalmanq_getAngle(Kalmanq_t *Kalman, q16_t newAngle, q16_t newRate, q30_t dt);
 
+#endif
@@ -1,10 +1,40 @@
-#ifndef MadgwickAHRS_h
-#define MadgwickAHRS_h
-
-#include "main.h"
-
-void MadgwickAHRSupdate(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz, float* IMU_Angle);
-void MadgwickAHRSupdateIMU(float gx, float gy, float gz, float ax, float ay, float az, float* IMU_Angle);
-
-#endif
-
+#ifndef MadgwickAHRS_h
+#define MadgwickAHRS_h
+
+#include "main.h"
+#include "FixedPoint.h"
+#include "Quaternion.h"
+
+/* 滤波器实例，每个IMU一份，可以同时运行多个 */
+typedef struct {
+	float beta;                         // 2 * proportional gain (Kp)
+	float q0, q1, q2, q3;               // quaternion of sensor frame relative to auxiliary frame
+	quat_cache_t cache;                 // derived outputs, computed on demand
+} madgwick_t;
+
+/* 定点实例：角速度、加速度为Q16，四元数为Q30 */
+typedef struct {
+	q30_t beta;
+	q30_t q[4];
+	quat_cache_q30_t cache;
+} madgwick_fixed_t;
+
+/* 定点内核相对浮点内核的欧拉角误差上限（度），由 Tools/host/ahrs_check.c 校验
+   （1kHz合成IMU序列，默认beta 实测最大约0.003度） */
+#define MADGWICK_FIXED_ERR_DEG   0.01
+
+void madgwick_init(madgwick_t *m, float beta);
+void madgwick_update(madgwick_t *m, float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz, float dt);
+void madgwick_update_imu(madgwick_t *m, float gx, float gy, float gz, float ax, float ay, float az, float dt);
+void madgwick_get_quat(const madgwick_t *m, float *q);
+void madgwick_get_angle(madgwick_t *m, float *angle);
+void madgwick_get_dcm(madgwick_t *m, float dcm[3][3]);
+void madgwick_get_gravity(madgwick_t *m, float *g);
+
+void madgwick_fixed_init(madgwick_fixed_t *m, float beta);
+void madgwick_update_imu_fixed(madgwick_fixed_t *m, q16_t gx, q16_t gy, q16_t gz, q16_t ax, q16_t ay, q16_t az, q30_t dt);
+void madgwick_fixed_get_angle(madgwick_fixed_t *m, q16_t *angle);
+void madgwick_fixed_get_dcm(madgwick_fixed_t *m, q30_t dcm[3][3]);
+void madgwick_fixed_get_gravity(madgwick_fixed_t *m, q30_t *g);
+
+#endif
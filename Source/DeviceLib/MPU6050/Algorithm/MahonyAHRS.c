@@ -1,209 +1,342 @@
-#include "MahonyAHRS.h"
-#include <math.h>
-
-#define sampleFreq	100.0f			// sample frequency in Hz
-#define twoKpDef	(2.0f * 2.5f)	// 2 * proportional gain
-#define twoKiDef	(2.0f * 0.0f)	// 2 * integral gain
-
-static volatile float twoKp = twoKpDef;											    // 2 * proportional gain (Kp)
-static volatile float twoKi = twoKiDef;											    // 2 * integral gain (Ki)
-static volatile float q0 = 1.0f, q1 = 0.0f, q2 = 0.0f, q3 = 0.0f;					// quaternion of sensor frame relative to auxiliary frame
-static volatile float integralFBx = 0.0f,  integralFBy = 0.0f, integralFBz = 0.0f;	// integral error terms scaled by Ki
-
-static float invSqrt(float x);
-
-void MahonyAHRSupdate(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz, float* IMU_Angle) {
-	float recipNorm;
-    float q0q0, q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3;  
-	float hx, hy, bx, bz;
-	float halfvx, halfvy, halfvz, halfwx, halfwy, halfwz;
-	float halfex, halfey, halfez;
-	float qa, qb, qc;
-
-	// Use IMU algorithm if magnetometer measurement invalid (avoids NaN in magnetometer normalisation)
-	if((mx == 0.0f) && (my == 0.0f) && (mz == 0.0f)) {
-		MahonyAHRSupdateIMU(gx, gy, gz, ax, ay, az, IMU_Angle);
-		return;
-	}
-
-	// Compute feedback only if accelerometer measurement valid (avoids NaN in accelerometer normalisation)
-	if(!((ax == 0.0f) && (ay == 0.0f) && (az == 0.0f))) {
-
-		// Normalise accelerometer measurement
-		recipNorm = invSqrt(ax * ax + ay * ay + az * az);
-		ax *= recipNorm;
-		ay *= recipNorm;
-		az *= recipNorm;     
-
-		// Normalise magnetometer measurement
-		recipNorm = invSqrt(mx * mx + my * my + mz * mz);
-		mx *= recipNorm;
-		my *= recipNorm;
-		mz *= recipNorm;   
-
-        // Auxiliary variables to avoid repeated arithmetic
-        q0q0 = q0 * q0;
-        q0q1 = q0 * q1;
-        q0q2 = q0 * q2;
-        q0q3 = q0 * q3;
-        q1q1 = q1 * q1;
-        q1q2 = q1 * q2;
-        q1q3 = q1 * q3;
-        q2q2 = q2 * q2;
-        q2q3 = q2 * q3;
-        q3q3 = q3 * q3;   
-
-        // Reference direction of Earth's magnetic field
-        hx = 2.0f * (mx * (0.5f - q2q2 - q3q3) + my * (q1q2 - q0q3) + mz * (q1q3 + q0q2));
-        hy = 2.0f * (mx * (q1q2 + q0q3) + my * (0.5f - q1q1 - q3q3) + mz * (q2q3 - q0q1));
-        bx = sqrt(hx * hx + hy * hy);
-        bz = 2.0f * (mx * (q1q3 - q0q2) + my * (q2q3 + q0q1) + mz * (0.5f - q1q1 - q2q2));
-
-		// Estimated direction of gravity and magnetic field
-		halfvx = q1q3 - q0q2;
-		halfvy = q0q1 + q2q3;
-		halfvz = q0q0 - 0.5f + q3q3;
-        halfwx = bx * (0.5f - q2q2 - q3q3) + bz * (q1q3 - q0q2);
-        halfwy = bx * (q1q2 - q0q3) + bz * (q0q1 + q2q3);
-        halfwz = bx * (q0q2 + q1q3) + bz * (0.5f - q1q1 - q2q2);  
-	
-		// Error is sum of cross product between estimated direction and measured direction of field vectors
-		halfex = (ay * halfvz - az * halfvy) + (my * halfwz - mz * halfwy);
-		halfey = (az * halfvx - ax * halfvz) + (mz * halfwx - mx * halfwz);
-		halfez = (ax * halfvy - ay * halfvx) + (mx * halfwy - my * halfwx);
-
-		// Compute and apply integral feedback if enabled
-		if(twoKi > 0.0f) {
-			integralFBx += twoKi * halfex * (1.0f / sampleFreq);	// integral error scaled by Ki
-			integralFBy += twoKi * halfey * (1.0f / sampleFreq);
-			integralFBz += twoKi * halfez * (1.0f / sampleFreq);
-			gx += integralFBx;	// apply integral feedback
-			gy += integralFBy;
-			gz += integralFBz;
-		}
-		else {
-			integralFBx = 0.0f;	// prevent integral windup
-			integralFBy = 0.0f;
-			integralFBz = 0.0f;
-		}
-
-		// Apply proportional feedback
-		gx += twoKp * halfex;
-		gy += twoKp * halfey;
-		gz += twoKp * halfez;
-	}
-	
-	// Integrate rate of change of quaternion
-	gx *= (0.5f * (1.0f / sampleFreq));		// pre-multiply common factors
-	gy *= (0.5f * (1.0f / sampleFreq));
-	gz *= (0.5f * (1.0f / sampleFreq));
-	qa = q0;
-	qb = q1;
-	qc = q2;
-	q0 += (-qb * gx - qc * gy - q3 * gz);
-	q1 += (qa * gx + qc * gz - q3 * gy);
-	q2 += (qa * gy - qb * gz + q3 * gx);
-	q3 += (qa * gz + qb * gy - qc * gx); 
-	
-	// Normalise quaternion
-	recipNorm = invSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
-	q0 *= recipNorm;
-	q1 *= recipNorm;
-	q2 *= recipNorm;
-	q3 *= recipNorm;
-	
-	IMU_Angle[0] = atan2(2 * q2 * q3 + 2 * q0 * q1, -2 * q1 * q1 - 2 * q2 * q2 + 1) * 57.3; // roll
-	IMU_Angle[1] = asin(-2 * q1 * q3 + 2 * q0 * q2) * 57.3; // pitch
-    IMU_Angle[2] = atan2(2 * (q0 * q3 + q1 * q2), q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3) * 57.3; // yaw
-}
-
-//---------------------------------------------------------------------------------------------------
-// IMU algorithm update
-
-void MahonyAHRSupdateIMU(float gx, float gy, float gz, float ax, float ay, float az, float* IMU_Angle) {
-	float recipNorm;
-	float halfvx, halfvy, halfvz;
-	float halfex, halfey, halfez;
-	float qa, qb, qc;
-
-	// Compute feedback only if accelerometer measurement valid (avoids NaN in accelerometer normalisation)
-	if(!((ax == 0.0f) && (ay == 0.0f) && (az == 0.0f))) {
-
-		// Normalise accelerometer measurement
-		recipNorm = invSqrt(ax * ax + ay * ay + az * az);
-		ax *= recipNorm;
-		ay *= recipNorm;
-		az *= recipNorm;        
-
-		// Estimated direction of gravity and vector perpendicular to magnetic flux
-		halfvx = q1 * q3 - q0 * q2;
-		halfvy = q0 * q1 + q2 * q3;
-		halfvz = q0 * q0 - 0.5f + q3 * q3;
-	
-		// Error is sum of cross product between estimated and measured direction of gravity
-		halfex = (ay * halfvz - az * halfvy);
-		halfey = (az * halfvx - ax * halfvz);
-		halfez = (ax * halfvy - ay * halfvx);
-
-		// Compute and apply integral feedback if enabled
-		if(twoKi > 0.0f) {
-			integralFBx += twoKi * halfex * (1.0f / sampleFreq);	// integral error scaled by Ki
-			integralFBy += twoKi * halfey * (1.0f / sampleFreq);
-			integralFBz += twoKi * halfez * (1.0f / sampleFreq);
-			gx += integralFBx;	// apply integral feedback
-			gy += integralFBy;
-			gz += integralFBz;
-		}
-		else {
-			integralFBx = 0.0f;	// prevent integral windup
-			integralFBy = 0.0f;
-			integralFBz = 0.0f;
-		}
-
-		// Apply proportional feedback
-		gx += twoKp * halfex;
-		gy += twoKp * halfey;
-		gz += twoKp * halfez;
-	}
-	
-	// Integrate rate of change of quaternion
-	gx *= (0.5f * (1.0f / sampleFreq));		// pre-multiply common factors
-	gy *= (0.5f * (1.0f / sampleFreq));
-	gz *= (0.5f * (1.0f / sampleFreq));
-	qa = q0;
-	qb = q1;
-	qc = q2;
-	q0 += (-qb * gx - qc * gy - q3 * gz);
-	q1 += (qa * gx + qc * gz - q3 * gy);
-	q2 += (qa * gy - qb * gz + q3 * gx);
-	q3 += (qa * gz + qb * gy - qc * gx); 
-	
-	// Normalise quaternion
-	recipNorm = invSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
-	q0 *= recipNorm;
-	q1 *= recipNorm;
-	q2 *= recipNorm;
-	q3 *= recipNorm;
-	
-	IMU_Angle[0] = atan2(2 * q2 * q3 + 2 * q0 * q1, -2 * q1 * q1 - 2 * q2 * q2 + 1) * 57.3; // roll
-	IMU_Angle[1] = asin(-2 * q1 * q3 + 2 * q0 * q2) * 57.3; // pitch
-    IMU_Angle[2] = atan2(2 * (q0 * q3 + q1 * q2), q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3) * 57.3; // yaw
-}
-
-//---------------------------------------------------------------------------------------------------
-// Fast inverse square-root
-// See: http://en.wikipedia.org/wiki/Fast_inverse_square_root
-
-static float invSqrt(float x) {
-	float halfx = 0.5f * x;
-	float y = x;
-	long i = *(long*)&y;
-	i = 0x5f3759df - (i>>1);
-	y = *(float*)&i;
-	y = y * (1.5f - (halfx * y * y));
-	return y;
-}
-
-//====================================================================================================
-// END OF CODE
-//====================================================================================================
+#include "MahonyAHRS.h"
+#include <math.h>
+#include "FastInvSqrt.h"
+#include <string.h>
+
+#define twoKpDef	(2.0f * 2.5f)	// 2 * proportional gain
+#define twoKiDef	(2.0f * 0.0f)	// 2 * integral gain
+
+//---------------------------------------------------------------------------------------------------
+// Initialisation
+// kp/ki <= 0 select the default gains
+
+void mahony_init(mahony_t *m, float kp, float ki) {
+	m->twoKp = kp > 0.0f ? 2.0f * kp : twoKpDef;
+	m->twoKi = ki > 0.0f ? 2.0f * ki : twoKiDef;
+	m->q0 = 1.0f;
+	m->q1 = 0.0f;
+	m->q2 = 0.0f;
+	m->q3 = 0.0f;
+	quat_cache_invalidate(&m->cache);
+	m->integralFBx = 0.0f;
+	m->integralFBy = 0.0f;
+	m->integralFBz = 0.0f;
+}
+
+void mahony_update(mahony_t *m, float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz, float dt) {
+	float q0 = m->q0, q1 = m->q1, q2 = m->q2, q3 = m->q3;		// working copy, kept in registers
+	float twoKi = m->twoKi;
+	float recipNorm;
+    float q0q0, q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3;  
+	float hx, hy, bx, bz;
+	float halfvx, halfvy, halfvz, halfwx, halfwy, halfwz;
+	float halfex, halfey, halfez;
+	float qa, qb, qc;
+
+	// Use IMU algorithm if magnetometer measurement invalid (avoids NaN in magnetometer normalisation)
+	if((mx == 0.0f) && (my == 0.0f) && (mz == 0.0f)) {
+		mahony_update_imu(m, gx, gy, gz, ax, ay, az, dt);
+		return;
+	}
+
+	// Compute feedback only if accelerometer measurement valid (avoids NaN in accelerometer normalisation)
+	if(!((ax == 0.0f) && (ay == 0.0f) && (az == 0.0f))) {
+
+		// Normalise accelerometer measurement
+		recipNorm = invSqrt(ax * ax + ay * ay + az * az);
+		ax *= recipNorm;
+		ay *= recipNorm;
+		az *= recipNorm;     
+
+		// Normalise magnetometer measurement
+		recipNorm = invSqrt(mx * mx + my * my + mz * mz);
+		mx *= recipNorm;
+		my *= recipNorm;
+		mz *= recipNorm;   
+
+        // Auxiliary variables to avoid repeated arithmetic
+        q0q0 = q0 * q0;
+        q0q1 = q0 * q1;
+        q0q2 = q0 * q2;
+        q0q3 = q0 * q3;
+        q1q1 = q1 * q1;
+        q1q2 = q1 * q2;
+        q1q3 = q1 * q3;
+        q2q2 = q2 * q2;
+        q2q3 = q2 * q3;
+        q3q3 = q3 * q3;   
+
+        // Reference direction of Earth's magnetic field
+        hx = 2.0f * (mx * (0.5f - q2q2 - q3q3) + my * (q1q2 - q0q3) + mz * (q1q3 + q0q2));
+        hy = 2.0f * (mx * (q1q2 + q0q3) + my * (0.5f - q1q1 - q3q3) + mz * (q2q3 - q0q1));
+        bx = sqrt(hx * hx + hy * hy);
+        bz = 2.0f * (mx * (q1q3 - q0q2) + my * (q2q3 + q0q1) + mz * (0.5f - q1q1 - q2q2));
+
+		// Estimated direction of gravity and magnetic field
+		halfvx = q1q3 - q0q2;
+		halfvy = q0q1 + q2q3;
+		halfvz = q0q0 - 0.5f + q3q3;
+        halfwx = bx * (0.5f - q2q2 - q3q3) + bz * (q1q3 - q0q2);
+        halfwy = bx * (q1q2 - q0q3) + bz * (q0q1 + q2q3);
+        halfwz = bx * (q0q2 + q1q3) + bz * (0.5f - q1q1 - q2q2);  
+	
+		// Error is sum of cross product between estimated direction and measured direction of field vectors
+		halfex = (ay * halfvz - az * halfvy) + (my * halfwz - mz * halfwy);
+		halfey = (az * halfvx - ax * halfvz) + (mz * halfwx - mx * halfwz);
+		halfez = (ax * halfvy - ay * halfvx) + (mx * halfwy - my * halfwx);
+
+		// Compute and apply integral feedback if enabled
+		if(twoKi > 0.0f) {
+			m->integralFBx += twoKi * halfex * dt;	// integral error scaled by Ki
+			m->integralFBy += twoKi * halfey * dt;
+			m->integralFBz += twoKi * halfez * dt;
+			gx += m->integralFBx;	// apply integral feedback
+			gy += m->integralFBy;
+			gz += m->integralFBz;
+		}
+		else {
+			m->integralFBx = 0.0f;	// prevent integral windup
+			m->integralFBy = 0.0f;
+			m->integralFBz = 0.0f;
+		}
+
+		// Apply proportional feedback
+		gx += m->twoKp * halfex;
+		gy += m->twoKp * halfey;
+		gz += m->twoKp * halfez;
+	}
+	
+	// Integrate rate of change of quaternion
+	gx *= (0.5f * dt);		// pre-multiply common factors
+	gy *= (0.5f * dt);
+	gz *= (0.5f * dt);
+	qa = q0;
+	qb = q1;
+	qc = q2;
+	q0 += (-qb * gx - qc * gy - q3 * gz);
+	q1 += (qa * gx + qc * gz - q3 * gy);
+	q2 += (qa * gy - qb * gz + q3 * gx);
+	q3 += (qa * gz + qb * gy - qc * gx); 
+	
+	// Normalise quaternion
+	recipNorm = invSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+	q0 *= recipNorm;
+	q1 *= recipNorm;
+	q2 *= recipNorm;
+	q3 *= recipNorm;
+
+	m->q0 = q0;
+	m->q1 = q1;
+	m->q2 = q2;
+	m->q3 = q3;
+	quat_cache_invalidate(&m->cache);
+}
+
+//---------------------------------------------------------------------------------------------------
+// IMU algorithm update
+
+void mahony_update_imu(mahony_t *m, float gx, float gy, float gz, float ax, float ay, float az, float dt) {
+	float q0 = m->q0, q1 = m->q1, q2 = m->q2, q3 = m->q3;		// working copy, kept in registers
+	float twoKi = m->twoKi;
+	float recipNorm;
+	float halfvx, halfvy, halfvz;
+	float halfex, halfey, halfez;
+	float qa, qb, qc;
+
+	// Compute feedback only if accelerometer measurement valid (avoids NaN in accelerometer normalisation)
+	if(!((ax == 0.0f) && (ay == 0.0f) && (az == 0.0f))) {
+
+		// Normalise accelerometer measurement
+		recipNorm = invSqrt(ax * ax + ay * ay + az * az);
+		ax *= recipNorm;
+		ay *= recipNorm;
+		az *= recipNorm;        
+
+		// Estimated direction of gravity and vector perpendicular to magnetic flux
+		halfvx = q1 * q3 - q0 * q2;
+		halfvy = q0 * q1 + q2 * q3;
+		halfvz = q0 * q0 - 0.5f + q3 * q3;
+	
+		// Error is sum of cross product between estimated and measured direction of gravity
+		halfex = (ay * halfvz - az * halfvy);
+		halfey = (az * halfvx - ax * halfvz);
+		halfez = (ax * halfvy - ay * halfvx);
+
+		// Compute and apply integral feedback if enabled
+		if(twoKi > 0.0f) {
+			m->integralFBx += twoKi * halfex * dt;	// integral error scaled by Ki
+			m->integralFBy += twoKi * halfey * dt;
+			m->integralFBz += twoKi * halfez * dt;
+			gx += m->integralFBx;	// apply integral feedback
+			gy += m->integralFBy;
+			gz += m->integralFBz;
+		}
+		else {
+			m->integralFBx = 0.0f;	// prevent integral windup
+			m->integralFBy = 0.0f;
+			m->integralFBz = 0.0f;
+		}
+
+		// Apply proportional feedback
+		gx += m->twoKp * halfex;
+		gy += m->twoKp * halfey;
+		gz += m->twoKp * halfez;
+	}
+	
+	// Integrate rate of change of quaternion
+	gx *= (0.5f * dt);		// pre-multiply common factors
+	gy *= (0.5f * dt);
+	gz *= (0.5f * dt);
+	qa = q0;
+	qb = q1;
+	qc = q2;
+	q0 += (-qb * gx - qc * gy - q3 * gz);
+	q1 += (qa * gx + qc * gz - q3 * gy);
+	q2 += (qa * gy - qb * gz + q3 * gx);
+	q3 += (qa * gz + qb * gy - qc * gx); 
+	
+	// Normalise quaternion
+	recipNorm = invSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+	q0 *= recipNorm;
+	q1 *= recipNorm;
+	q2 *= recipNorm;
+	q3 *= recipNorm;
+
+	m->q0 = q0;
+	m->q1 = q1;
+	m->q2 = q2;
+	m->q3 = q3;
+	quat_cache_invalidate(&m->cache);
+}
+
+//---------------------------------------------------------------------------------------------------
+// Outputs
+// The update functions only maintain the quaternion. Euler angles (degrees: roll, pitch, yaw),
+// rotation matrix and gravity direction are derived on first read and cached until the next update.
+
+void mahony_get_quat(const mahony_t *m, float *q) {
+	q[0] = m->q0;
+	q[1] = m->q1;
+	q[2] = m->q2;
+	q[3] = m->q3;
+}
+
+void mahony_get_angle(mahony_t *m, float *angle) {
+	const float *e = quat_cache_euler(&m->cache, m->q0, m->q1, m->q2, m->q3);
+	angle[0] = e[0];
+	angle[1] = e[1];
+	angle[2] = e[2];
+}
+
+void mahony_get_dcm(mahony_t *m, float dcm[3][3]) {
+	memcpy(dcm, quat_cache_dcm(&m->cache, m->q0, m->q1, m->q2, m->q3), sizeof(float) * 9);
+}
+
+void mahony_get_gravity(mahony_t *m, float *g) {
+	const float *v = quat_cache_gravity(&m->cache, m->q0, m->q1, m->q2, m->q3);
+	g[0] = v[0];
+	g[1] = v[1];
+	g[2] = v[2];
+}
+
+//---------------------------------------------------------------------------------------------------
+// Fixed-point IMU algorithm update
+// Gyroscope (rad/s) and accelerometer in Q16.16, quaternion in Q30 (same format as the DMP output).
+// Only 32x32->64 integer multiplies, no soft-float calls.
+
+void mahony_fixed_init(mahony_fixed_t *m, float kp, float ki) {
+	m->twoKp = Q16_FROM_FLOAT(kp > 0.0f ? 2.0f * kp : twoKpDef);
+	m->twoKi = Q16_FROM_FLOAT(ki > 0.0f ? 2.0f * ki : twoKiDef);
+	m->q[0] = Q30_ONE;
+	m->q[1] = 0;
+	m->q[2] = 0;
+	m->q[3] = 0;
+	quat_cache_q30_invalidate(&m->cache);
+	m->integralFBQ24[0] = 0;
+	m->integralFBQ24[1] = 0;
+	m->integralFBQ24[2] = 0;
+}
+
+void mahony_update_imu_fixed(mahony_fixed_t *m, q16_t gx, q16_t gy, q16_t gz, q16_t ax, q16_t ay, q16_t az, q30_t dt) {
+	q30_t a[3];
+	q30_t halfvx, halfvy, halfvz;
+	q30_t halfex, halfey, halfez;
+	q30_t qa = m->q[0], qb = m->q[1], qc = m->q[2], qd = m->q[3];
+	q30_t twoKiDt, halfDt = dt >> 1;
+	int32_t dx, dy, dz;
+
+	// Compute feedback only if accelerometer measurement valid, normalise accelerometer measurement to Q30
+	if(q30_normalize3(a, ax, ay, az) == 0) {
+
+		// Estimated direction of gravity
+		halfvx = q30_mul(qb, qd) - q30_mul(qa, qc);
+		halfvy = q30_mul(qa, qb) + q30_mul(qc, qd);
+		halfvz = q30_mul(qa, qa) - (Q30_ONE >> 1) + q30_mul(qd, qd);
+
+		// Error is cross product between estimated and measured direction of gravity
+		halfex = q30_mul(a[1], halfvz) - q30_mul(a[2], halfvy);
+		halfey = q30_mul(a[2], halfvx) - q30_mul(a[0], halfvz);
+		halfez = q30_mul(a[0], halfvy) - q30_mul(a[1], halfvx);
+
+		// Compute and apply integral feedback if enabled
+		if(m->twoKi > 0) {
+			twoKiDt = (q30_t)(((int64_t)m->twoKi * dt) >> 16);						// Q16 * Q30 -> Q30
+			// Round to nearest: a flooring shift adds a -0.5 LSB bias every sample, which the
+			// integrator accumulates into a steady attitude offset
+			m->integralFBQ24[0] += (int32_t)(((int64_t)halfex * twoKiDt + ((int64_t)1 << 35)) >> 36);	// Q60 -> Q24
+			m->integralFBQ24[1] += (int32_t)(((int64_t)halfey * twoKiDt + ((int64_t)1 << 35)) >> 36);
+			m->integralFBQ24[2] += (int32_t)(((int64_t)halfez * twoKiDt + ((int64_t)1 << 35)) >> 36);
+			gx += (m->integralFBQ24[0] + (1 << 7)) >> 8;
+			gy += (m->integralFBQ24[1] + (1 << 7)) >> 8;
+			gz += (m->integralFBQ24[2] + (1 << 7)) >> 8;
+		}
+		else {
+			m->integralFBQ24[0] = 0;
+			m->integralFBQ24[1] = 0;
+			m->integralFBQ24[2] = 0;
+		}
+
+		// Apply proportional feedback
+		gx += q30_mul_q16(halfex, m->twoKp);
+		gy += q30_mul_q16(halfey, m->twoKp);
+		gz += q30_mul_q16(halfez, m->twoKp);
+	}
+
+	// Integrate rate of change of quaternion, g * dt / 2 in Q30
+	dx = (int32_t)(((int64_t)gx * halfDt) >> 16);
+	dy = (int32_t)(((int64_t)gy * halfDt) >> 16);
+	dz = (int32_t)(((int64_t)gz * halfDt) >> 16);
+	m->q[0] = qa + (-q30_mul(qb, dx) - q30_mul(qc, dy) - q30_mul(qd, dz));
+	m->q[1] = qb + (q30_mul(qa, dx) + q30_mul(qc, dz) - q30_mul(qd, dy));
+	m->q[2] = qc + (q30_mul(qa, dy) - q30_mul(qb, dz) + q30_mul(qd, dx));
+	m->q[3] = qd + (q30_mul(qa, dz) + q30_mul(qb, dy) - q30_mul(qc, dx));
+
+	// Normalise quaternion
+	q30_normalize4(m->q);
+	quat_cache_q30_invalidate(&m->cache);
+}
+
+//---------------------------------------------------------------------------------------------------
+// Fixed-point outputs: Euler angles in Q16 degrees, rotation matrix and gravity direction in Q30
+
+void mahony_fixed_get_angle(mahony_fixed_t *m, q16_t *angle) {
+	const q16_t *e = quat_cache_q30_euler(&m->cache, m->q);
+	angle[0] = e[0];
+	angle[1] = e[1];
+	angle[2] = e[2];
+}
+
+void mahony_fixed_get_dcm(mahony_fixed_t *m, q30_t dcm[3][3]) {
+	memcpy(dcm, quat_cache_q30_dcm(&m->cache, m->q), sizeof(q30_t) * 9);
+}
+
+void mahony_fixed_get_gravity(mahony_fixed_t *m, q30_t *g) {
+	const q30_t *v = quat_cache_q30_gravity(&m->cache, m->q);
+	g[0] = v[0];
+	g[1] = v[1];
+	g[2] = v[2];
+}
+
+//====================================================================================================
+// END OF CODE
+//====================================================================================================
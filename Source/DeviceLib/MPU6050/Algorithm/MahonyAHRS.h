@@ -1,10 +1,44 @@
-#ifndef MahonyAHRS_h
-#define MahonyAHRS_h
-
-#include "main.h"
-
-void MahonyAHRSupdate(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz, float* IMU_Angle);
-void MahonyAHRSupdateIMU(float gx, float gy, float gz, float ax, float ay, float az, float* IMU_Angle);
-
-#endif
-
+#ifndef MahonyAHRS_h
+#define MahonyAHRS_h
+
+#include "main.h"
+#include "FixedPoint.h"
+#include "Quaternion.h"
+
+/* 滤波器实例，每个IMU一份，可以同时运行多个 */
+typedef struct {
+	float twoKp;                        // 2 * proportional gain (Kp)
+	float twoKi;                        // 2 * integral gain (Ki)
+	float q0, q1, q2, q3;               // quaternion of sensor frame relative to auxiliary frame
+	float integralFBx, integralFBy, integralFBz;   // integral error terms scaled by Ki
+	quat_cache_t cache;                 // derived outputs, computed on demand
+} mahony_t;
+
+/* 定点实例：角速度、加速度为Q16，四元数为Q30 */
+typedef struct {
+	q16_t twoKp;
+	q16_t twoKi;
+	q30_t q[4];
+	int32_t integralFBQ24[3];
+	quat_cache_q30_t cache;
+} mahony_fixed_t;
+
+/* 定点内核相对浮点内核的欧拉角误差上限（度），由 Tools/host/ahrs_check.c 校验
+   （1kHz合成IMU序列，Kp=2.5，Ki=0.1 实测最大约0.007度） */
+#define MAHONY_FIXED_ERR_DEG     0.02
+
+void mahony_init(mahony_t *m, float kp, float ki);
+void mahony_update(mahony_t *m, float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz, float dt);
+void mahony_update_imu(mahony_t *m, float gx, float gy, float gz, float ax, float ay, float az, float dt);
+void mahony_get_quat(const mahony_t *m, float *q);
+void mahony_get_angle(mahony_t *m, float *angle);
+void mahony_get_dcm(mahony_t *m, float dcm[3][3]);
+void mahony_get_gravity(mahony_t *m, float *g);
+
+void mahony_fixed_init(mahony_fixed_t *m, float kp, float ki);
+void mahony_update_imu_fixed(mahony_fixed_t *m, q16_t gx, q16_t gy, q16_t gz, q16_t ax, q16_t ay, q16_t az, q30_t dt);
+void mahony_fixed_get_angle(mahony_fixed_t *m, q16_t *angle);
+void mahony_fixed_get_dcm(mahony_fixed_t *m, q30_t dcm[3][3]);
+void mahony_fixed_get_gravity(mahony_fixed_t *m, q30_t *g);
+
+#endif
@@ -0,0 +1,146 @@
+#include "Quaternion.h"
+#include "FastTrig.h"
+
+/**
+  * @brief   读取欧拉角，未缓存时计算
+  * @param   c 缓存   q0~q3 当前四元数
+  * @retval  roll pitch yaw，度
+ **/
+const float *quat_cache_euler(quat_cache_t *c, float q0, float q1, float q2, float q3)
+{
+	if(!(c->valid & QUAT_CACHE_EULER))
+	{
+		fast_euler(q0, q1, q2, q3, c->euler);
+		c->valid |= QUAT_CACHE_EULER;
+	}
+	return c->euler;
+}
+
+/**
+  * @brief   读取旋转矩阵，未缓存时计算
+  * @param   c 缓存   q0~q3 当前四元数（单位四元数）
+  * @retval  3x3旋转矩阵，机体坐标系到参考坐标系
+ **/
+const float (*quat_cache_dcm(quat_cache_t *c, float q0, float q1, float q2, float q3))[3]
+{
+	float q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3;
+	if(!(c->valid & QUAT_CACHE_DCM))
+	{
+		q0q1 = q0 * q1; q0q2 = q0 * q2; q0q3 = q0 * q3;
+		q1q1 = q1 * q1; q1q2 = q1 * q2; q1q3 = q1 * q3;
+		q2q2 = q2 * q2; q2q3 = q2 * q3; q3q3 = q3 * q3;
+		c->dcm[0][0] = 1.0f - 2.0f * (q2q2 + q3q3);
+		c->dcm[0][1] = 2.0f * (q1q2 - q0q3);
+		c->dcm[0][2] = 2.0f * (q1q3 + q0q2);
+		c->dcm[1][0] = 2.0f * (q1q2 + q0q3);
+		c->dcm[1][1] = 1.0f - 2.0f * (q1q1 + q3q3);
+		c->dcm[1][2] = 2.0f * (q2q3 - q0q1);
+		c->dcm[2][0] = 2.0f * (q1q3 - q0q2);
+		c->dcm[2][1] = 2.0f * (q2q3 + q0q1);
+		c->dcm[2][2] = 1.0f - 2.0f * (q1q1 + q2q2);
+		c->valid |= QUAT_CACHE_DCM;
+	}
+	return (const float (*)[3])c->dcm;
+}
+
+/**
+  * @brief   读取机体坐标系下的重力方向，未缓存时计算
+  * @note    即旋转矩阵的第三行，与 quat_cache_dcm 公式一致，矩阵已缓存时直接复制
+  * @param   c 缓存   q0~q3 当前四元数
+  * @retval  重力方向单位向量
+ **/
+const float *quat_cache_gravity(quat_cache_t *c, float q0, float q1, float q2, float q3)
+{
+	if(!(c->valid & QUAT_CACHE_GRAVITY))
+	{
+		if(c->valid & QUAT_CACHE_DCM)
+		{
+			c->gravity[0] = c->dcm[2][0];
+			c->gravity[1] = c->dcm[2][1];
+			c->gravity[2] = c->dcm[2][2];
+		}
+		else
+		{
+			c->gravity[0] = 2.0f * (q1 * q3 - q0 * q2);
+			c->gravity[1] = 2.0f * (q0 * q1 + q2 * q3);
+			c->gravity[2] = 1.0f - 2.0f * (q1 * q1 + q2 * q2);
+		}
+		c->valid |= QUAT_CACHE_GRAVITY;
+	}
+	return c->gravity;
+}
+
+/**
+  * @brief   读取欧拉角（定点），未缓存时计算
+  * @param   c 缓存   q 当前四元数，Q30
+  * @retval  roll pitch yaw，Q16 度
+ **/
+const q16_t *quat_cache_q30_euler(quat_cache_q30_t *c, const q30_t *q)
+{
+	if(!(c->valid & QUAT_CACHE_EULER))
+	{
+		fast_euler_q30(q, c->euler);
+		c->valid |= QUAT_CACHE_EULER;
+	}
+	return c->euler;
+}
+
+/**
+  * @brief   读取旋转矩阵（定点），未缓存时计算
+  * @param   c 缓存   q 当前四元数，Q30
+  * @retval  3x3旋转矩阵，Q30
+ **/
+const q30_t (*quat_cache_q30_dcm(quat_cache_q30_t *c, const q30_t *q))[3]
+{
+	q30_t q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3, s;
+	if(!(c->valid & QUAT_CACHE_DCM))
+	{
+		q0q1 = q30_mul(q[0], q[1]); q0q2 = q30_mul(q[0], q[2]); q0q3 = q30_mul(q[0], q[3]);
+		q1q1 = q30_mul(q[1], q[1]); q1q2 = q30_mul(q[1], q[2]); q1q3 = q30_mul(q[1], q[3]);
+		q2q2 = q30_mul(q[2], q[2]); q2q3 = q30_mul(q[2], q[3]); q3q3 = q30_mul(q[3], q[3]);
+		//非对角项中两乘积之和的绝对值不超过0.5，乘2后不溢出；
+		//对角项的平方和可达1.0（2^30），乘2会超出int32，改为分两次减去
+		s = q2q2 + q3q3;
+		c->dcm[0][0] = Q30_ONE - s - s;
+		c->dcm[0][1] = 2 * (q1q2 - q0q3);
+		c->dcm[0][2] = 2 * (q1q3 + q0q2);
+		c->dcm[1][0] = 2 * (q1q2 + q0q3);
+		s = q1q1 + q3q3;
+		c->dcm[1][1] = Q30_ONE - s - s;
+		c->dcm[1][2] = 2 * (q2q3 - q0q1);
+		c->dcm[2][0] = 2 * (q1q3 - q0q2);
+		c->dcm[2][1] = 2 * (q2q3 + q0q1);
+		s = q1q1 + q2q2;
+		c->dcm[2][2] = Q30_ONE - s - s;
+		c->valid |= QUAT_CACHE_DCM;
+	}
+	return (const q30_t (*)[3])c->dcm;
+}
+
+/**
+  * @brief   读取机体坐标系下的重力方向（定点），未缓存时计算
+  * @param   c 缓存   q 当前四元数，Q30
+  * @retval  重力方向单位向量，Q30
+ **/
+const q30_t *quat_cache_q30_gravity(quat_cache_q30_t *c, const q30_t *q)
+{
+	q30_t s;
+	if(!(c->valid & QUAT_CACHE_GRAVITY))
+	{
+		if(c->valid & QUAT_CACHE_DCM)
+		{
+			c->gravity[0] = c->dcm[2][0];
+			c->gravity[1] = c->dcm[2][1];
+			c->gravity[2] = c->dcm[2][2];
+		}
+		else
+		{
+			c->gravity[0] = 2 * (q30_mul(q[1], q[3]) - q30_mul(q[0], q[2]));
+			c->gravity[1] = 2 * (q30_mul(q[0], q[1]) + q30_mul(q[2], q[3]));
+			s = q30_mul(q[1], q[1]) + q30_mul(q[2], q[2]);
+			c->gravity[2] = Q30_ONE - s - s;   //同旋转矩阵对角项，避免 2 * s 溢出
+		}
+		c->valid |= QUAT_CACHE_GRAVITY;
+	}
+	return c->gravity;
+}
@@ -0,0 +1,44 @@
+#ifndef _QUATERNION_H
+#define _QUATERNION_H
+
+#include <stdint.h>
+#include "FixedPoint.h"
+
+/**
+  * 由四元数派生的输出量：欧拉角、旋转矩阵、重力方向
+  * 滤波器每次更新只维护四元数，派生量在第一次读取时计算并缓存，下一次更新时失效
+  * 融合频率远高于显示/控制频率时，可以省掉每个采样的三角函数运算
+  */
+#define QUAT_CACHE_EULER      0x01
+#define QUAT_CACHE_DCM        0x02
+#define QUAT_CACHE_GRAVITY    0x04
+
+/* 浮点缓存 */
+typedef struct {
+	uint8_t valid;          //已缓存的量，QUAT_CACHE_xxx
+	float euler[3];         //roll pitch yaw，度
+	float dcm[3][3];        //旋转矩阵，机体坐标系到参考坐标系
+	float gravity[3];       //机体坐标系下的重力方向，单位向量
+}quat_cache_t;
+
+/* 定点缓存：欧拉角Q16（度），旋转矩阵和重力方向Q30 */
+typedef struct {
+	uint8_t valid;
+	q16_t euler[3];
+	q30_t dcm[3][3];
+	q30_t gravity[3];
+}quat_cache_q30_t;
+
+/* 四元数更新后调用 */
+static __inline void quat_cache_invalidate(quat_cache_t *c) { c->valid = 0; }
+static __inline void quat_cache_q30_invalidate(quat_cache_q30_t *c) { c->valid = 0; }
+
+const float *quat_cache_euler(quat_cache_t *c, float q0, float q1, float q2, float q3);
+const float (*quat_cache_dcm(quat_cache_t *c, float q0, float q1, float q2, float q3))[3];
+const float *quat_cache_gravity(quat_cache_t *c, float q0, float q1, float q2, float q3);
+
+const q16_t *quat_cache_q30_euler(quat_cache_q30_t *c, const q30_t *q);
+const q30_t (*quat_cache_q30_dcm(quat_cache_q30_t *c, const q30_t *q))[3];
+const q30_t *quat_cache_q30_gravity(quat_cache_q30_t *c, const q30_t *q);
+
+#endif
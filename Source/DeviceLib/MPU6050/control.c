@@ -1,224 +1,423 @@
-#include "control.h"
-#include "stdio.h"
-
-#include "mpu6050.h"
-#include "KalmanFilter.h"
-#include "FirstOrderLowPassFilter.h"
-#include "MahonyAHRS.h"
-#include "MadgwickAHRS.h"
-#include "math.h"
-#include "inv_mpu_stm32port.h"
-
-#include "bsp_delay.h"
-
-#define PI 3.1415926
-
-static volatile uint8_t data_ready = 0;
-
-mpu6050_data_t mpu6050_data;
-
-static void cal_with_kalman(void);
-static void cal_with_folpf(void);
-static void cal_with_ahrs(void);
-static void cal_with_dmp(void);
-
-/**
-  * @brief   жϸźţòִжŵжϴУmain.cе
-  * @param   
-  * @retval  void
- **/
-void exit_update()
-{
-	data_ready = 1;
-}
-
-/**
-  * @brief   ִп񣬸òִmain.cwhileǰ
-  * @param    
-  * @retval  void
- **/
-void app_run_main()
-{
-	cal_with_kalman();
-//	cal_with_folpf();
-//	cal_with_ahrs();
-//	cal_with_dmp();
-}
-/**
-  * @brief   ʹkalman˲Ƕ
-  * @param    
-  * @retval  void
- **/
-static void cal_with_kalman()
-{
-	int count = 0;
-	mpu6050_init();
-	while(1)
-	{
-		//òָ»ͳʼmpu6050ʱĶĲ
-//		if(1 == data_ready)
-//		{
-//			data_ready = 0;
-		delay_ms(10);
-			//6050ԭʼ
-			mpu6050_get_gyro(&mpu6050_data.gyro[0],&mpu6050_data.gyro[1],&mpu6050_data.gyro[2]);
-			mpu6050_get_acc(&mpu6050_data.acc[0],&mpu6050_data.acc[1],&mpu6050_data.acc[2]);
-			
-			//λ ת
-			mpu6050_data.gyroxReal = mpu6050_data.gyro[0] * MPU6050_GYRO_2000_SEN;
-			mpu6050_data.gyroyReal = mpu6050_data.gyro[1] * MPU6050_GYRO_2000_SEN;
-			mpu6050_data.gyrozReal = mpu6050_data.gyro[2] * MPU6050_GYRO_2000_SEN;
-			mpu6050_data.accxReal  = mpu6050_data.acc[0]  * MPU6050_ACCEL_2G_SEN;
-			mpu6050_data.accyReal  = mpu6050_data.acc[1]  * MPU6050_ACCEL_2G_SEN;
-			mpu6050_data.acczReal  = mpu6050_data.acc[2]  * MPU6050_ACCEL_2G_SEN;
-			
-			//Ƕ ˲ʽ
-			mpu6050_data.accyAngle=atan2(mpu6050_data.acc[0],mpu6050_data.acc[2])*180/PI;  //ٶȼ	
-			Kalman_getAngle(&KalmanY,mpu6050_data.accyAngle,-mpu6050_data.gyroyReal,0.01); //˲Ƕ
-			mpu6050_data.anglePitch = KalmanY.angle;
-			
-			mpu6050_data.accxAngle=atan2(mpu6050_data.acc[1],mpu6050_data.acc[2])*180/PI;  //ٶȼ	
-			Kalman_getAngle(&KalmanX,mpu6050_data.accxAngle,-mpu6050_data.gyroxReal,0.01); //˲Ƕ
-			mpu6050_data.angleRoll = KalmanX.angle;
-			
-			count ++;
-			if(count % 100 == 0)
-			{
-				printf("%f, %f, %f\r\n",mpu6050_data.anglePitch,mpu6050_data.angleRoll,mpu6050_data.angleYaw);
-			}
-//		}
-	}
-}
-
-/**
-  * @brief   ʹû˲Ƕ
-  * @param    
-  * @retval  void
- **/
-static void cal_with_folpf()
-{
-	int count = 0;
-	mpu6050_init();
-	while(1)
-	{
-		//òָ»ͳʼmpu6050ʱĶĲ
-//		if(1 == data_ready)
-//		{
-		delay_ms(10);
-			data_ready = 0;
-			//6050ԭʼ
-			mpu6050_get_gyro(&mpu6050_data.gyro[0],&mpu6050_data.gyro[1],&mpu6050_data.gyro[2]);
-			mpu6050_get_acc(&mpu6050_data.acc[0],&mpu6050_data.acc[1],&mpu6050_data.acc[2]);
-			
-			//λ ת
-			mpu6050_data.gyroxReal = mpu6050_data.gyro[0] * MPU6050_GYRO_2000_SEN;
-			mpu6050_data.gyroyReal = mpu6050_data.gyro[1] * MPU6050_GYRO_2000_SEN;
-			mpu6050_data.gyrozReal = mpu6050_data.gyro[2] * MPU6050_GYRO_2000_SEN;
-			mpu6050_data.accxReal  = mpu6050_data.acc[0]  * MPU6050_ACCEL_2G_SEN;
-			mpu6050_data.accyReal  = mpu6050_data.acc[1]  * MPU6050_ACCEL_2G_SEN;
-			mpu6050_data.acczReal  = mpu6050_data.acc[2]  * MPU6050_ACCEL_2G_SEN;
-			
-			//Ƕ ˲ʽ
-			mpu6050_data.accyAngle=atan2(mpu6050_data.acc[0],mpu6050_data.acc[2])*180/PI;  //ٶȼ	
-			FirstOrderLowPassFilter(&FOLPF_angley,mpu6050_data.accyAngle,-mpu6050_data.gyroyReal,0.01); //˲Ƕ
-			mpu6050_data.anglePitch = FOLPF_angley.angle;
-			
-			mpu6050_data.accxAngle=atan2(mpu6050_data.acc[1],mpu6050_data.acc[2])*180/PI;  //ٶȼ	
-			FirstOrderLowPassFilter(&FOLPF_anglex,mpu6050_data.accxAngle,-mpu6050_data.gyroxReal,0.01); //˲Ƕ
-			mpu6050_data.angleRoll = FOLPF_anglex.angle;
-			
-			count ++;
-			if(count % 100 == 0)
-			{
-				printf("%f, %f, %f\r\n",mpu6050_data.anglePitch,mpu6050_data.angleRoll,mpu6050_data.angleYaw);
-			}
-		}
-//	}
-}
-
-/**
-  * @brief   ʹAHRS㷨Ƕ
-  * @param    
-  * @retval  void
- **/
-static void cal_with_ahrs()
-{
-	int count = 0;
-	mpu6050_init();
-	while(1)
-	{
-		//òָ»ͳʼmpu6050ʱĶĲ
-//		if(1 == data_ready)
-//		{
-			data_ready = 0;
-			//6050ԭʼ
-			mpu6050_get_gyro(&mpu6050_data.gyro[0],&mpu6050_data.gyro[1],&mpu6050_data.gyro[2]);
-			mpu6050_get_acc(&mpu6050_data.acc[0],&mpu6050_data.acc[1],&mpu6050_data.acc[2]);
-			
-			//λ ת
-			mpu6050_data.gyroxReal = mpu6050_data.gyro[0] * MPU6050_GYRO_2000_SEN;
-			mpu6050_data.gyroyReal = mpu6050_data.gyro[1] * MPU6050_GYRO_2000_SEN;
-			mpu6050_data.gyrozReal = mpu6050_data.gyro[2] * MPU6050_GYRO_2000_SEN;
-			mpu6050_data.accxReal  = mpu6050_data.acc[0]  * MPU6050_ACCEL_2G_SEN;
-			mpu6050_data.accyReal  = mpu6050_data.acc[1]  * MPU6050_ACCEL_2G_SEN;
-			mpu6050_data.acczReal  = mpu6050_data.acc[2]  * MPU6050_ACCEL_2G_SEN;
-			
-			//Ƕֵ Mahony
-			MahonyAHRSupdate(mpu6050_data.gyroxReal,mpu6050_data.gyroyReal,mpu6050_data.gyrozReal, \
-							 mpu6050_data.accxReal,mpu6050_data.accyReal,mpu6050_data.acczReal,    \
-							 0, 0, 0, mpu6050_data.angle);
-			//Ƕֵ Madgwick
-//			MadgwickAHRSupdate(mpu6050_data.gyroxReal,mpu6050_data.gyroyReal,mpu6050_data.gyrozReal, \
-//							   mpu6050_data.accxReal,mpu6050_data.accyReal,mpu6050_data.acczReal,    \
-//							   0, 0, 0, mpu6050_data.angle);
-			
-			mpu6050_data.angleRoll  = mpu6050_data.angle[0];
-			mpu6050_data.anglePitch = mpu6050_data.angle[1];
-			mpu6050_data.angleYaw   = mpu6050_data.angle[2];
-			
-			count ++;
-			if(count % 100 == 0)
-			{
-				printf("%f, %f, %f\r\n",mpu6050_data.anglePitch,mpu6050_data.angleRoll,mpu6050_data.angleYaw);
-			}
-//		}
-	}
-}
-/**
-  * @brief   ʹDMPǶ
-  * @param    
-  * @retval  void
- **/
-static void cal_with_dmp()
-{
-	int count = 0;
-	mpu_dmp_init();
-	while(1)
-	{
-		//òָ»ͳʼmpu6050ʱĶĲ
-		if(1 == data_ready)
-		{
-			data_ready = 0;
-			if(mpu_dmp_get_data(&mpu6050_data.anglePitch,&mpu6050_data.angleRoll,&mpu6050_data.angleYaw)==0)
-			{ 
-				mpu6050_get_gyro(&mpu6050_data.gyro[0],&mpu6050_data.gyro[1],&mpu6050_data.gyro[2]);
-				mpu6050_get_acc (&mpu6050_data.acc[0] ,&mpu6050_data.acc[1] ,&mpu6050_data.acc[2]);
-				//λ ת
-				mpu6050_data.gyroxReal = mpu6050_data.gyro[0] * MPU6050_GYRO_2000_SEN;
-				mpu6050_data.gyroyReal = mpu6050_data.gyro[1] * MPU6050_GYRO_2000_SEN;
-				mpu6050_data.gyrozReal = mpu6050_data.gyro[2] * MPU6050_GYRO_2000_SEN;
-				mpu6050_data.accxReal  = mpu6050_data.acc[0]  * MPU6050_ACCEL_2G_SEN;
-				mpu6050_data.accyReal  = mpu6050_data.acc[1]  * MPU6050_ACCEL_2G_SEN;
-				mpu6050_data.acczReal  = mpu6050_data.acc[2]  * MPU6050_ACCEL_2G_SEN;
-			}
-			count ++;
-			if(count % 100 == 0)
-			{
-				printf("%f, %f, %f\r\n",mpu6050_data.anglePitch,mpu6050_data.angleRoll,mpu6050_data.angleYaw);
-			}
-		}
-	}
-}
-
-
-
+#include "control.h"
+#include "stdio.h"
+
+#include "mpu6050.h"
+#include "KalmanFilter.h"
+#include "FirstOrderLowPassFilter.h"
+#include "MahonyAHRS.h"
+#include "MadgwickAHRS.h"
+#include "FastTrig.h"
+#include "inv_mpu_stm32port.h"
+
+#include "bsp_delay.h"
+#include "bsp_exti.h"
+#include <string.h>
+
+#define CONTROL_AHRS_FIXED   0   //1: AHRS使用Q16/Q30定点内核（无软件浮点运算） 0: 浮点内核
+
+#define SENSOR_RATE        100                    //采样率（Hz），与 mpu6050_init 中的配置一致
+#define SENSOR_DT_NOMINAL  (1000000 / SENSOR_RATE) //第一帧或间隔异常时使用的名义采样周期（us）
+#define SENSOR_DT_MAX      100000                 //相邻两帧间隔超过该值（长时间停顿）时按名义周期处理（us）
+
+static volatile uint8_t data_ready = 0;
+
+/*
+ * 数据就绪流水线：INT引脚上升沿 -> exit_update 记录时间戳并启动异步突发读取
+ * -> 读取完成回调把数据放入 sensor_raw -> 主循环取出并以实测的dt执行融合
+ * 主循环在没有新数据时进入睡眠，处理延迟只取决于数据到达的时刻
+ * 总线没有后台传输能力（软件I2C）时，中断只记录时间戳，由主循环在 wait_sensor 中读取，
+ * 避免在中断中阻塞位操作读取，也避免与主循环中同一总线上的传输冲突
+ */
+static volatile uint8_t sensor_async = 0;       //1: INT中断启动原始数据读取 0: 只置位 data_ready（DMP模式）
+static volatile uint8_t sensor_defer = 0;       //1: 同步总线，读取推迟到 wait_sensor 中进行
+static volatile uint8_t sensor_busy = 0;        //异步读取进行中
+static uint8_t sensor_rx[MPU6050_FRAME_LEN];    //异步读取缓冲区
+static uint8_t sensor_raw[MPU6050_FRAME_LEN];   //最近一次完成的数据
+static uint32_t sensor_rx_ts, sensor_raw_ts;    //INT边沿时刻（us）
+static uint32_t sensor_last_ts;                 //上一帧参与融合的时刻
+static uint8_t sensor_last_valid = 0;
+static volatile uint32_t sensor_overrun = 0;    //上一次读取尚未完成或数据未被取走时又来了新数据
+static volatile uint32_t sensor_bus_err = 0;    //读取失败次数
+
+mpu6050_data_t mpu6050_data;
+
+static void cal_with_kalman(void);
+static void cal_with_folpf(void);
+static void cal_with_ahrs(void);
+static void cal_with_dmp(void);
+
+/**
+  * @brief   保存一帧加速度、温度、角速度，并做单位解算 量程转换
+  * @param   frame 采样帧
+  * @retval  void
+ **/
+static void fill_sensor(const mpu6050_frame_t *frame)
+{
+	mpu6050_data.timestamp = frame->timestamp;
+	mpu6050_data.temp      = frame->temp;
+	mpu6050_data.acc[0]  = frame->acc[0];
+	mpu6050_data.acc[1]  = frame->acc[1];
+	mpu6050_data.acc[2]  = frame->acc[2];
+	mpu6050_data.gyro[0] = frame->gyro[0];
+	mpu6050_data.gyro[1] = frame->gyro[1];
+	mpu6050_data.gyro[2] = frame->gyro[2];
+
+	//定点换算只有整数乘法和移位，供定点滤波器使用
+	mpu6050_data.gyroQ16[0] = mpu6050_gyro_q16(frame->gyro[0]);
+	mpu6050_data.gyroQ16[1] = mpu6050_gyro_q16(frame->gyro[1]);
+	mpu6050_data.gyroQ16[2] = mpu6050_gyro_q16(frame->gyro[2]);
+	mpu6050_data.accQ16[0]  = mpu6050_acc_q16(frame->acc[0]);
+	mpu6050_data.accQ16[1]  = mpu6050_acc_q16(frame->acc[1]);
+	mpu6050_data.accQ16[2]  = mpu6050_acc_q16(frame->acc[2]);
+
+	mpu6050_data.gyroxReal = mpu6050_data.gyro[0] * MPU6050_GYRO_2000_SEN;
+	mpu6050_data.gyroyReal = mpu6050_data.gyro[1] * MPU6050_GYRO_2000_SEN;
+	mpu6050_data.gyrozReal = mpu6050_data.gyro[2] * MPU6050_GYRO_2000_SEN;
+	mpu6050_data.accxReal  = mpu6050_data.acc[0]  * MPU6050_ACCEL_2G_SEN;
+	mpu6050_data.accyReal  = mpu6050_data.acc[1]  * MPU6050_ACCEL_2G_SEN;
+	mpu6050_data.acczReal  = mpu6050_data.acc[2]  * MPU6050_ACCEL_2G_SEN;
+}
+
+/**
+  * @brief   把欧拉角同步到 angleRoll/anglePitch/angleYaw
+  * @param   
+  * @retval  void
+ **/
+static void publish_angle(void)
+{
+	mpu6050_data.angleRoll  = mpu6050_data.angle[0];
+	mpu6050_data.anglePitch = mpu6050_data.angle[1];
+	mpu6050_data.angleYaw   = mpu6050_data.angle[2];
+}
+
+/**
+  * @brief   同步读取一帧（DMP模式下读取原始数据用）
+  * @param   
+  * @retval  0 成功 其他 读取失败
+ **/
+static uint8_t update_sensor(void)
+{
+	mpu6050_frame_t frame;
+	uint8_t res = mpu6050_read_frame(&frame);
+	if(res == 0)
+		fill_sensor(&frame);
+	return res;
+}
+
+/**
+  * @brief   异步读取完成回调（可能在中断上下文中执行）
+  * @param   status 总线状态   arg 
+  * @retval  void
+ **/
+static void sensor_read_done(int status, void *arg)
+{
+	(void)arg;
+	if(status == 0)
+	{
+		if(data_ready)
+			sensor_overrun++;          //主循环还没取走上一帧，用新数据覆盖
+		memcpy(sensor_raw,sensor_rx,MPU6050_FRAME_LEN);
+		sensor_raw_ts = sensor_rx_ts;
+		data_ready = 1;
+	}
+	else
+	{
+		sensor_bus_err++;
+	}
+	sensor_busy = 0;
+}
+
+/**
+  * @brief   数据就绪中断处理，通过 bsp_exti_set_callback 注册到INT引脚的外部中断
+  * @param   
+  * @retval  void
+ **/
+void exit_update()
+{
+	if(!sensor_async)
+	{
+		data_ready = 1;
+		return;
+	}
+	if(sensor_defer)
+	{
+		if(data_ready)
+			sensor_overrun++;          //主循环还没取走上一帧，读取时得到的是最新数据
+		sensor_raw_ts = bus_timestamp_us(mpu6050_get_bus());
+		data_ready = 1;
+		return;
+	}
+	if(sensor_busy)
+	{
+		sensor_overrun++;
+		return;
+	}
+	sensor_busy = 1;
+	sensor_rx_ts = bus_timestamp_us(mpu6050_get_bus());
+	if(mpu6050_read_frame_async(sensor_rx,sensor_read_done,NULL) != 0)
+	{
+		sensor_bus_err++;
+		sensor_busy = 0;
+	}
+}
+
+/**
+  * @brief   开启数据就绪中断
+  * @param   async 1: 中断中启动原始数据读取 0: 只置位 data_ready
+  * @retval  void
+ **/
+static void sensor_start(uint8_t async)
+{
+	sensor_async = async;
+	//总线不支持异步读取时 mpu6050_read_frame_async 会退化为同步，不能放在中断中
+	sensor_defer = async && mpu6050_get_bus()->ops->read_reg_async == NULL;
+	sensor_last_valid = 0;
+	data_ready = 0;
+	bsp_exti_set_callback(exit_update);
+	bsp_exti_init();
+}
+
+/**
+  * @brief   等待下一帧数据，解析并计算与上一帧的实际时间间隔
+  * @note    没有新数据时 __WFI 睡眠，由INT中断唤醒
+  * @param   dt 两帧间隔（s）
+  * @retval  两帧间隔（us）
+ **/
+static uint32_t wait_sensor(float *dt)
+{
+	mpu6050_frame_t frame;
+	uint8_t raw[MPU6050_FRAME_LEN];
+	uint32_t ts, t;
+
+	for(;;)
+	{
+		//关中断后再检查并睡眠：检查之后、WFI之前到来的INT保持挂起，WFI会立即返回，不会丢失唤醒
+		while(!data_ready)
+		{
+			__disable_irq();
+			if(!data_ready)
+				__WFI();
+			__enable_irq();
+		}
+		__disable_irq();
+		memcpy(raw,sensor_raw,MPU6050_FRAME_LEN);
+		ts = sensor_raw_ts;
+		data_ready = 0;
+		__enable_irq();
+
+		if(!sensor_defer)
+		{
+			mpu6050_decode_frame(raw,&frame);
+			break;
+		}
+		//同步总线：中断中只记录了边沿时刻，在这里读取
+		if(mpu6050_read_frame(&frame) == 0)
+			break;
+		sensor_bus_err++;
+	}
+	frame.timestamp = ts;
+	fill_sensor(&frame);
+
+	t = ts - sensor_last_ts;
+	if(!sensor_last_valid || t == 0 || t > SENSOR_DT_MAX)
+		t = SENSOR_DT_NOMINAL;
+	sensor_last_ts = ts;
+	sensor_last_valid = 1;
+	*dt = t * 1e-6f;
+	return t;
+}
+
+/**
+  * @brief   执行控制任务，该部分代码放置在main.c的while前
+  * @param    
+  * @retval  void
+ **/
+void app_run_main()
+{
+	cal_with_kalman();
+//	cal_with_folpf();
+//	cal_with_ahrs();
+//	cal_with_dmp();
+}
+/**
+  * @brief   使用kalman滤波计算角度
+  * @param    
+  * @retval  void
+ **/
+static void cal_with_kalman()
+{
+	int count = 0;
+	float dt;
+	float newAngle[2], newRate[2];
+	mpu6050_init();
+	sensor_start(1);
+	while(1)
+	{
+		//等待INT中断送来的新数据，更新频率与初始化mpu6050时候的定义的采样率相关
+		wait_sensor(&dt);
+		
+		//计算角度 卡尔曼滤波方式（单精度，俯仰和横滚共用协方差和增益）
+		mpu6050_data.accyAngle=fast_atan2f(mpu6050_data.acc[0],mpu6050_data.acc[2])*FAST_TRIG_RAD2DEG;  //加速度计算倾角	
+		mpu6050_data.accxAngle=fast_atan2f(mpu6050_data.acc[1],mpu6050_data.acc[2])*FAST_TRIG_RAD2DEG;  //加速度计算倾角	
+		newAngle[0] = mpu6050_data.accyAngle;
+		newAngle[1] = mpu6050_data.accxAngle;
+		newRate[0]  = -mpu6050_data.gyroyReal;
+		newRate[1]  = -mpu6050_data.gyroxReal;
+		Kalman2f_update(&KalmanXY,newAngle,newRate,dt); //卡尔曼滤波算角度
+		mpu6050_data.anglePitch = KalmanXY.angle[0];
+		mpu6050_data.angleRoll  = KalmanXY.angle[1];
+		
+		count ++;
+		if(count % 100 == 0)
+		{
+			printf("%f, %f, %f\r\n",mpu6050_data.anglePitch,mpu6050_data.angleRoll,mpu6050_data.angleYaw);
+			mpu6050_warm_commit();   //后台校准的新零偏在这里写Flash，不占用采样处理路径
+		}
+	}
+}
+
+/**
+  * @brief   使用互补滤波计算角度
+  * @param    
+  * @retval  void
+ **/
+static void cal_with_folpf()
+{
+	int count = 0;
+	float dt;
+	mpu6050_init();
+	sensor_start(1);
+	while(1)
+	{
+		//等待INT中断送来的新数据，更新频率与初始化mpu6050时候的定义的采样率相关
+		wait_sensor(&dt);
+		
+		//计算角度 互补滤波方式
+		mpu6050_data.accyAngle=fast_atan2f(mpu6050_data.acc[0],mpu6050_data.acc[2])*FAST_TRIG_RAD2DEG;  //加速度计算倾角	
+		FirstOrderLowPassFilter(&FOLPF_angley,mpu6050_data.accyAngle,-mpu6050_data.gyroyReal,dt); //互补滤波算角度
+		mpu6050_data.anglePitch = FOLPF_angley.angle;
+		
+		mpu6050_data.accxAngle=fast_atan2f(mpu6050_data.acc[1],mpu6050_data.acc[2])*FAST_TRIG_RAD2DEG;  //加速度计算倾角	
+		FirstOrderLowPassFilter(&FOLPF_anglex,mpu6050_data.accxAngle,-mpu6050_data.gyroxReal,dt); //互补滤波算角度
+		mpu6050_data.angleRoll = FOLPF_anglex.angle;
+		
+		count ++;
+		if(count % 100 == 0)
+		{
+			printf("%f, %f, %f\r\n",mpu6050_data.anglePitch,mpu6050_data.angleRoll,mpu6050_data.angleYaw);
+			mpu6050_warm_commit();
+		}
+	}
+}
+
+/**
+  * @brief   使用AHRS算法计算角度
+  * @param    
+  * @retval  void
+ **/
+static void cal_with_ahrs()
+{
+	int count = 0;
+	float dt;
+	uint32_t dt_us;
+#if CONTROL_AHRS_FIXED
+	mahony_fixed_t ahrs;
+//	madgwick_fixed_t ahrs;
+	mahony_fixed_init(&ahrs,0,0);
+//	madgwick_fixed_init(&ahrs,0);
+#else
+	mahony_t ahrs;
+//	madgwick_t ahrs;
+	mahony_init(&ahrs,0,0);
+//	madgwick_init(&ahrs,0);
+#endif
+	mpu6050_init();
+	sensor_start(1);
+	while(1)
+	{
+		//等待INT中断送来的新数据，更新频率与初始化mpu6050时候的定义的采样率相关，使用实测的dt
+		dt_us = wait_sensor(&dt);
+		
+#if CONTROL_AHRS_FIXED
+		//计算四元数 Mahony定点解算
+		mahony_update_imu_fixed(&ahrs,mpu6050_data.gyroQ16[0],mpu6050_data.gyroQ16[1],mpu6050_data.gyroQ16[2], \
+								mpu6050_data.accQ16[0],mpu6050_data.accQ16[1],mpu6050_data.accQ16[2], Q30_FROM_US(dt_us));
+		//计算四元数 Madgwick定点解算
+//		madgwick_update_imu_fixed(&ahrs,mpu6050_data.gyroQ16[0],mpu6050_data.gyroQ16[1],mpu6050_data.gyroQ16[2], \
+//								  mpu6050_data.accQ16[0],mpu6050_data.accQ16[1],mpu6050_data.accQ16[2], Q30_FROM_US(dt_us));
+#else
+		(void)dt_us;
+		//计算四元数 Mahony解算
+		mahony_update_imu(&ahrs,mpu6050_data.gyroxReal,mpu6050_data.gyroyReal,mpu6050_data.gyrozReal, \
+						  mpu6050_data.accxReal,mpu6050_data.accyReal,mpu6050_data.acczReal, dt);
+		//计算四元数 Madgwick解算
+//		madgwick_update_imu(&ahrs,mpu6050_data.gyroxReal,mpu6050_data.gyroyReal,mpu6050_data.gyrozReal, \
+//						    mpu6050_data.accxReal,mpu6050_data.accyReal,mpu6050_data.acczReal, dt);
+#endif
+		
+		//每个采样只输出四元数
+#if CONTROL_AHRS_FIXED
+		mpu6050_data.quat[0] = q30_to_float(ahrs.q[0]);
+		mpu6050_data.quat[1] = q30_to_float(ahrs.q[1]);
+		mpu6050_data.quat[2] = q30_to_float(ahrs.q[2]);
+		mpu6050_data.quat[3] = q30_to_float(ahrs.q[3]);
+#else
+		mahony_get_quat(&ahrs,mpu6050_data.quat);
+//		madgwick_get_quat(&ahrs,mpu6050_data.quat);
+#endif
+		
+		count ++;
+		if(count % 100 == 0)
+		{
+			//欧拉角只在需要显示时计算，结果缓存到下一次更新
+#if CONTROL_AHRS_FIXED
+			q16_t angle[3];
+			mahony_fixed_get_angle(&ahrs,angle);
+//			madgwick_fixed_get_angle(&ahrs,angle);
+			mpu6050_data.angle[0] = q16_to_float(angle[0]);
+			mpu6050_data.angle[1] = q16_to_float(angle[1]);
+			mpu6050_data.angle[2] = q16_to_float(angle[2]);
+#else
+			mahony_get_angle(&ahrs,mpu6050_data.angle);
+//			madgwick_get_angle(&ahrs,mpu6050_data.angle);
+#endif
+			publish_angle();
+			printf("%f, %f, %f\r\n",mpu6050_data.anglePitch,mpu6050_data.angleRoll,mpu6050_data.angleYaw);
+			mpu6050_warm_commit();
+		}
+	}
+}
+/**
+  * @brief   使用DMP库计算角度
+  * @param    
+  * @retval  void
+ **/
+static void cal_with_dmp()
+{
+	int count = 0;
+	mpu_dmp_init();
+	sensor_start(0);
+	while(1)
+	{
+		//该部分更新会和初始化mpu6050时候的定义的采样率相关
+		if(1 == data_ready)
+		{
+			data_ready = 0;
+			//一次读出FIFO中积压的全部数据包，只取最新一包的四元数
+			if(mpu_dmp_get_quat(mpu6050_data.quat)==0)
+			{ 
+				update_sensor();
+			}
+			count ++;
+			if(count % 100 == 0)
+			{
+				fast_euler(mpu6050_data.quat[0],mpu6050_data.quat[1],mpu6050_data.quat[2],mpu6050_data.quat[3],mpu6050_data.angle);
+				publish_angle();
+				printf("%f, %f, %f\r\n",mpu6050_data.anglePitch,mpu6050_data.angleRoll,mpu6050_data.angleYaw);
+			}
+		}
+	}
+}
+
+
+
@@ -1,32 +1,40 @@
-#ifndef _CONTROL_H
-#define _CONTROL_H
-
-#include "main.h"
-
-typedef struct{
-	float accxAngle;
-	float accyAngle;
-	float acczAngle;
-	
-	float gyroxReal;
-	float gyroyReal;
-	float gyrozReal;
-	
-	float accxReal;
-	float accyReal;
-	float acczReal;
-	
-	float angle[3];
-	
-	float angleRoll;
-	float anglePitch;
-	float angleYaw;
-	
-	int16_t gyro[3];
-	int16_t acc[3];
-}mpu6050_data_t;
-
-void exit_update(void);
-void app_run_main(void);
-
-#endif
+#ifndef _CONTROL_H
+#define _CONTROL_H
+
+#include "main.h"
+#include "FixedPoint.h"
+
+typedef struct{
+	float accxAngle;
+	float accyAngle;
+	float acczAngle;
+	
+	float gyroxReal;
+	float gyroyReal;
+	float gyrozReal;
+	
+	float accxReal;
+	float accyReal;
+	float acczReal;
+	
+	float quat[4];        //姿态四元数 w x y z，每个采样更新
+	float angle[3];       //欧拉角 roll pitch yaw，只在需要输出时由四元数换算
+	
+	float angleRoll;
+	float anglePitch;
+	float angleYaw;
+	
+	int16_t gyro[3];
+	int16_t acc[3];
+	int16_t temp;
+	
+	q16_t gyroQ16[3];     //角速度 rad/s，Q16定点
+	q16_t accQ16[3];      //加速度 m/s2，Q16定点
+	
+	uint32_t timestamp;   //采样时刻（us）
+}mpu6050_data_t;
+
+void exit_update(void);
+void app_run_main(void);
+
+#endif
@@ -1,207 +1,294 @@
-#include "inv_mpu_stm32port.h"
-#include <math.h>
-
-#include "inv_mpu.h"
-#include "inv_mpu_dmp_motion_driver.h"
-#include "stdio.h"
-
-#define ERROR_MPU_INIT      -1
-#define ERROR_SET_SENSOR    -2
-#define ERROR_CONFIG_FIFO   -3
-#define ERROR_SET_RATE      -4
-#define ERROR_LOAD_MOTION_DRIVER    -5 
-#define ERROR_SET_ORIENTATION       -6
-#define ERROR_ENABLE_FEATURE        -7
-#define ERROR_SET_FIFO_RATE         -8
-#define ERROR_SELF_TEST             -9
-#define ERROR_DMP_STATE             -10
-
-#define DEFAULT_MPU_HZ  100
-#define Q30  1073741824.0f
-
-/* The sensors can be mounted onto the board in any orientation. The mounting
- * matrix seen below tells the MPL how to rotate the raw data from thei
- * driver(s).
- * TODO: The following matrices refer to the configuration on an internal test
- * board at Invensense. If needed, please modify the matrices to match the
- * chip-to-body matrix for your particular set up.
- */
-/* (ʹAi׷һԭע)
- * κηװϡ
- * İװMPLδתԭʼݡ
- * TODO: ľָInvensenseڲ԰ϵá
- * Ҫ޸ľƥضõоƬ
-*/
-static signed char gyro_orientation[9] = {-1, 0, 0,
-                                           0,-1, 0,
-                                           0, 0, 1};
-
-/* These next two functions converts the orientation matrix (see
- * gyro_orientation) to a scalar representation for use by the DMP.
- * NOTE: These functions are borrowed from Invensense's MPL.
- */
-/* (ʹAi׷һԭע)
- * 󣨲μgyro_orientationתΪʾԹDMPʹá
- * עͣЩǴInvensenseMPLõġ
-*/
-static unsigned short inv_row_2_scale(const signed char *row)
-{
-    unsigned short b;
-
-    if (row[0] > 0)
-        b = 0;
-    else if (row[0] < 0)
-        b = 4;
-    else if (row[1] > 0)
-        b = 1;
-    else if (row[1] < 0)
-        b = 5;
-    else if (row[2] > 0)
-        b = 2;
-    else if (row[2] < 0)
-        b = 6;
-    else
-        b = 7;      // error
-    return b;
-}
-
-static unsigned short inv_orientation_matrix_to_scalar(
-    const signed char *mtx)
-{
-    unsigned short scalar;
-    /*
-       XYZ  010_001_000 Identity Matrix
-       XZY  001_010_000
-       YXZ  010_000_001
-       YZX  000_010_001
-       ZXY  001_000_010
-       ZYX  000_001_010
-     */
-    scalar = inv_row_2_scale(mtx);
-    scalar |= inv_row_2_scale(mtx + 3) << 3;
-    scalar |= inv_row_2_scale(mtx + 6) << 6;
-    return scalar;
-}
-
-/**
-  * @brief   Լ
-  * @param    
-  * @retval  void
- **/
-static int run_self_test(void)
-{
-    int result;
-    long gyro[3], accel[3];
-
-    result = mpu_run_self_test(gyro, accel);
-    if (result == 0x7) {
-        /* Test passed. We can trust the gyro data here, so let's push it down
-         * to the DMP.
-         */
-        float sens;
-        unsigned short accel_sens;
-        mpu_get_gyro_sens(&sens);
-        gyro[0] = (long)(gyro[0] * sens);
-        gyro[1] = (long)(gyro[1] * sens);
-        gyro[2] = (long)(gyro[2] * sens);
-        dmp_set_gyro_bias(gyro);
-        mpu_get_accel_sens(&accel_sens);
-        accel[0] *= accel_sens;
-        accel[1] *= accel_sens;
-        accel[2] *= accel_sens;
-        dmp_set_accel_bias(accel);
-    } else {
-        return -1;
-    }
-
-    return 0;
-}
-
-/**
-  * @brief   ʼMPU6050DMP
-  * @param    
-  * @retval  void
- **/
-int mpu_dmp_init(void)
-{
-    int ret;
-    struct int_param_s int_param;
-
-    ret = mpu_init(&int_param);
-    if(ret != 0)return ERROR_MPU_INIT;
-
-    //ô
-    ret = mpu_set_sensors(INV_XYZ_GYRO | INV_XYZ_ACCEL);
-    if(ret != 0)return ERROR_SET_SENSOR;
-    
-    //fifo
-    ret = mpu_configure_fifo(INV_XYZ_GYRO | INV_XYZ_ACCEL);
-    if(ret != 0)return ERROR_CONFIG_FIFO;
-    
-    //ò
-    ret = mpu_set_sample_rate(DEFAULT_MPU_HZ);
-    if(ret != 0)return ERROR_SET_RATE;
-    
-    //DMP̼
-    ret = dmp_load_motion_driver_firmware();
-    if(ret != 0)return ERROR_LOAD_MOTION_DRIVER;
-    
-    //Ƿ
-    ret = dmp_set_orientation(inv_orientation_matrix_to_scalar(gyro_orientation));
-    if(ret != 0)return ERROR_SET_ORIENTATION;
-    
-    //DMP
-    ret = dmp_enable_feature(DMP_FEATURE_6X_LP_QUAT | DMP_FEATURE_TAP |
-            DMP_FEATURE_ANDROID_ORIENT | DMP_FEATURE_SEND_RAW_ACCEL | 
-            DMP_FEATURE_SEND_CAL_GYRO | DMP_FEATURE_GYRO_CAL);
-    if(ret != 0)return ERROR_ENABLE_FEATURE;
-    
-    //
-    ret = dmp_set_fifo_rate(DEFAULT_MPU_HZ);
-    if(ret != 0)return ERROR_SET_FIFO_RATE;
-    
-    //Լ
-    ret = run_self_test();
-    if(ret != 0)return ERROR_SELF_TEST;
-    
-    //ʹDMP
-    ret = mpu_set_dmp_state(1);
-    if(ret != 0)return ERROR_DMP_STATE;
-    
-
-    return 0;
-}
-
-/**
-  * @brief   ȡԪֵõʵʵĽǶֵ
-  * @param    
-  * @retval  void
- **/
-int mpu_dmp_get_data(float *pitch, float *roll, float *yaw)
-{
-    float q0 = 1.0f, q1 = 0.0f, q2 = 0.0f, q3 = 0.0f;
-    short gyro[3];
-    short accel[3];
-    long quat[4];
-    unsigned long timestamp;
-    short sensors;
-    unsigned char more;
-    if(dmp_read_fifo(gyro, accel, quat, &timestamp, &sensors, &more))
-    {
-        return -1;
-    }
-
-    if(sensors & INV_WXYZ_QUAT)
-    {
-        q0 = quat[0] / Q30;
-        q1 = quat[1] / Q30;
-        q2 = quat[2] / Q30;
-        q3 = quat[3] / Q30;
-
-        *pitch = asin(-2 * q1 * q3 + 2 * q0 * q2) * 57.3; // pitch
-        *roll = atan2(2 * q2 * q3 + 2 * q0 * q1, -2 * q1 * q1 - 2 * q2 * q2 + 1) * 57.3; // roll
-        *yaw = atan2(2 * (q0 * q3 + q1 * q2), q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3) * 57.3; // yaw
-    }
-
-    return 0;
+#include "inv_mpu_stm32port.h"
+
+#include "inv_mpu.h"
+#include "inv_mpu_dmp_motion_driver.h"
+#include "FixedPoint.h"
+#include "FastTrig.h"
+#include "mpu6050.h"
+#include "stdio.h"
+#include <string.h>
+
+#define ERROR_MPU_INIT      -1
+#define ERROR_SET_SENSOR    -2
+#define ERROR_CONFIG_FIFO   -3
+#define ERROR_SET_RATE      -4
+#define ERROR_LOAD_MOTION_DRIVER    -5 
+#define ERROR_SET_ORIENTATION       -6
+#define ERROR_ENABLE_FEATURE        -7
+#define ERROR_SET_FIFO_RATE         -8
+#define ERROR_SELF_TEST             -9
+#define ERROR_DMP_STATE             -10
+
+#define DEFAULT_MPU_HZ  100
+#define DMP_FEATURES    (DMP_FEATURE_6X_LP_QUAT | DMP_FEATURE_TAP | \
+                         DMP_FEATURE_ANDROID_ORIENT | DMP_FEATURE_SEND_RAW_ACCEL | \
+                         DMP_FEATURE_SEND_CAL_GYRO | DMP_FEATURE_GYRO_CAL)
+
+/* The sensors can be mounted onto the board in any orientation. The mounting
+ * matrix seen below tells the MPL how to rotate the raw data from thei
+ * driver(s).
+ * TODO: The following matrices refer to the configuration on an internal test
+ * board at Invensense. If needed, please modify the matrices to match the
+ * chip-to-body matrix for your particular set up.
+ */
+/* (使用Ai简易翻译了一下原注释)
+ * 传感器可以以任何方向安装到板上。
+ * 下面的安装矩阵告诉MPL如何从驱动程序旋转原始数据。
+ * TODO: 下面的矩阵指的是Invensense内部测试板上的配置。
+ * 如果需要，请修改矩阵以匹配您特定设置的芯片到本体矩阵。
+*/
+static signed char gyro_orientation[9] = {-1, 0, 0,
+                                           0,-1, 0,
+                                           0, 0, 1};
+
+/* These next two functions converts the orientation matrix (see
+ * gyro_orientation) to a scalar representation for use by the DMP.
+ * NOTE: These functions are borrowed from Invensense's MPL.
+ */
+/* (使用Ai简易翻译了一下原注释)
+ * 以下这两个函数将方向矩阵（参见gyro_orientation）转换为标量表示，以供DMP使用。
+ * 注释：这些函数是从Invensense的MPL借用的。
+*/
+static unsigned short inv_row_2_scale(const signed char *row)
+{
+    unsigned short b;
+
+    if (row[0] > 0)
+        b = 0;
+    else if (row[0] < 0)
+        b = 4;
+    else if (row[1] > 0)
+        b = 1;
+    else if (row[1] < 0)
+        b = 5;
+    else if (row[2] > 0)
+        b = 2;
+    else if (row[2] < 0)
+        b = 6;
+    else
+        b = 7;      // error
+    return b;
+}
+
+static unsigned short inv_orientation_matrix_to_scalar(
+    const signed char *mtx)
+{
+    unsigned short scalar;
+    /*
+       XYZ  010_001_000 Identity Matrix
+       XZY  001_010_000
+       YXZ  010_000_001
+       YZX  000_010_001
+       ZXY  001_000_010
+       ZYX  000_001_010
+     */
+    scalar = inv_row_2_scale(mtx);
+    scalar |= inv_row_2_scale(mtx + 3) << 3;
+    scalar |= inv_row_2_scale(mtx + 6) << 6;
+    return scalar;
+}
+
+/**
+  * @brief   自检测试，通过后把零偏写入DMP
+  * @param   gyro accel 输出：写入DMP的零偏，供热启动记录保存
+  * @retval  0 通过 -1 失败
+ **/
+static int run_self_test(long *gyro, long *accel)
+{
+    int result;
+
+    result = mpu_run_self_test(gyro, accel);
+    if (result == 0x7) {
+        /* Test passed. We can trust the gyro data here, so let's push it down
+         * to the DMP.
+         */
+        float sens;
+        unsigned short accel_sens;
+        mpu_get_gyro_sens(&sens);
+        gyro[0] = (long)(gyro[0] * sens);
+        gyro[1] = (long)(gyro[1] * sens);
+        gyro[2] = (long)(gyro[2] * sens);
+        if (dmp_set_gyro_bias(gyro))
+            return -1;
+        mpu_get_accel_sens(&accel_sens);
+        accel[0] *= accel_sens;
+        accel[1] *= accel_sens;
+        accel[2] *= accel_sens;
+        if (dmp_set_accel_bias(accel))
+            return -1;
+    } else {
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+  * @brief   DMP配置的散列：采样率、安装方向、功能，任何一项改变都需要重新自检
+  * @param    
+  * @retval  散列值
+ **/
+static uint32_t dmp_cfg_hash(void)
+{
+    uint16_t cfg[3];
+    cfg[0] = DEFAULT_MPU_HZ;
+    cfg[1] = inv_orientation_matrix_to_scalar(gyro_orientation);
+    cfg[2] = DMP_FEATURES;
+    return mpu6050_warm_hash(cfg, sizeof(cfg));
+}
+
+/**
+  * @brief   初始化MPU6050的DMP相关配置
+  * @param    
+  * @retval  void
+ **/
+int mpu_dmp_init(void)
+{
+    int ret;
+    struct int_param_s int_param;
+    mpu6050_warm_t warm;
+    long gyro_bias[3], accel_bias[3];
+    uint8_t i, warm_ok;
+
+    //配置散列与保存的记录一致时为热启动：固件跳过回读校验，零偏直接装入，不再自检
+    warm_ok = mpu6050_warm_load(&warm) == 0 && warm.dmp_hash == dmp_cfg_hash();
+    mpu_set_load_verify(warm_ok ? MPU_LOAD_VERIFY_NONE : MPU_LOAD_VERIFY_READBACK);
+
+    ret = mpu_init(&int_param);
+    if(ret != 0)return ERROR_MPU_INIT;
+
+    //设置传感器
+    ret = mpu_set_sensors(INV_XYZ_GYRO | INV_XYZ_ACCEL);
+    if(ret != 0)return ERROR_SET_SENSOR;
+    
+    //设置fifo
+    ret = mpu_configure_fifo(INV_XYZ_GYRO | INV_XYZ_ACCEL);
+    if(ret != 0)return ERROR_CONFIG_FIFO;
+    
+    //设置采样率
+    ret = mpu_set_sample_rate(DEFAULT_MPU_HZ);
+    if(ret != 0)return ERROR_SET_RATE;
+    
+    //加载DMP固件
+    ret = dmp_load_motion_driver_firmware();
+    if(ret != 0)return ERROR_LOAD_MOTION_DRIVER;
+    
+    //设置陀螺仪方向
+    ret = dmp_set_orientation(inv_orientation_matrix_to_scalar(gyro_orientation));
+    if(ret != 0)return ERROR_SET_ORIENTATION;
+    
+    //设置DMP功能
+    ret = dmp_enable_feature(DMP_FEATURES);
+    if(ret != 0)return ERROR_ENABLE_FEATURE;
+    
+    //设置输出速率
+    ret = dmp_set_fifo_rate(DEFAULT_MPU_HZ);
+    if(ret != 0)return ERROR_SET_FIFO_RATE;
+    
+    if(warm_ok)
+    {
+        //装入上次自检得到的零偏；DMP_FEATURE_GYRO_CAL 会在静止8秒后在后台重新校准陀螺仪。
+        //限制：后台校准的结果只保存在DMP内部存储器中，motion driver 没有读出接口，
+        //因此记录中的DMP零偏不会像原始数据路径那样经 mpu6050_warm_commit 刷新，
+        //只在冷启动自检时更新；需要刷新时删除记录或修改配置（散列改变）即可触发重新自检
+        for(i = 0; i < 3; i++)
+        {
+            gyro_bias[i]  = warm.dmp_gyro_bias[i];
+            accel_bias[i] = warm.dmp_accel_bias[i];
+        }
+        //零偏写入失败时按冷启动处理
+        if(dmp_set_gyro_bias(gyro_bias) || dmp_set_accel_bias(accel_bias))
+            warm_ok = 0;
+    }
+    if(!warm_ok)
+    {
+        //自检（约数百毫秒），通过后保存零偏
+        ret = run_self_test(gyro_bias, accel_bias);
+        if(ret != 0)return ERROR_SELF_TEST;
+        warm.dmp_hash = dmp_cfg_hash();
+        for(i = 0; i < 3; i++)
+        {
+            warm.dmp_gyro_bias[i]  = gyro_bias[i];
+            warm.dmp_accel_bias[i] = accel_bias[i];
+        }
+        mpu6050_warm_save(&warm);
+    }
+    
+    //使能DMP
+    ret = mpu_set_dmp_state(1);
+    if(ret != 0)return ERROR_DMP_STATE;
+    
+
+    return 0;
+}
+
+/**
+  * @brief   读出FIFO中全部完整的DMP数据包，返回最新一包中的四元数
+  * @param   quat 四元数 w x y z
+  * @retval  0 成功 1 数据包中没有四元数（quat不变） -1 读取FIFO失败
+ **/
+int mpu_dmp_get_quat(float *quat)
+{
+    static struct dmp_packet_s pkt[DMP_BATCH_MAX];
+    long q[4];
+    unsigned char have = 0;
+    unsigned short more;
+    int n, got = 0;   //成功的突发读取次数
+    //每次突发读取最多 DMP_BATCH_MAX 包，FIFO中剩余的包继续读，避免积压溢出
+    do
+    {
+        n = dmp_read_fifo_batch(pkt, DMP_BATCH_MAX, &more);
+        if(n < 0)
+        {
+            break;
+        }
+        got++;
+        //整包都是损坏数据时 n 为0，FIFO已重新对齐，继续读剩余的包
+        if(n > 0 && (pkt[n - 1].sensors & INV_WXYZ_QUAT))
+        {
+            memcpy(q, pkt[n - 1].quat, sizeof(q));
+            have = 1;
+        }
+    }while(more);
+    if(got == 0)
+    {
+        return -1;
+    }
+    if(!have)
+    {
+        return 1;
+    }
+
+    //DMP输出Q30格式的四元数，乘常数代替浮点除法
+    quat[0] = q30_to_float(q[0]);
+    quat[1] = q30_to_float(q[1]);
+    quat[2] = q30_to_float(q[2]);
+    quat[3] = q30_to_float(q[3]);
+    return 0;
+}
+
+/**
+  * @brief   读取四元数值并计算得到实际的角度值
+  * @param    
+  * @retval  void
+ **/
+int mpu_dmp_get_data(float *pitch, float *roll, float *yaw)
+{
+    float quat[4];
+    float angle[3];
+    int ret = mpu_dmp_get_quat(quat);
+    if(ret < 0)
+    {
+        return -1;
+    }
+
+    if(ret == 0)
+    {
+        fast_euler(quat[0], quat[1], quat[2], quat[3], angle);
+        *roll  = angle[0];
+        *pitch = angle[1];
+        *yaw   = angle[2];
+    }
+
+    return 0;
 }
\ No newline at end of file
@@ -1,120 +1,546 @@
 #include "mpu6050.h"
 
 /********************User modification area begin********************/
-//ֻҪԼIIC滻ȥ
+//只需要将自己的IIC处理程序替换进去即可，或者在初始化前调用 mpu6050_set_bus 指定总线
 #include "main.h"
-#include "bsp_soft_i2c.h"
+#include "bus_ops.h"
 #include "bsp_delay.h"
+#include <string.h>
+
+#define MPU6050_DEFAULT_BUS()   bus_soft_i2c(SOFT_I2C1)
+
+//热启动：零偏保存在内部Flash保留页，0 关闭（每次上电都阻塞校准）
+#define MPU6050_WARM_START      1
+#include "bsp_flash.h"
+
 /**
-  * @brief   MPU6050ʱ
-  * @param   xms 
-  * @retval  0 ɹ 1 ʧ
+  * @brief   MPU6050的延时函数
+  * @param   xms 毫秒
+  * @retval  0 成功 1 失败
  **/
 void mpu6050_delay_ms(uint16_t xms)
 {
 	delay_ms(xms);
 }
+/*********************User modification area end**************/
+
+static const bus_t *mpu6050_bus = NULL;
+
+/*
+ * 寄存器影子缓存（写直达）
+ * 缓存 MPU_SAMPLE_RATE_REG ~ MPU_PWR_MGMT2_REG 之间的配置寄存器最近一次写入的值，
+ * 写入与缓存相同的值时直接跳过；相邻寄存器的批量写入只发送有变化的那一段。
+ * 带自清零位的寄存器（复位位）写入时总是发送，缓存中不保存这些位。
+ */
+#define MPU6050_SHADOW_BASE   MPU_SAMPLE_RATE_REG
+#define MPU6050_SHADOW_NUM    (MPU_PWR_MGMT2_REG - MPU_SAMPLE_RATE_REG + 1)
+
+static uint8_t mpu6050_shadow[MPU6050_SHADOW_NUM];
+static uint8_t mpu6050_shadow_valid[(MPU6050_SHADOW_NUM + 7) / 8];
+static mpu6050_shadow_stats_t mpu6050_shadow_stat;
+
+#define mpu6050_shadow_is_valid(reg)  (mpu6050_shadow_valid[((reg) - MPU6050_SHADOW_BASE) >> 3] &  (1 << (((reg) - MPU6050_SHADOW_BASE) & 7)))
+#define mpu6050_shadow_set_valid(reg) (mpu6050_shadow_valid[((reg) - MPU6050_SHADOW_BASE) >> 3] |= (1 << (((reg) - MPU6050_SHADOW_BASE) & 7)))
+#define mpu6050_shadow_clr_valid(reg) (mpu6050_shadow_valid[((reg) - MPU6050_SHADOW_BASE) >> 3] &= ~(1 << (((reg) - MPU6050_SHADOW_BASE) & 7)))
+
 /**
-  * @brief   MPU6050дһֽ
-  * @param   addr 豸ַ   reg Ĵַ   data д
-  * @retval  0 ɹ 1 ʧ
+  * @brief   判断寄存器是否可以缓存（配置类寄存器，读回值等于写入值）
+  * @param   reg 寄存器地址
+  * @retval  1 可以缓存 0 不可以
  **/
-int mpu6050_write_one_byte(uint8_t addr,uint8_t reg,uint8_t data)
+static uint8_t mpu6050_reg_cacheable(uint8_t reg)
 {
-	//u_i2c1_write_byte(addr,reg,&data);
-	soft_i2c_write_dev_one_byte(SOFT_I2C1,addr,reg,data);
-	
-	return 0;
+	switch(reg)
+	{
+		case MPU_SAMPLE_RATE_REG: case MPU_CFG_REG: case MPU_GYRO_CFG_REG: case MPU_ACCEL_CFG_REG:
+		case MPU_MOTION_DET_REG: case MPU_FIFO_EN_REG: case MPU_INTBP_CFG_REG: case MPU_INT_EN_REG:
+		case MPU_I2CMST_DELAY_REG: case MPU_MDETECT_CTRL_REG:
+		case MPU_USER_CTRL_REG: case MPU_PWR_MGMT1_REG: case MPU_PWR_MGMT2_REG:
+			return 1;
+		default:
+			return reg >= MPU_I2CMST_CTRL_REG && reg <= MPU_I2CSLV4_CTRL_REG;
+	}
 }
 
 /**
-  * @brief   MPU6050дֽ
-  * @param   addr 豸ַ   reg Ĵַ   data д
-  * @retval  0 ɹ 1 ʧ
+  * @brief   寄存器中写1后自动清零的位
+  * @param   reg 寄存器地址
+  * @retval  自清零位掩码
  **/
-int mpu6050_write_bytes(uint8_t addr,uint8_t reg,uint8_t len,uint8_t *data)
+static uint8_t mpu6050_reg_selfclear(uint8_t reg)
 {
-	//u_i2c1_write_bytes(addr, reg, data ,len);
-	soft_i2c_write_dev_len_byte(SOFT_I2C1,addr, reg, len, data);
+	if(reg == MPU_USER_CTRL_REG) return 0x0F;   //DMP_RESET FIFO_RESET I2C_MST_RESET SIG_COND_RESET
+	if(reg == MPU_PWR_MGMT1_REG) return 0x80;   //DEVICE_RESET
 	return 0;
 }
+
 /**
-  * @brief   MPU6050Ķȡһֽ
-  * @param   addr 豸ַ   reg Ĵַ   data ȡ
-  * @retval  0 ɹ 1 ʧ
+  * @brief   器件复位后，缓存填入数据手册给出的复位值
+  * @param   
+  * @retval  
  **/
-int mpu6050_read_one_byte(uint8_t addr,uint8_t reg,uint8_t *data)
+static void mpu6050_shadow_reset_defaults(void)
 {
-	//u_i2c1_read_byte(addr,reg,data);
-	soft_i2c_read_dev_one_byte(SOFT_I2C1,addr,reg,data);
-	return 0;
+	uint8_t reg;
+	memset(mpu6050_shadow, 0, sizeof(mpu6050_shadow));
+	memset(mpu6050_shadow_valid, 0, sizeof(mpu6050_shadow_valid));
+	for(reg = MPU6050_SHADOW_BASE; reg <= MPU_PWR_MGMT2_REG; reg++)
+	{
+		if(mpu6050_reg_cacheable(reg))
+			mpu6050_shadow_set_valid(reg);
+	}
+	mpu6050_shadow[MPU_PWR_MGMT1_REG - MPU6050_SHADOW_BASE] = 0x40;   //复位后处于睡眠状态
 }
+
 /**
-  * @brief   MPU6050Ķȡֽ
-  * @param   addr 豸ַ   reg Ĵַ   data ȡݻ   len ȡݳ
-  * @retval  0 ɹ 1 ʧ
+  * @brief   写入成功/失败后更新缓存
+  * @param   reg 起始寄存器   len 长度   data 写入的数据   ok 写入是否成功
+  * @retval  
  **/
-int mpu6050_read_bytes(uint8_t addr,uint8_t reg,uint8_t len,uint8_t *data)
+static void mpu6050_shadow_update(uint8_t reg,uint16_t len,const uint8_t *data,uint8_t ok)
 {
-	//u_i2c1_read_bytes(addr,reg,data,len); 
-//	for(int i = 0;i<len;i++)
-//	{
-//		soft_i2c_read_dev_one_byte(SOFT_I2C1,addr,reg+i,&data[i]);
-//	}
-//	soft_i2c_read_dev_len_byte(SOFT_I2C1,addr,reg,len,data);
-	soft_i2c_read_dev_len_byte(SOFT_I2C1,addr,reg,len,data);
-	return 0;
+	uint16_t i, r;
+	for(i = 0; i < len; i++)
+	{
+		r = reg + i;
+		if(r > MPU_PWR_MGMT2_REG)
+			break;                         //DMP存储区、FIFO等突发写入不会越过缓存区
+		if(r < MPU6050_SHADOW_BASE || !mpu6050_reg_cacheable(r))
+			continue;
+		if(!ok)
+		{
+			mpu6050_shadow_clr_valid(r);   //不确定器件里的值，下次必须重新写入
+		}
+		else if(r == MPU_PWR_MGMT1_REG && (data[i] & 0x80))
+		{
+			mpu6050_shadow_reset_defaults();
+			return;
+		}
+		else
+		{
+			mpu6050_shadow[r - MPU6050_SHADOW_BASE] = data[i] & ~mpu6050_reg_selfclear(r);
+			mpu6050_shadow_set_valid(r);
+		}
+	}
 }
 
-/*********************User modification area end**************/
+/**
+  * @brief   判断写入是否可以跳过
+  * @param   reg 寄存器地址   data 待写入的值
+  * @retval  1 缓存中已是该值，可以跳过
+ **/
+static uint8_t mpu6050_shadow_hit(uint8_t reg,uint8_t data)
+{
+	if(reg < MPU6050_SHADOW_BASE || reg > MPU_PWR_MGMT2_REG || !mpu6050_reg_cacheable(reg))
+		return 0;
+	if(data & mpu6050_reg_selfclear(reg))
+		return 0;
+	return mpu6050_shadow_is_valid(reg) && mpu6050_shadow[reg - MPU6050_SHADOW_BASE] == data;
+}
+
+/**
+  * @brief   清空寄存器缓存（器件被其他途径修改、掉电等情况下调用）
+  * @param   
+  * @retval  
+ **/
+void mpu6050_shadow_invalidate(void)
+{
+	memset(mpu6050_shadow_valid, 0, sizeof(mpu6050_shadow_valid));
+}
+
+/**
+  * @brief   读回缓存中的寄存器并与缓存比较
+  * @param   
+  * @retval  不一致的寄存器个数（缓存已按读回值修正），-1 总线错误
+ **/
+int mpu6050_shadow_verify(void)
+{
+	uint8_t buf[16];
+	const uint8_t max = sizeof(buf);
+	uint8_t reg, end, i, r, mask;
+	int bad = 0;
+
+	reg = MPU6050_SHADOW_BASE;
+	while(reg <= MPU_PWR_MGMT2_REG)
+	{
+		if(!mpu6050_shadow_is_valid(reg))
+		{
+			reg++;
+			continue;
+		}
+		//连续有效的寄存器一次读回
+		for(end = reg; end < MPU_PWR_MGMT2_REG && (uint8_t)(end - reg + 1) < max && mpu6050_shadow_is_valid(end + 1); end++);
+		if(mpu6050_read_bytes(MPU6050_ADDR,reg,end - reg + 1,buf))
+			return -1;
+		for(i = 0; i <= end - reg; i++)
+		{
+			r = reg + i;
+			mask = ~mpu6050_reg_selfclear(r);
+			if((buf[i] & mask) != mpu6050_shadow[r - MPU6050_SHADOW_BASE])
+			{
+				mpu6050_shadow[r - MPU6050_SHADOW_BASE] = buf[i] & mask;
+				bad++;
+			}
+		}
+		reg = end + 1;
+	}
+	mpu6050_shadow_stat.verify_fail += bad;
+	return bad;
+}
+
+/**
+  * @brief   获取缓存统计
+  * @param   
+  * @retval  统计结构体指针
+ **/
+const mpu6050_shadow_stats_t *mpu6050_shadow_get_stats(void)
+{
+	return &mpu6050_shadow_stat;
+}
+
+/**
+  * @brief   指定MPU6050所在的总线
+  * @param   bus 总线实例（bus_soft_i2c / bus_hard_i2c / bus_i2c_queue 或自定义实现）
+  * @retval  
+ **/
+void mpu6050_set_bus(const bus_t *bus)
+{
+	mpu6050_bus = bus;
+	mpu6050_shadow_invalidate();
+}
+
+/**
+  * @brief   获取MPU6050所在的总线，未指定时使用默认总线
+  * @param   
+  * @retval  总线实例
+ **/
+const bus_t *mpu6050_get_bus(void)
+{
+	if(mpu6050_bus == NULL)
+		mpu6050_bus = MPU6050_DEFAULT_BUS();
+	return mpu6050_bus;
+}
+
+/**
+  * @brief   MPU6050的写入一个字节（经过寄存器缓存，与缓存相同的值不再写入）
+  * @param   addr 设备地址   reg 寄存器地址   data 写入的数据
+  * @retval  0 成功 其他 总线错误码
+ **/
+int mpu6050_write_one_byte(uint8_t addr,uint8_t reg,uint8_t data)
+{
+	if(addr == MPU6050_ADDR && mpu6050_shadow_hit(reg,data))
+	{
+		mpu6050_shadow_stat.skipped++;
+		return 0;
+	}
+	return mpu6050_write_bytes(addr,reg,1,&data);
+}
+
+/**
+  * @brief   MPU6050的写入多个字节（总是写入，写入后更新寄存器缓存）
+  * @note    eMPL 通过该函数访问器件
+  * @param   addr 设备地址   reg 寄存器地址   data 写入的数据
+  * @retval  0 成功 其他 总线错误码
+ **/
+int mpu6050_write_bytes(uint8_t addr,uint8_t reg,uint16_t len,const uint8_t *data)
+{
+	int res = bus_write_reg(mpu6050_get_bus(),addr,reg,data,len);
+	if(addr == MPU6050_ADDR)
+	{
+		mpu6050_shadow_stat.writes++;
+		mpu6050_shadow_update(reg,len,data,res == 0);
+	}
+	return res;
+}
+
+/**
+  * @brief   MPU6050连续配置寄存器批量写入（经过寄存器缓存）
+  * @note    只发送第一个与最后一个有变化的寄存器之间的一段，全部相同时不产生总线传输
+  * @param   reg 起始寄存器地址   len 寄存器个数   data 写入的数据
+  * @retval  0 成功 其他 总线错误码
+ **/
+int mpu6050_write_regs(uint8_t reg,uint8_t len,const uint8_t *data)
+{
+	int first = -1, last = -1, i;
+
+	for(i = 0; i < len; i++)
+	{
+		if(!mpu6050_shadow_hit(reg + i,data[i]))
+		{
+			if(first < 0) first = i;
+			last = i;
+		}
+	}
+	if(first < 0)
+	{
+		mpu6050_shadow_stat.skipped += len;
+		return 0;
+	}
+	mpu6050_shadow_stat.skipped += len - (last - first + 1);
+	return mpu6050_write_bytes(MPU6050_ADDR,reg + first,last - first + 1,data + first);
+}
+/**
+  * @brief   MPU6050的读取一个字节数据
+  * @param   addr 设备地址   reg 寄存器地址   data 读取的数据
+  * @retval  0 成功 其他 总线错误码
+ **/
+int mpu6050_read_one_byte(uint8_t addr,uint8_t reg,uint8_t *data)
+{
+	return bus_read_reg(mpu6050_get_bus(),addr,reg,data,1);
+}
+/**
+  * @brief   MPU6050的读取多个字节数据
+  * @param   addr 设备地址   reg 寄存器地址   data 读取的数据缓存   len 读取的数据长度
+  * @retval  0 成功 其他 总线错误码
+ **/
+int mpu6050_read_bytes(uint8_t addr,uint8_t reg,uint16_t len,uint8_t *data)
+{
+	return bus_read_reg(mpu6050_get_bus(),addr,reg,data,len);
+}
 
 float gyro_offset[3] = {0,0,0};
 
+/* 热启动记录标签 "MPU1"，记录格式改变时修改末尾的版本号 */
+#define MPU6050_WARM_TAG          0x3155504D
+
+/* 后台校准 */
+#define MPU6050_CAL_SAMPLES       100   //平均的采样数，与 mpu_calibration 相同
+#define MPU6050_CAL_STILL         50    //静止判据：窗口内每轴原始值的最大波动（LSB），超过则重新开始
+#define MPU6050_CAL_SAVE_DELTA    3     //零偏变化超过该值（LSB）才重写Flash，减少擦写次数
+
+static struct {
+	int32_t sum[3];
+	int16_t min[3];
+	int16_t max[3];
+	uint16_t n;
+	uint8_t active;
+}mpu6050_cal;
+static volatile uint8_t mpu6050_warm_pending = 0;   //后台校准得到新零偏，等待 mpu6050_warm_commit 写入Flash
+
+/* FIFO模式 */
+#define MPU6050_FIFO_EN_ACC_GYRO   0x78   //XG_FIFO_EN YG_FIFO_EN ZG_FIFO_EN ACCEL_FIFO_EN
+#define MPU6050_USER_FIFO_EN       0x40
+#define MPU6050_USER_FIFO_RESET    0x04
+#define MPU6050_INT_FIFO_OFLOW     0x10
+#define MPU6050_INT_DATA_RDY       0x01
+
+static uint32_t mpu6050_fifo_period = 0;   //数据包间隔（us），0表示未开启FIFO模式
+static mpu6050_fifo_stats_t mpu6050_fifo_stat;
+
+/**
+  * @brief   读取热启动记录
+  * @param   w 记录
+  * @retval  0 成功 1 没有有效记录（w清零）
+ **/
+uint8_t mpu6050_warm_load(mpu6050_warm_t *w)
+{
+#if MPU6050_WARM_START
+	if(flash_store_read(MPU6050_WARM_TAG,w,sizeof(*w)) == FLASH_STORE_OK)
+		return 0;
+#endif
+	memset(w,0,sizeof(*w));
+	return 1;
+}
+
+/**
+  * @brief   保存热启动记录（内容不变时不擦写Flash）
+  * @param   w 记录
+  * @retval  0 成功 1 失败或未开启
+ **/
+uint8_t mpu6050_warm_save(const mpu6050_warm_t *w)
+{
+#if MPU6050_WARM_START
+	return flash_store_write(MPU6050_WARM_TAG,w,sizeof(*w)) == FLASH_STORE_OK ? 0 : 1;
+#else
+	(void)w;
+	return 1;
+#endif
+}
+
+/**
+  * @brief   计算配置参数的散列
+  * @param   cfg 配置参数   len 字节数
+  * @retval  散列值，不会为0
+ **/
+uint32_t mpu6050_warm_hash(const void *cfg, uint16_t len)
+{
+	return flash_store_crc32(cfg,len) | 1;
+}
+
+/**
+  * @brief   原始数据配置的散列：SMPLRT_DIV CONFIG GYRO_CONFIG ACCEL_CONFIG 的缓存值
+  * @param   
+  * @retval  散列值，任何一个寄存器的缓存无效时为0（按冷启动处理）
+ **/
+static uint32_t mpu6050_raw_hash(void)
+{
+	uint8_t reg;
+	for(reg = MPU_SAMPLE_RATE_REG; reg <= MPU_ACCEL_CFG_REG; reg++)
+	{
+		if(!mpu6050_shadow_is_valid(reg))
+			return 0;
+	}
+	return mpu6050_warm_hash(&mpu6050_shadow[MPU_SAMPLE_RATE_REG - MPU6050_SHADOW_BASE],4);
+}
+
+/**
+  * @brief   把当前陀螺仪零偏写入热启动记录，记录中的DMP部分保持不变
+  * @param   
+  * @retval  
+ **/
+static void mpu6050_warm_store_offset(void)
+{
+	mpu6050_warm_t w;
+	mpu6050_warm_load(&w);
+	w.raw_hash = mpu6050_raw_hash();
+	w.gyro_offset[0] = (int16_t)gyro_offset[0];
+	w.gyro_offset[1] = (int16_t)gyro_offset[1];
+	w.gyro_offset[2] = (int16_t)gyro_offset[2];
+	mpu6050_warm_save(&w);
+}
+
+/**
+  * @brief   开始一轮后台校准
+  * @param   
+  * @retval  
+ **/
+static void mpu6050_cal_start(void)
+{
+	memset(&mpu6050_cal,0,sizeof(mpu6050_cal));
+	mpu6050_cal.active = 1;
+}
+
+/**
+  * @brief   后台校准：累加未减零偏的陀螺仪原始值，静止满一个窗口后更新零偏
+  * @note    在解析采样帧时调用（可能在中断上下文中）；零偏明显变化时只置位保存标志，
+  *          擦写Flash（约20ms）由应用在实时路径之外调用 mpu6050_warm_commit 完成
+  * @param   gyro 陀螺仪原始值
+  * @retval  
+ **/
+static void mpu6050_cal_feed(const int16_t *gyro)
+{
+	uint8_t i, changed = 0;
+	int16_t offset;
+	for(i = 0; i < 3; i++)
+	{
+		if(mpu6050_cal.n == 0 || gyro[i] < mpu6050_cal.min[i]) mpu6050_cal.min[i] = gyro[i];
+		if(mpu6050_cal.n == 0 || gyro[i] > mpu6050_cal.max[i]) mpu6050_cal.max[i] = gyro[i];
+		mpu6050_cal.sum[i] += gyro[i];
+	}
+	if(++mpu6050_cal.n < MPU6050_CAL_SAMPLES)
+		return;
+	for(i = 0; i < 3; i++)
+	{
+		if(mpu6050_cal.max[i] - mpu6050_cal.min[i] > MPU6050_CAL_STILL)
+		{
+			mpu6050_cal_start();   //窗口内有运动，重新开始
+			return;
+		}
+	}
+	for(i = 0; i < 3; i++)
+	{
+		offset = (int16_t)(mpu6050_cal.sum[i] / MPU6050_CAL_SAMPLES);
+		if(offset - (int16_t)gyro_offset[i] > MPU6050_CAL_SAVE_DELTA || (int16_t)gyro_offset[i] - offset > MPU6050_CAL_SAVE_DELTA)
+			changed = 1;
+		gyro_offset[i] = offset;
+	}
+	mpu6050_cal.active = 0;
+	if(changed)
+		mpu6050_warm_pending = 1;
+}
+
+/**
+  * @brief   把后台校准得到的新零偏写入热启动记录
+  * @note    擦写Flash期间CPU停顿约20ms，应在打印等非实时路径中调用，不能在中断中调用
+  * @param   
+  * @retval  1 写入了记录 0 没有待保存的零偏
+ **/
+uint8_t mpu6050_warm_commit(void)
+{
+	if(!mpu6050_warm_pending)
+		return 0;
+	mpu6050_warm_pending = 0;
+	mpu6050_warm_store_offset();
+	return 1;
+}
+
+/**
+  * @brief   后台校准是否还在进行
+  * @param   
+  * @retval  1 进行中（当前零偏来自热启动记录） 0 已完成
+ **/
+uint8_t mpu6050_calib_busy(void)
+{
+	return mpu6050_cal.active;
+}
+
 /**
-  * @brief   MPU6050ĳʼ
+  * @brief   热启动：配置与记录一致时装入保存的零偏，并启动后台校准
   * @param   
-  * @retval  0 ɹ 1 ʧ
+  * @retval  0 已装入 1 没有可用的记录，需要阻塞校准
+ **/
+static uint8_t mpu6050_warm_start(void)
+{
+	mpu6050_warm_t w;
+	uint32_t hash = mpu6050_raw_hash();
+	if(hash == 0 || mpu6050_warm_load(&w) || w.raw_hash != hash)
+		return 1;
+	gyro_offset[0] = w.gyro_offset[0];
+	gyro_offset[1] = w.gyro_offset[1];
+	gyro_offset[2] = w.gyro_offset[2];
+	mpu6050_cal_start();
+	return 0;
+}
+
+/**
+  * @brief   MPU6050的初始化
+  * @param   
+  * @retval  0 成功 1 失败
  **/
 int mpu6050_init()
 {
 	uint8_t res = 0;
+	//复位后缓存自动装入复位值，之后与复位值相同的写入（USER_CTRL、FIFO_EN、PWR_MGMT2等）都会被跳过
+	mpu6050_fifo_period = 0;
 	mpu6050_write_one_byte(MPU6050_ADDR,MPU_PWR_MGMT1_REG,0X80); 
     mpu6050_delay_ms(100);  
-    mpu6050_write_one_byte(MPU6050_ADDR,MPU_PWR_MGMT1_REG,0X00); 
-    mpu6050_set_gyro_fsr(GYRO_2000DPS);					        	
-    mpu6050_set_acc_fsr(ACC_2G);					       	 	
-    mpu6050_set_rate(100);						       	 	
+    mpu6050_read_one_byte (MPU6050_ADDR,MPU_DEVICE_ID_REG,&res); 
+    if(res!=MPU6050_ADDR)
+        return 1;
+    mpu6050_write_one_byte(MPU6050_ADDR,MPU_PWR_MGMT1_REG,0X01);      //唤醒，时钟选择X轴陀螺仪
+    mpu6050_config(100,MPU6050_GYRO_FSR,MPU6050_ACC_FSR);                        //采样率、低通、量程一次写入
+    mpu6050_write_one_byte(MPU6050_ADDR,MPU_INTBP_CFG_REG,0X9C); 
     mpu6050_write_one_byte(MPU6050_ADDR,MPU_INT_EN_REG,0X01);    
     mpu6050_write_one_byte(MPU6050_ADDR,MPU_USER_CTRL_REG,0X00); 
     mpu6050_write_one_byte(MPU6050_ADDR,MPU_FIFO_EN_REG,0X00);	  
-    mpu6050_write_one_byte(MPU6050_ADDR,MPU_INTBP_CFG_REG,0X9C); 
-    mpu6050_read_one_byte (MPU6050_ADDR,MPU_DEVICE_ID_REG,&res); 
-    if(res==MPU6050_ADDR)  
-    {
-        mpu6050_write_one_byte(MPU6050_ADDR,MPU_PWR_MGMT1_REG,0X01);  	 
-        mpu6050_write_one_byte(MPU6050_ADDR,MPU_PWR_MGMT2_REG,0X00);  	 
-        mpu6050_set_rate(100);						       	 
-    } else return 1;
-	mpu_calibration();
+    mpu6050_write_one_byte(MPU6050_ADDR,MPU_PWR_MGMT2_REG,0X00);  	 
+	if(mpu6050_warm_start())
+	{
+		mpu_calibration();
+		mpu6050_warm_store_offset();
+	}
     return 0;
 }
 
 /**
-  * @brief   ôĳʼУ׼
+  * @brief   设置传感器的初始化校准
   * @param    
-  * @retval  óɹ
+  * @retval  设置成功与否
  **/
 void mpu_calibration()
 {
 	int32_t sum_gx = 0, sum_gy = 0, sum_gz = 0;
     int16_t gx, gy, gz;
+	//mpu6050_get_gyro 会减去零偏，先清零；同时停止后台校准
+	mpu6050_cal.active = 0;
+	gyro_offset[0] = gyro_offset[1] = gyro_offset[2] = 0;
     for (int i = 0; i < 100; i++)
     {
         mpu6050_get_gyro(&gx, &gy, &gz);
         sum_gx += gx;
         sum_gy += gy;
         sum_gz += gz;
-        mpu6050_delay_ms(10); // ΢ʱȷȶ
+        mpu6050_delay_ms(10); // 稍微延时，确保数据稳定
     }
     gyro_offset[0] = sum_gx / 100;
     gyro_offset[1] = sum_gy / 100;
@@ -122,60 +548,85 @@ void mpu_calibration()
 }
 
 /**
-  * @brief   Ǵ̷Χ
+  * @brief   设置陀螺仪传感器满量程范围
   * @param   fsr GYRO_2000DPS GYRO_1000DPS GYRO_500DPS GYRO_250DPS 
-  * @retval  óɹ
+  * @retval  设置成功与否
  **/
 uint8_t mpu6050_set_gyro_fsr(uint8_t fsr)
 {
-    return mpu6050_write_one_byte(MPU6050_ADDR,MPU_GYRO_CFG_REG,(fsr<<3)|3);//̷Χ
+    return mpu6050_write_one_byte(MPU6050_ADDR,MPU_GYRO_CFG_REG,(fsr<<3)|3);//设置陀螺仪满量程范围
 }
 
 /**
-  * @brief   üٶȴ̷Χ
+  * @brief   设置加速度传感器满量程范围
   * @param   fsr ACC_16G ACC_8G ACC_4G ACC_2G 
-  * @retval  óɹ
+  * @retval  设置成功与否
  **/
 uint8_t mpu6050_set_acc_fsr(uint8_t fsr)
 {
-    return mpu6050_write_one_byte(MPU6050_ADDR,MPU_ACCEL_CFG_REG,fsr<<3);//üٶȴ̷Χ
+    return mpu6050_write_one_byte(MPU6050_ADDR,MPU_ACCEL_CFG_REG,fsr<<3);//设置加速度传感器满量程范围
+}
+
+/**
+  * @brief   低通滤波器截止频率换算为 DLPF_CFG 配置值
+  * @param   lpf 截止频率(Hz)
+  * @retval  DLPF_CFG
+ **/
+static uint8_t mpu6050_lpf_code(uint16_t lpf)
+{
+    if(lpf>=188)return 1;
+    else if(lpf>=98)return 2;
+    else if(lpf>=42)return 3;
+    else if(lpf>=20)return 4;
+    else if(lpf>=10)return 5;
+    else return 6;
 }
 
 /**
-  * @brief   ֵͨ˲
+  * @brief   设置数字低通滤波器
   * @param   lpf 
-  * @retval  óɹ
+  * @retval  设置成功与否
  **/
 uint8_t mpu6050_set_lpf(uint16_t lpf)
 {
-    uint8_t data=0;
-    if(lpf>=188)data=1;
-    else if(lpf>=98)data=2;
-    else if(lpf>=42)data=3;
-    else if(lpf>=20)data=4;
-    else if(lpf>=10)data=5;
-    else data=6;
-    return mpu6050_write_one_byte(MPU6050_ADDR,MPU_CFG_REG,data);//ֵͨ˲
+    return mpu6050_write_one_byte(MPU6050_ADDR,MPU_CFG_REG,mpu6050_lpf_code(lpf));//设置数字低通滤波器
 }
 
 /**
-  * @brief   MPU6050Ĳ
+  * @brief   设置MPU6050的采样率
   * @param   rate 
-  * @retval  óɹ
+  * @retval  设置成功与否
  **/
 uint8_t mpu6050_set_rate(uint16_t rate)
 {
-    uint8_t data;
+    uint8_t data[2];
     if(rate>1000)rate=1000;
     if(rate<4)rate=4;
-    data=1000/rate-1;
-    data=mpu6050_write_one_byte(MPU6050_ADDR,MPU_SAMPLE_RATE_REG,data);	//ֵͨ˲
-    return mpu6050_set_lpf(rate/2);	//ԶLPFΪʵһ
+    data[0]=1000/rate-1;                  //采样频率分频
+    data[1]=mpu6050_lpf_code(rate/2);     //自动设置LPF为采样率的一半
+    return mpu6050_write_regs(MPU_SAMPLE_RATE_REG,2,data);
 }
+
 /**
-  * @brief   ¶ֵ
+  * @brief   一次设置采样率、低通滤波器和量程（0x19~0x1C 相邻寄存器合并为一次写入）
+  * @param   rate 采样率(4~1000Hz)   gyro_fsr 陀螺仪量程   acc_fsr 加速度计量程
+  * @retval  设置成功与否
+ **/
+uint8_t mpu6050_config(uint16_t rate,uint8_t gyro_fsr,uint8_t acc_fsr)
+{
+    uint8_t data[4];
+    if(rate>1000)rate=1000;
+    if(rate<4)rate=4;
+    data[0]=1000/rate-1;
+    data[1]=mpu6050_lpf_code(rate/2);
+    data[2]=(gyro_fsr<<3)|3;
+    data[3]=acc_fsr<<3;
+    return mpu6050_write_regs(MPU_SAMPLE_RATE_REG,4,data);
+}
+/**
+  * @brief   获得陀螺仪温度值
   * @param    
-  * @retval  ¶
+  * @retval  陀螺仪温度
  **/
 short mpu6050_get_temperature(void)
 {
@@ -186,9 +637,9 @@ short mpu6050_get_temperature(void)
     return raw;
 }
 /**
-  * @brief   ǽٶֵ
-  * @param   ȡٶȵĵַ
-  * @retval  0 ȷȡ 1 IICȡʧ 2 ָΪ 
+  * @brief   获得陀螺仪角速度值
+  * @param   传入存取角速度的地址
+  * @retval  0 正确读取 1 IIC读取失败 2 传入指针为空 
  **/
 uint8_t mpu6050_get_gyro(int16_t *gx,int16_t *gy,int16_t *gz)
 {
@@ -209,9 +660,9 @@ uint8_t mpu6050_get_gyro(int16_t *gx,int16_t *gy,int16_t *gz)
     return res;
 }
 /**
-  * @brief   Ǽٶȼֵ
-  * @param   ȡٶȵĵַ
-  * @retval  0 ȷȡ 1 IICȡʧ 2 ָΪ 
+  * @brief   获得陀螺仪加速度计值
+  * @param   传入存取加速度的地址
+  * @retval  0 正确读取 1 IIC读取失败 2 传入指针为空 
  **/
 uint8_t mpu6050_get_acc(int16_t *ax,int16_t *ay,int16_t *az)
 {
@@ -228,3 +679,193 @@ uint8_t mpu6050_get_acc(int16_t *ax,int16_t *ay,int16_t *az)
     return res;
 }
 
+/**
+  * @brief   解析一帧原始数据（大端），陀螺仪减去零偏；后台校准进行中时顺便累加
+  * @param   raw 从 MPU_ACCEL_XOUTH_REG 开始的14字节   frame 解析结果
+  * @retval  
+ **/
+void mpu6050_decode_frame(const uint8_t *raw,mpu6050_frame_t *frame)
+{
+    frame->acc[0]  = (int16_t)(((uint16_t)raw[0]<<8)|raw[1]);
+    frame->acc[1]  = (int16_t)(((uint16_t)raw[2]<<8)|raw[3]);
+    frame->acc[2]  = (int16_t)(((uint16_t)raw[4]<<8)|raw[5]);
+    frame->temp    = (int16_t)(((uint16_t)raw[6]<<8)|raw[7]);
+    frame->gyro[0] = (int16_t)(((uint16_t)raw[8]<<8)|raw[9]);
+    frame->gyro[1] = (int16_t)(((uint16_t)raw[10]<<8)|raw[11]);
+    frame->gyro[2] = (int16_t)(((uint16_t)raw[12]<<8)|raw[13]);
+
+    if(mpu6050_cal.active)
+        mpu6050_cal_feed(frame->gyro);
+    frame->gyro[0] -= gyro_offset[0];
+    frame->gyro[1] -= gyro_offset[1];
+    frame->gyro[2] -= gyro_offset[2];
+}
+
+/**
+  * @brief   一次突发读取加速度、温度、角速度
+  * @note    与分别调用 mpu6050_get_acc / mpu6050_get_gyro 相比只有一次总线传输，
+  *          并且三组数据来自同一个采样周期（器件在突发读取期间不会更新输出寄存器）
+  * @param   frame 采样帧
+  * @retval  0 正确读取 其他 总线错误码 2 传入指针为空
+ **/
+uint8_t mpu6050_read_frame(mpu6050_frame_t *frame)
+{
+    uint8_t raw[MPU6050_FRAME_LEN];
+    int res;
+	if(frame == NULL)
+		return 2;
+    frame->timestamp = bus_timestamp_us(mpu6050_get_bus());
+    res = mpu6050_read_bytes(MPU6050_ADDR,MPU_ACCEL_XOUTH_REG,MPU6050_FRAME_LEN,raw);
+    if(res == 0)
+        mpu6050_decode_frame(raw,frame);
+    return (uint8_t)res;
+}
+
+/**
+  * @brief   启动一次异步突发读取（0x3B~0x48），可以在数据就绪中断中调用
+  * @note    硬件I2C总线在后台完成传输，软件I2C总线退化为同步读取并在返回前回调；
+  *          完成后用 mpu6050_decode_frame 解析 raw
+  * @param   raw 接收缓冲区，至少 MPU6050_FRAME_LEN 字节，完成前必须保持有效
+  *          done 完成回调（可能在中断上下文中执行）   arg 回调参数
+  * @retval  0 已提交 其他 总线错误码，不会回调
+ **/
+int mpu6050_read_frame_async(uint8_t *raw,bus_done_cb_t done,void *arg)
+{
+    return bus_read_reg_async(mpu6050_get_bus(),MPU6050_ADDR,MPU_ACCEL_XOUTH_REG,raw,MPU6050_FRAME_LEN,done,arg);
+}
+
+/**
+  * @brief   复位FIFO并重新开启，FIFO中的数据全部丢弃
+  * @note    FIFO_RESET 只能在 FIFO_EN 清零时写入；同时读一次中断状态清除溢出标志
+  * @param   
+  * @retval  0 成功 其他 总线错误码
+ **/
+uint8_t mpu6050_fifo_reset(void)
+{
+    uint8_t status;
+    int res;
+    res  = mpu6050_write_one_byte(MPU6050_ADDR,MPU_USER_CTRL_REG,MPU6050_USER_FIFO_RESET);
+    res |= mpu6050_read_one_byte(MPU6050_ADDR,MPU_INT_STA_REG,&status);
+    res |= mpu6050_write_one_byte(MPU6050_ADDR,MPU_USER_CTRL_REG,MPU6050_USER_FIFO_EN);
+    return (uint8_t)res;
+}
+
+/**
+  * @brief   开启FIFO模式：加速度和角速度按采样率写入1KB FIFO，每个数据包12字节
+  * @note    开启后不再需要每个采样周期访问一次总线，可以隔一段时间调用 mpu6050_fifo_read 一次取出全部数据；
+  *          FIFO在约 1024/12/rate 秒后溢出（100Hz时约0.85s），读取间隔必须小于该时间
+  * @param   rate 采样率(4~1000Hz)
+  * @retval  0 成功 其他 总线错误码
+ **/
+uint8_t mpu6050_fifo_enable(uint16_t rate)
+{
+    uint8_t res;
+    if(rate>1000)rate=1000;
+    if(rate<4)rate=4;
+    mpu6050_fifo_period = 0;
+    res  = mpu6050_write_one_byte(MPU6050_ADDR,MPU_FIFO_EN_REG,0);
+    res |= mpu6050_set_rate(rate);
+    res |= mpu6050_write_one_byte(MPU6050_ADDR,MPU_INT_EN_REG,MPU6050_INT_FIFO_OFLOW|MPU6050_INT_DATA_RDY);
+    res |= mpu6050_fifo_reset();
+    res |= mpu6050_write_one_byte(MPU6050_ADDR,MPU_FIFO_EN_REG,MPU6050_FIFO_EN_ACC_GYRO);
+    if(res == 0)
+        mpu6050_fifo_period = (uint32_t)(1000/rate) * 1000;   //开启DLPF时陀螺仪输出频率为1kHz，实际采样率为 1000/(分频+1)
+    memset(&mpu6050_fifo_stat,0,sizeof(mpu6050_fifo_stat));
+    return res;
+}
+
+/**
+  * @brief   关闭FIFO模式，恢复为直接读取输出寄存器
+  * @param   
+  * @retval  0 成功 其他 总线错误码
+ **/
+uint8_t mpu6050_fifo_disable(void)
+{
+    uint8_t res;
+    mpu6050_fifo_period = 0;
+    res  = mpu6050_write_one_byte(MPU6050_ADDR,MPU_FIFO_EN_REG,0);
+    res |= mpu6050_write_one_byte(MPU6050_ADDR,MPU_USER_CTRL_REG,MPU6050_USER_FIFO_RESET);
+    res |= mpu6050_write_one_byte(MPU6050_ADDR,MPU_INT_EN_REG,MPU6050_INT_DATA_RDY);
+    return res;
+}
+
+/**
+  * @brief   取出FIFO中的完整数据包
+  * @note    先读中断状态和FIFO计数，再把 N 个完整的数据包分成若干次突发读取（每次最多 MPU6050_FIFO_BURST 个）；
+  *          计数不是12的整数倍时，多出的部分是器件正在写入的数据包，留到下一次读取；
+  *          溢出后最旧的数据被覆盖，包边界已经无法确定，只能复位FIFO重新同步。
+  *          FIFO中没有温度数据，frame->temp 置0；时间戳由读取时刻和采样间隔倒推
+  * @param   frames 数据包缓冲区，按时间先后排列   max 最多取出的数据包数，剩余的留在FIFO中
+  * @retval  >=0 取出的数据包数 MPU6050_FIFO_ERR_xxx 错误
+ **/
+int mpu6050_fifo_read(mpu6050_frame_t *frames,uint16_t max)
+{
+    uint8_t raw[MPU6050_FIFO_BURST * MPU6050_FIFO_PACKET];
+    uint8_t buf[2],status;
+    uint16_t count,avail,n,chunk,i,k;
+    uint32_t now;
+    const uint8_t *p;
+
+    if(mpu6050_fifo_period == 0)
+        return MPU6050_FIFO_ERR_DISABLED;
+    if(frames == NULL || max == 0)
+        return 0;
+    if(mpu6050_read_one_byte(MPU6050_ADDR,MPU_INT_STA_REG,&status) != 0)
+        return MPU6050_FIFO_ERR_BUS;
+    if(mpu6050_read_bytes(MPU6050_ADDR,MPU_FIFO_CNTH_REG,2,buf) != 0)
+        return MPU6050_FIFO_ERR_BUS;
+    now = bus_timestamp_us(mpu6050_get_bus());
+    count = ((uint16_t)buf[0]<<8)|buf[1];
+
+    if((status & MPU6050_INT_FIFO_OFLOW) || count >= MPU6050_FIFO_SIZE)
+    {
+        mpu6050_fifo_stat.overflows++;
+        mpu6050_fifo_reset();
+        return MPU6050_FIFO_ERR_OVERFLOW;
+    }
+
+    avail = count / MPU6050_FIFO_PACKET;
+    n = avail < max ? avail : max;
+    for(i=0;i<n;i+=chunk)
+    {
+        chunk = n - i;
+        if(chunk > MPU6050_FIFO_BURST) chunk = MPU6050_FIFO_BURST;
+        if(mpu6050_read_bytes(MPU6050_ADDR,MPU_FIFO_RW_REG,chunk*MPU6050_FIFO_PACKET,raw) != 0)
+        {
+            //读到一半失败，包边界无法确定
+            mpu6050_fifo_reset();
+            return MPU6050_FIFO_ERR_BUS;
+        }
+        mpu6050_fifo_stat.bursts++;
+        for(k=0,p=raw;k<chunk;k++,p+=MPU6050_FIFO_PACKET)
+        {
+            mpu6050_frame_t *f = &frames[i+k];
+            f->acc[0]  = (int16_t)(((uint16_t)p[0]<<8)|p[1]);
+            f->acc[1]  = (int16_t)(((uint16_t)p[2]<<8)|p[3]);
+            f->acc[2]  = (int16_t)(((uint16_t)p[4]<<8)|p[5]);
+            f->temp    = 0;
+            f->gyro[0] = (int16_t)(((uint16_t)p[6]<<8)|p[7]);
+            f->gyro[1] = (int16_t)(((uint16_t)p[8]<<8)|p[9]);
+            f->gyro[2] = (int16_t)(((uint16_t)p[10]<<8)|p[11]);
+            if(mpu6050_cal.active)
+                mpu6050_cal_feed(f->gyro);
+            f->gyro[0] -= gyro_offset[0];
+            f->gyro[1] -= gyro_offset[1];
+            f->gyro[2] -= gyro_offset[2];
+            //FIFO中最新的数据包对应读取时刻，越早的数据包越往前推
+            f->timestamp = now - (uint32_t)(avail - 1 - (i+k)) * mpu6050_fifo_period;
+        }
+    }
+    mpu6050_fifo_stat.packets += n;
+    return n;
+}
+
+/**
+  * @brief   获取FIFO统计
+  * @param   
+  * @retval  统计信息
+ **/
+const mpu6050_fifo_stats_t *mpu6050_fifo_get_stats(void)
+{
+    return &mpu6050_fifo_stat;
+}
@@ -2,18 +2,91 @@
 #define _MPU6050_DRIVER_H
 
 #include <stdint.h>
+#include "bus_ops.h"
+#include "FixedPoint.h"
 
-int mpu6050_write_bytes(uint8_t addr,uint8_t reg,uint8_t len,uint8_t *data);
-int mpu6050_read_bytes(uint8_t addr,uint8_t reg,uint8_t len,uint8_t *data);
+void mpu6050_set_bus(const bus_t *bus);
+const bus_t *mpu6050_get_bus(void);
+
+int mpu6050_write_one_byte(uint8_t addr,uint8_t reg,uint8_t data);
+int mpu6050_read_one_byte(uint8_t addr,uint8_t reg,uint8_t *data);
+int mpu6050_write_bytes(uint8_t addr,uint8_t reg,uint16_t len,const uint8_t *data);
+int mpu6050_read_bytes(uint8_t addr,uint8_t reg,uint16_t len,uint8_t *data);
+
+/* 寄存器缓存统计 */
+typedef struct {
+	uint32_t writes;         //实际发生的写传输次数
+	uint32_t skipped;        //因与缓存相同而跳过的寄存器写入个数
+	uint32_t verify_fail;    //读回校验不一致的累计个数
+}mpu6050_shadow_stats_t;
+
+int mpu6050_write_regs(uint8_t reg,uint8_t len,const uint8_t *data);
+void mpu6050_shadow_invalidate(void);
+int mpu6050_shadow_verify(void);
+const mpu6050_shadow_stats_t *mpu6050_shadow_get_stats(void);
 
 int mpu6050_init(void);
 void mpu_calibration(void);
+
+/**
+  * 热启动记录：零偏和对应配置的散列保存在内部Flash保留页（带CRC）
+  * 上电时配置散列一致就直接装入零偏，跳过阻塞的校准和自检，零偏随后在后台重新校准
+  */
+typedef struct {
+	uint32_t raw_hash;           //原始数据配置（采样率、低通、量程）的散列，0表示无效
+	int16_t gyro_offset[3];      //陀螺仪零偏（原始值）
+	int16_t rsv;
+	uint32_t dmp_hash;           //DMP配置的散列，0表示无效
+	int32_t dmp_gyro_bias[3];    //DMP陀螺仪零偏（dmp_set_gyro_bias 的参数）
+	int32_t dmp_accel_bias[3];   //DMP加速度零偏（dmp_set_accel_bias 的参数）
+}mpu6050_warm_t;
+
+uint8_t mpu6050_warm_load(mpu6050_warm_t *w);
+uint8_t mpu6050_warm_save(const mpu6050_warm_t *w);
+uint32_t mpu6050_warm_hash(const void *cfg, uint16_t len);
+uint8_t mpu6050_calib_busy(void);
+uint8_t mpu6050_warm_commit(void);
 uint8_t mpu6050_set_gyro_fsr(uint8_t fsr);
 uint8_t mpu6050_set_acc_fsr(uint8_t fsr);
 uint8_t mpu6050_set_lpf(uint16_t lpf);
 uint8_t mpu6050_set_rate(uint16_t rate);
+uint8_t mpu6050_config(uint16_t rate,uint8_t gyro_fsr,uint8_t acc_fsr);
+
+/* 一次突发读取得到的完整采样帧（0x3B~0x48） */
+typedef struct {
+	uint32_t timestamp;      //采集时刻（us，总线时间戳）
+	int16_t acc[3];          //加速度原始值
+	int16_t temp;            //温度原始值
+	int16_t gyro[3];         //角速度原始值（已减去零偏）
+}mpu6050_frame_t;
+
+#define MPU6050_FRAME_LEN      14   //ACCEL_XOUT_H ~ GYRO_ZOUT_L
+
+/* FIFO模式：加速度+陀螺仪写入FIFO，每个数据包12字节 */
+#define MPU6050_FIFO_SIZE          1024
+#define MPU6050_FIFO_PACKET        12
+#define MPU6050_FIFO_BURST         16   //每次突发读取的最大数据包数（受 mpu6050_fifo_read 栈上缓冲区 raw[] 限制，占用 BURST*12 字节栈空间）
+
+#define MPU6050_FIFO_ERR_BUS       (-1) //总线错误
+#define MPU6050_FIFO_ERR_OVERFLOW  (-2) //FIFO溢出，已复位FIFO重新同步，溢出前的数据丢弃
+#define MPU6050_FIFO_ERR_DISABLED  (-3) //未开启FIFO模式
+
+typedef struct {
+	uint32_t packets;        //读出的数据包数
+	uint32_t bursts;         //读FIFO的总线传输次数
+	uint32_t overflows;      //溢出次数
+}mpu6050_fifo_stats_t;
+
+uint8_t mpu6050_fifo_enable(uint16_t rate);
+uint8_t mpu6050_fifo_disable(void);
+uint8_t mpu6050_fifo_reset(void);
+int mpu6050_fifo_read(mpu6050_frame_t *frames,uint16_t max);
+const mpu6050_fifo_stats_t *mpu6050_fifo_get_stats(void);
 
 int16_t mpu6050_get_temperature(void);
+void mpu6050_decode_frame(const uint8_t *raw,mpu6050_frame_t *frame);
+uint8_t mpu6050_read_frame(mpu6050_frame_t *frame);
+int mpu6050_read_frame_async(uint8_t *raw,bus_done_cb_t done,void *arg);
 uint8_t mpu6050_get_gyro(int16_t *gx,int16_t *gy,int16_t *gz);
 uint8_t mpu6050_get_acc(int16_t *ax,int16_t *ay,int16_t *az);
 
@@ -27,7 +100,11 @@ uint8_t mpu6050_get_acc(int16_t *ax,int16_t *ay,int16_t *az);
 #define ACC_8G                 2
 #define ACC_16G                3     
 
-//ٶȼ(m/s2)(rad/s)תΪʵֵ
+//mpu6050_init 使用的量程，定点换算的移位位数随之在编译期确定
+#define MPU6050_GYRO_FSR       GYRO_2000DPS
+#define MPU6050_ACC_FSR        ACC_2G
+
+//将加速度计(m/s2)和陀螺仪(rad/s)转换为实际值
 #define MPU6050_ACCEL_2G_SEN     0.0005981445312f  // m/s2/LSB 
 #define MPU6050_ACCEL_4G_SEN     0.0011962890625f  // m/s2/LSB
 #define MPU6050_ACCEL_8G_SEN     0.002392578125f   // m/s2/LSB
@@ -38,75 +115,84 @@ uint8_t mpu6050_get_acc(int16_t *ax,int16_t *ay,int16_t *az);
 #define MPU6050_GYRO_500_SEN     0.00026631610900792382460383465095346f
 #define MPU6050_GYRO_250_SEN     0.00013315805450396191230191732547673f
 
-//AD0(9)ӵ,IICַΪ0X68(λ).
-//V3.3,IICַΪ0X69(λ).
-#define MPU6050_ADDR            0X68    //MPU6500IICַ
-//MPU6500ڲĴ
-#define MPU_SELF_TESTX_REG		0X0D	//ԼĴX
-#define MPU_SELF_TESTY_REG		0X0E	//ԼĴY
-#define MPU_SELF_TESTZ_REG		0X0F	//ԼĴZ
-#define MPU_SELF_TESTA_REG		0X10	//ԼĴA
-#define MPU_SAMPLE_RATE_REG		0X19	//ƵʷƵ
-#define MPU_CFG_REG				0X1A	//üĴ
-#define MPU_GYRO_CFG_REG		0X1B	//üĴ
-#define MPU_ACCEL_CFG_REG		0X1C	//ٶȼüĴ
-#define MPU_MOTION_DET_REG		0X1F	//˶ֵⷧüĴ
-#define MPU_FIFO_EN_REG			0X23	//FIFOʹܼĴ
-#define MPU_I2CMST_CTRL_REG		0X24	//IICƼĴ
-#define MPU_I2CSLV0_ADDR_REG	0X25	//IICӻ0ַĴ
-#define MPU_I2CSLV0_REG			0X26	//IICӻ0ݵַĴ
-#define MPU_I2CSLV0_CTRL_REG	0X27	//IICӻ0ƼĴ
-#define MPU_I2CSLV1_ADDR_REG	0X28	//IICӻ1ַĴ
-#define MPU_I2CSLV1_REG			0X29	//IICӻ1ݵַĴ
-#define MPU_I2CSLV1_CTRL_REG	0X2A	//IICӻ1ƼĴ
-#define MPU_I2CSLV2_ADDR_REG	0X2B	//IICӻ2ַĴ
-#define MPU_I2CSLV2_REG			0X2C	//IICӻ2ݵַĴ
-#define MPU_I2CSLV2_CTRL_REG	0X2D	//IICӻ2ƼĴ
-#define MPU_I2CSLV3_ADDR_REG	0X2E	//IICӻ3ַĴ
-#define MPU_I2CSLV3_REG			0X2F	//IICӻ3ݵַĴ
-#define MPU_I2CSLV3_CTRL_REG	0X30	//IICӻ3ƼĴ
-#define MPU_I2CSLV4_ADDR_REG	0X31	//IICӻ4ַĴ
-#define MPU_I2CSLV4_REG			0X32	//IICӻ4ݵַĴ
-#define MPU_I2CSLV4_DO_REG		0X33	//IICӻ4дݼĴ
-#define MPU_I2CSLV4_CTRL_REG	0X34	//IICӻ4ƼĴ
-#define MPU_I2CSLV4_DI_REG		0X35	//IICӻ4ݼĴ
-
-#define MPU_I2CMST_STA_REG		0X36	//IIC״̬Ĵ
-#define MPU_INTBP_CFG_REG		0X37	//ж/·üĴ
-#define MPU_INT_EN_REG			0X38	//жʹܼĴ
-#define MPU_INT_STA_REG			0X3A	//ж״̬Ĵ
-
-#define MPU_ACCEL_XOUTH_REG		0X3B	//ٶֵ,X8λĴ
-#define MPU_ACCEL_XOUTL_REG		0X3C	//ٶֵ,X8λĴ
-#define MPU_ACCEL_YOUTH_REG		0X3D	//ٶֵ,Y8λĴ
-#define MPU_ACCEL_YOUTL_REG		0X3E	//ٶֵ,Y8λĴ
-#define MPU_ACCEL_ZOUTH_REG		0X3F	//ٶֵ,Z8λĴ
-#define MPU_ACCEL_ZOUTL_REG		0X40	//ٶֵ,Z8λĴ
-
-#define MPU_TEMP_OUTH_REG		0X41	//¶ֵ߰λĴ
-#define MPU_TEMP_OUTL_REG		0X42	//¶ֵ8λĴ
-
-#define MPU_GYRO_XOUTH_REG		0X43	//ֵ,X8λĴ
-#define MPU_GYRO_XOUTL_REG		0X44	//ֵ,X8λĴ
-#define MPU_GYRO_YOUTH_REG		0X45	//ֵ,Y8λĴ
-#define MPU_GYRO_YOUTL_REG		0X46	//ֵ,Y8λĴ
-#define MPU_GYRO_ZOUTH_REG		0X47	//ֵ,Z8λĴ
-#define MPU_GYRO_ZOUTL_REG		0X48	//ֵ,Z8λĴ
-
-#define MPU_I2CSLV0_DO_REG		0X63	//IICӻ0ݼĴ
-#define MPU_I2CSLV1_DO_REG		0X64	//IICӻ1ݼĴ
-#define MPU_I2CSLV2_DO_REG		0X65	//IICӻ2ݼĴ
-#define MPU_I2CSLV3_DO_REG		0X66	//IICӻ3ݼĴ
-
-#define MPU_I2CMST_DELAY_REG	0X67	//IICʱĴ
-#define MPU_SIGPATH_RST_REG		0X68	//źͨλĴ
-#define MPU_MDETECT_CTRL_REG	0X69	//˶ƼĴ
-#define MPU_USER_CTRL_REG		0X6A	//ûƼĴ
-#define MPU_PWR_MGMT1_REG		0X6B	//ԴĴ1
-#define MPU_PWR_MGMT2_REG		0X6C	//ԴĴ2 
-#define MPU_FIFO_CNTH_REG		0X72	//FIFOĴ߰λ
-#define MPU_FIFO_CNTL_REG		0X73	//FIFOĴͰλ
-#define MPU_FIFO_RW_REG			0X74	//FIFOдĴ
-#define MPU_DEVICE_ID_REG		0X75	//IDĴ
+//定点换算（Q16.16）：raw * MUL >> SHIFT，各量程的MUL相同，量程每增大一倍少右移一位
+#define MPU6050_GYRO_Q16_MUL          35744   //round(MPU6050_GYRO_2000_SEN * 2^25)
+#define MPU6050_GYRO_Q16_SHIFT(fsr)   (9 + GYRO_2000DPS - (fsr))
+#define MPU6050_ACCEL_Q16_MUL         40141   //round(MPU6050_ACCEL_2G_SEN * 2^26)
+#define MPU6050_ACCEL_Q16_SHIFT(fsr)  (10 - (fsr))
+
+#define mpu6050_gyro_q16(raw)   Q_SCALE(raw, MPU6050_GYRO_Q16_MUL,  MPU6050_GYRO_Q16_SHIFT(MPU6050_GYRO_FSR))   //rad/s Q16
+#define mpu6050_acc_q16(raw)    Q_SCALE(raw, MPU6050_ACCEL_Q16_MUL, MPU6050_ACCEL_Q16_SHIFT(MPU6050_ACC_FSR))   //m/s2 Q16
+
+//如果AD0脚(9脚)接地,IIC地址为0X68(不包含最低位).
+//如果接V3.3,则IIC地址为0X69(不包含最低位).
+#define MPU6050_ADDR            0X68    //MPU6500的器件IIC地址
+//MPU6500的内部寄存器
+#define MPU_SELF_TESTX_REG		0X0D	//自检寄存器X
+#define MPU_SELF_TESTY_REG		0X0E	//自检寄存器Y
+#define MPU_SELF_TESTZ_REG		0X0F	//自检寄存器Z
+#define MPU_SELF_TESTA_REG		0X10	//自检寄存器A
+#define MPU_SAMPLE_RATE_REG		0X19	//采样频率分频器
+#define MPU_CFG_REG				0X1A	//配置寄存器
+#define MPU_GYRO_CFG_REG		0X1B	//陀螺仪配置寄存器
+#define MPU_ACCEL_CFG_REG		0X1C	//加速度计配置寄存器
+#define MPU_MOTION_DET_REG		0X1F	//运动检测阀值设置寄存器
+#define MPU_FIFO_EN_REG			0X23	//FIFO使能寄存器
+#define MPU_I2CMST_CTRL_REG		0X24	//IIC主机控制寄存器
+#define MPU_I2CSLV0_ADDR_REG	0X25	//IIC从机0器件地址寄存器
+#define MPU_I2CSLV0_REG			0X26	//IIC从机0数据地址寄存器
+#define MPU_I2CSLV0_CTRL_REG	0X27	//IIC从机0控制寄存器
+#define MPU_I2CSLV1_ADDR_REG	0X28	//IIC从机1器件地址寄存器
+#define MPU_I2CSLV1_REG			0X29	//IIC从机1数据地址寄存器
+#define MPU_I2CSLV1_CTRL_REG	0X2A	//IIC从机1控制寄存器
+#define MPU_I2CSLV2_ADDR_REG	0X2B	//IIC从机2器件地址寄存器
+#define MPU_I2CSLV2_REG			0X2C	//IIC从机2数据地址寄存器
+#define MPU_I2CSLV2_CTRL_REG	0X2D	//IIC从机2控制寄存器
+#define MPU_I2CSLV3_ADDR_REG	0X2E	//IIC从机3器件地址寄存器
+#define MPU_I2CSLV3_REG			0X2F	//IIC从机3数据地址寄存器
+#define MPU_I2CSLV3_CTRL_REG	0X30	//IIC从机3控制寄存器
+#define MPU_I2CSLV4_ADDR_REG	0X31	//IIC从机4器件地址寄存器
+#define MPU_I2CSLV4_REG			0X32	//IIC从机4数据地址寄存器
+#define MPU_I2CSLV4_DO_REG		0X33	//IIC从机4写数据寄存器
+#define MPU_I2CSLV4_CTRL_REG	0X34	//IIC从机4控制寄存器
+#define MPU_I2CSLV4_DI_REG		0X35	//IIC从机4读数据寄存器
+
+#define MPU_I2CMST_STA_REG		0X36	//IIC主机状态寄存器
+#define MPU_INTBP_CFG_REG		0X37	//中断/旁路设置寄存器
+#define MPU_INT_EN_REG			0X38	//中断使能寄存器
+#define MPU_INT_STA_REG			0X3A	//中断状态寄存器
+
+#define MPU_ACCEL_XOUTH_REG		0X3B	//加速度值,X轴高8位寄存器
+#define MPU_ACCEL_XOUTL_REG		0X3C	//加速度值,X轴低8位寄存器
+#define MPU_ACCEL_YOUTH_REG		0X3D	//加速度值,Y轴高8位寄存器
+#define MPU_ACCEL_YOUTL_REG		0X3E	//加速度值,Y轴低8位寄存器
+#define MPU_ACCEL_ZOUTH_REG		0X3F	//加速度值,Z轴高8位寄存器
+#define MPU_ACCEL_ZOUTL_REG		0X40	//加速度值,Z轴低8位寄存器
+
+#define MPU_TEMP_OUTH_REG		0X41	//温度值高八位寄存器
+#define MPU_TEMP_OUTL_REG		0X42	//温度值低8位寄存器
+
+#define MPU_GYRO_XOUTH_REG		0X43	//陀螺仪值,X轴高8位寄存器
+#define MPU_GYRO_XOUTL_REG		0X44	//陀螺仪值,X轴低8位寄存器
+#define MPU_GYRO_YOUTH_REG		0X45	//陀螺仪值,Y轴高8位寄存器
+#define MPU_GYRO_YOUTL_REG		0X46	//陀螺仪值,Y轴低8位寄存器
+#define MPU_GYRO_ZOUTH_REG		0X47	//陀螺仪值,Z轴高8位寄存器
+#define MPU_GYRO_ZOUTL_REG		0X48	//陀螺仪值,Z轴低8位寄存器
+
+#define MPU_I2CSLV0_DO_REG		0X63	//IIC从机0数据寄存器
+#define MPU_I2CSLV1_DO_REG		0X64	//IIC从机1数据寄存器
+#define MPU_I2CSLV2_DO_REG		0X65	//IIC从机2数据寄存器
+#define MPU_I2CSLV3_DO_REG		0X66	//IIC从机3数据寄存器
+
+#define MPU_I2CMST_DELAY_REG	0X67	//IIC主机延时管理寄存器
+#define MPU_SIGPATH_RST_REG		0X68	//信号通道复位寄存器
+#define MPU_MDETECT_CTRL_REG	0X69	//运动检测控制寄存器
+#define MPU_USER_CTRL_REG		0X6A	//用户控制寄存器
+#define MPU_PWR_MGMT1_REG		0X6B	//电源管理寄存器1
+#define MPU_PWR_MGMT2_REG		0X6C	//电源管理寄存器2 
+#define MPU_FIFO_CNTH_REG		0X72	//FIFO计数寄存器高八位
+#define MPU_FIFO_CNTL_REG		0X73	//FIFO计数寄存器低八位
+#define MPU_FIFO_RW_REG			0X74	//FIFO读写寄存器
+#define MPU_DEVICE_ID_REG		0X75	//器件ID寄存器
 
 #endif
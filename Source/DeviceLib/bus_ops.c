@@ -0,0 +1,418 @@
+/**
+  ******************************************************************************
+  * @file    bus_ops.c
+  * @author  liqinghua <liqinghuaxx@163.com>
+  * @version V1.0.0
+  * @date    2026-01-29
+  * @brief   设备驱动总线抽象层
+  *
+  * @copyright (c) 2026 liqinghua
+  *
+  * Permission is hereby granted, free of charge, to any person obtaining a copy
+  * of this software and associated documentation files (the "Software"), to deal
+  * in the Software without restriction, including without limitation the rights
+  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  * copies of the Software, and to permit persons to whom the Software is
+  * furnished to do so, subject to the following conditions:
+
+  * The above copyright notice and this permission notice shall be included in all
+  * copies or substantial portions of the Software.
+
+  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  * SOFTWARE.
+  *
+  * @details
+  *          设备驱动（MPU6050、BH1750、eMPL等）不再直接调用某一种I2C实现，
+  *          而是通过 bus_t 持有的操作表访问总线，同一份驱动代码可以运行在
+  *          软件I2C、硬件I2C+DMA或主机仿真总线上，缓冲区直接透传，不做拷贝。
+  *
+  *          本文件提供：
+  *          - 异步接口的同步退化实现（总线不支持异步时直接执行并回调）
+  *          - 软件I2C、硬件I2C、硬件I2C请求队列三种总线的适配实现（user port area）
+  *
+  * @note    主机仿真时只需自行实现一份 bus_ops_t，不需要编译 user port area
+  */
+#include "bus_ops.h"
+
+/**
+  * @brief  异步写寄存器
+  * @param  bus: 总线实例
+  * @param  addr: 设备地址（7位）
+  * @param  reg: 起始寄存器地址
+  * @param  buf: 待写数据，完成前必须保持有效
+  * @param  len: 写入长度
+  * @param  done: 完成回调，可以为NULL
+  * @param  arg: 回调参数
+  * @retval BUS_OK: 已提交（或已同步完成） 其他: 提交失败，不会回调
+  * @note   总线不支持异步时同步执行，返回前调用 done
+  */
+int bus_write_reg_async(const bus_t *bus, uint8_t addr, uint8_t reg, const uint8_t *buf, uint16_t len, bus_done_cb_t done, void *arg)
+{
+	int status;
+	if(bus->ops->write_reg_async)
+		return bus->ops->write_reg_async(bus->ctx, addr, reg, buf, len, done, arg);
+	status = bus_write_reg(bus, addr, reg, buf, len);
+	if(done) done(status, arg);
+	return BUS_OK;
+}
+
+/**
+  * @brief  异步读寄存器
+  * @param  bus: 总线实例
+  * @param  addr: 设备地址（7位）
+  * @param  reg: 起始寄存器地址
+  * @param  buf: 接收缓冲区，完成前必须保持有效
+  * @param  len: 读取长度
+  * @param  done: 完成回调，可以为NULL
+  * @param  arg: 回调参数
+  * @retval 同 bus_write_reg_async
+  */
+int bus_read_reg_async(const bus_t *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len, bus_done_cb_t done, void *arg)
+{
+	int status;
+	if(bus->ops->read_reg_async)
+		return bus->ops->read_reg_async(bus->ctx, addr, reg, buf, len, done, arg);
+	status = bus_read_reg(bus, addr, reg, buf, len);
+	if(done) done(status, arg);
+	return BUS_OK;
+}
+
+/****************** user port area start ****************/
+#include "bsp_delay.h"
+#include "bsp_timebase.h"
+#include "bsp_i2c_queue.h"
+
+//时间戳使用单调时基，完整32位回绕，时间差直接相减
+static uint32_t bus_timebase_us(void *ctx)
+{
+	(void)ctx;
+	return timebase_now_us();
+}
+
+/* ---------------- 软件I2C ---------------- */
+//软件I2C的错误没有细分，统一按无应答处理
+#define bus_soft_i2c_status(res)  ((res) ? BUS_ERR_NACK : BUS_OK)
+
+static int bus_soft_i2c_write_reg(void *ctx, uint8_t addr, uint8_t reg, const uint8_t *buf, uint16_t len)
+{
+	return bus_soft_i2c_status(soft_i2c_write_dev_len_byte(*(const SOFT_I2C_TypeDef *)ctx, addr, reg, len, (uint8_t *)buf));
+}
+
+static int bus_soft_i2c_read_reg(void *ctx, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+	return bus_soft_i2c_status(soft_i2c_read_dev_len_byte(*(const SOFT_I2C_TypeDef *)ctx, addr, reg, len, buf));
+}
+
+static int bus_soft_i2c_write(void *ctx, uint8_t addr, const uint8_t *buf, uint16_t len)
+{
+	if(len > 0xFF) return BUS_ERR_PARAM;
+	return bus_soft_i2c_status(soft_i2c_write(*(const SOFT_I2C_TypeDef *)ctx, addr, buf, (uint8_t)len));
+}
+
+static int bus_soft_i2c_read(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+	if(len > 0xFF) return BUS_ERR_PARAM;
+	return bus_soft_i2c_status(soft_i2c_read(*(const SOFT_I2C_TypeDef *)ctx, addr, buf, (uint8_t)len));
+}
+
+static const bus_ops_t bus_soft_i2c_ops = {
+	bus_soft_i2c_write_reg,
+	bus_soft_i2c_read_reg,
+	bus_soft_i2c_write,
+	bus_soft_i2c_read,
+	NULL,                      //软件I2C没有后台传输能力，异步接口退化为同步
+	NULL,
+	bus_timebase_us,
+};
+
+#define BUS_SOFT_I2C_ID(name, port, rcc, scl, sda, speed)   name,
+#define BUS_SOFT_I2C_DESC(name, port, rcc, scl, sda, speed) { &bus_soft_i2c_ops, (void *)&bus_soft_i2c_id[name] },
+
+static const SOFT_I2C_TypeDef bus_soft_i2c_id[SOFT_I2C_BUS_NUM] = {
+	SOFT_I2C_BUS_LIST(BUS_SOFT_I2C_ID)
+};
+
+static const bus_t bus_soft_i2c_desc[SOFT_I2C_BUS_NUM] = {
+	SOFT_I2C_BUS_LIST(BUS_SOFT_I2C_DESC)
+};
+
+/**
+  * @brief  获取软件I2C总线实例
+  * @param  soft_i2c: I2C编号
+  * @retval 总线实例指针
+  * @note   总线本身需要先调用 soft_i2c_init 初始化
+  */
+const bus_t *bus_soft_i2c(SOFT_I2C_TypeDef soft_i2c)
+{
+	delay_cycle_init();
+	return &bus_soft_i2c_desc[soft_i2c];
+}
+
+/* ---------------- 硬件I2C ---------------- */
+typedef struct {
+	HARD_I2C_TypeDef id;
+	bus_done_cb_t done;        //当前异步传输的完成回调
+	void *arg;
+}bus_hard_i2c_ctx_t;
+
+static bus_hard_i2c_ctx_t bus_hard_i2c_ctx[HARD_I2C_BUS_NUM];
+
+static void bus_hard_i2c_complete(HARD_I2C_TypeDef bus, uint8_t status)
+{
+	bus_done_cb_t done = bus_hard_i2c_ctx[bus].done;
+	void *arg = bus_hard_i2c_ctx[bus].arg;
+
+	bus_hard_i2c_ctx[bus].done = NULL;
+	if(done) done(status, arg);
+}
+
+//同步传输：总线被中断中发起的异步读取占用时，等它结束后重试
+static int bus_hard_i2c_xfer(HARD_I2C_TypeDef id, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len, uint8_t read)
+{
+	uint8_t res;
+
+	while((res = read ? i2c_xfer_async(id, addr, reg, buf, len, NULL)
+	                  : i2c_write_async(id, addr, reg, buf, len, NULL)) == HARD_I2C_ERR_BUSY)
+		hard_i2c_wait(id);
+	return res ? res : hard_i2c_wait(id);
+}
+
+//异步传输：占用总线和登记回调在关中断下完成，回调登记之前传输不会结束；
+//占用失败时不改动回调，总线上正在进行的传输的回调保持有效
+static int bus_hard_i2c_start(bus_hard_i2c_ctx_t *c, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len, uint8_t read, bus_done_cb_t done, void *arg)
+{
+	uint32_t primask;
+	uint8_t res;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	res = read ? i2c_xfer_async(c->id, addr, reg, buf, len, bus_hard_i2c_complete)
+	           : i2c_write_async(c->id, addr, reg, buf, len, bus_hard_i2c_complete);
+	if(res == HARD_I2C_OK)
+	{
+		c->done = done;
+		c->arg  = arg;
+	}
+	__set_PRIMASK(primask);
+	return res;
+}
+
+static int bus_hard_i2c_write_reg(void *ctx, uint8_t addr, uint8_t reg, const uint8_t *buf, uint16_t len)
+{
+	return bus_hard_i2c_xfer(((bus_hard_i2c_ctx_t *)ctx)->id, addr, reg, (uint8_t *)buf, len, 0);
+}
+
+static int bus_hard_i2c_read_reg(void *ctx, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+	return bus_hard_i2c_xfer(((bus_hard_i2c_ctx_t *)ctx)->id, addr, reg, buf, len, 1);
+}
+
+static int bus_hard_i2c_write_reg_async(void *ctx, uint8_t addr, uint8_t reg, const uint8_t *buf, uint16_t len, bus_done_cb_t done, void *arg)
+{
+	return bus_hard_i2c_start((bus_hard_i2c_ctx_t *)ctx, addr, reg, (uint8_t *)buf, len, 0, done, arg);
+}
+
+static int bus_hard_i2c_read_reg_async(void *ctx, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len, bus_done_cb_t done, void *arg)
+{
+	return bus_hard_i2c_start((bus_hard_i2c_ctx_t *)ctx, addr, reg, buf, len, 1, done, arg);
+}
+
+static const bus_ops_t bus_hard_i2c_ops = {
+	bus_hard_i2c_write_reg,
+	bus_hard_i2c_read_reg,
+	NULL,                      //硬件I2C状态机只支持带寄存器地址的传输
+	NULL,
+	bus_hard_i2c_write_reg_async,
+	bus_hard_i2c_read_reg_async,
+	bus_timebase_us,
+};
+
+static bus_t bus_hard_i2c_desc[HARD_I2C_BUS_NUM];
+
+/**
+  * @brief  获取硬件I2C总线实例
+  * @param  hard_i2c: I2C编号
+  * @retval 总线实例指针
+  * @note   总线本身需要先调用 hard_i2c_init 初始化；
+  *         同步接口在总线被占用（中断中的异步读取、bsp_i2c_queue）时等待其结束后重试，
+  *         不能在I2C中断及更高优先级的中断中调用
+  */
+const bus_t *bus_hard_i2c(HARD_I2C_TypeDef hard_i2c)
+{
+	delay_cycle_init();
+	bus_hard_i2c_ctx[hard_i2c].id = hard_i2c;
+	bus_hard_i2c_desc[hard_i2c].ops = &bus_hard_i2c_ops;
+	bus_hard_i2c_desc[hard_i2c].ctx = &bus_hard_i2c_ctx[hard_i2c];
+	return &bus_hard_i2c_desc[hard_i2c];
+}
+
+/* ---------------- 硬件I2C + 请求队列 ---------------- */
+typedef struct {
+	HARD_I2C_TypeDef id;
+	uint8_t priority;          //提交请求使用的优先级
+	uint8_t flags;             //BUS_QUEUE_MERGE 等
+	uint32_t deadline_us;      //提交请求使用的截止时间，0表示不限
+}bus_queue_ctx_t;
+
+/* 异步请求的完成回调记录，每条总线与队列深度相同，不会先于队列耗尽 */
+typedef struct {
+	bus_done_cb_t done;
+	void *arg;
+	volatile uint8_t used;
+}bus_queue_req_t;
+
+/* 同步请求的完成标志，位于调用者栈上 */
+typedef struct {
+	volatile uint8_t finished;
+	volatile int status;
+}bus_queue_sync_t;
+
+static bus_queue_ctx_t bus_queue_ctx[HARD_I2C_BUS_NUM][BUS_QUEUE_HANDLE_NUM];
+static bus_t bus_queue_desc[HARD_I2C_BUS_NUM][BUS_QUEUE_HANDLE_NUM];
+static bus_queue_req_t bus_queue_req[HARD_I2C_BUS_NUM][I2C_QUEUE_DEPTH];
+
+static void bus_queue_complete(uint8_t status, void *arg)
+{
+	bus_queue_req_t *r = (bus_queue_req_t *)arg;
+	bus_done_cb_t done = r->done;
+	void *done_arg = r->arg;
+
+	r->used = 0;  //先释放记录，回调中可以继续提交
+	if(done) done(status, done_arg);
+}
+
+static void bus_queue_sync_done(int status, void *arg)
+{
+	bus_queue_sync_t *s = (bus_queue_sync_t *)arg;
+
+	s->status = status;
+	s->finished = 1;
+}
+
+static int bus_queue_submit(bus_queue_ctx_t *c, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len, uint8_t read, bus_done_cb_t done, void *arg)
+{
+	bus_queue_req_t *pool = bus_queue_req[c->id];
+	i2c_request_t req;
+	uint32_t primask;
+	int i;
+
+	if(read && len == 0) return BUS_ERR_PARAM;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	for(i = 0; i < I2C_QUEUE_DEPTH && pool[i].used; i++);
+	if(i == I2C_QUEUE_DEPTH)
+	{
+		__set_PRIMASK(primask);
+		return BUS_ERR_BUSY;
+	}
+	pool[i].used = 1;
+	__set_PRIMASK(primask);
+	pool[i].done = done;
+	pool[i].arg  = arg;
+
+	req.addr = addr;
+	req.reg = reg;
+	req.read = read;
+	req.priority = c->priority;
+	req.no_merge = (c->flags & BUS_QUEUE_MERGE) ? 0 : 1;
+	req.buf = buf;
+	req.len = len;
+	req.deadline_us = c->deadline_us;
+	req.callback = bus_queue_complete;
+	req.arg = &pool[i];
+	if(i2c_queue_submit(c->id, &req))
+	{
+		pool[i].used = 0;
+		return BUS_ERR_BUSY;   //队列已满（其他直接使用队列的代码占满了槽位）
+	}
+	return BUS_OK;
+}
+
+static int bus_queue_xfer(bus_queue_ctx_t *c, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len, uint8_t read)
+{
+	bus_queue_sync_t sync;
+	int res;
+
+	sync.finished = 0;
+	sync.status = BUS_OK;
+	res = bus_queue_submit(c, addr, reg, buf, len, read, bus_queue_sync_done, (void *)&sync);
+	if(res) return res;
+	while(!sync.finished)
+		hard_i2c_is_busy(c->id);  //轮询同时检查传输超时
+	return sync.status;
+}
+
+static int bus_queue_write_reg(void *ctx, uint8_t addr, uint8_t reg, const uint8_t *buf, uint16_t len)
+{
+	return bus_queue_xfer((bus_queue_ctx_t *)ctx, addr, reg, (uint8_t *)buf, len, 0);
+}
+
+static int bus_queue_read_reg(void *ctx, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+	return bus_queue_xfer((bus_queue_ctx_t *)ctx, addr, reg, buf, len, 1);
+}
+
+static int bus_queue_write_reg_async(void *ctx, uint8_t addr, uint8_t reg, const uint8_t *buf, uint16_t len, bus_done_cb_t done, void *arg)
+{
+	return bus_queue_submit((bus_queue_ctx_t *)ctx, addr, reg, (uint8_t *)buf, len, 0, done, arg);
+}
+
+static int bus_queue_read_reg_async(void *ctx, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len, bus_done_cb_t done, void *arg)
+{
+	return bus_queue_submit((bus_queue_ctx_t *)ctx, addr, reg, buf, len, 1, done, arg);
+}
+
+static const bus_ops_t bus_queue_ops = {
+	bus_queue_write_reg,
+	bus_queue_read_reg,
+	NULL,                      //硬件I2C状态机只支持带寄存器地址的传输
+	NULL,
+	bus_queue_write_reg_async,
+	bus_queue_read_reg_async,
+	bus_timebase_us,
+};
+
+/**
+  * @brief  获取经请求队列访问的硬件I2C总线实例
+  * @details 所有读写都作为 i2c_request_t 提交给 bsp_i2c_queue，由队列按优先级、截止时间排队，
+  *          多个驱动（及主循环与中断）共用一条总线时互不阻塞、不会返回 BUS_ERR_BUSY；
+  *          同步接口提交后等待完成，不能在I2C中断及更高优先级的中断中调用。
+  *          同一设备的不同用途可以各取一个实例，例如突发读数据寄存器的实例开启合并，
+  *          访问FIFO等地址不递增寄存器的实例不开启
+  * @param  hard_i2c: I2C编号
+  * @param  priority: 请求优先级，数值越小越优先
+  * @param  flags: BUS_QUEUE_MERGE 允许读请求合并（要求经该实例读取的寄存器地址自动递增），0 不合并
+  * @param  deadline_us: 每个请求从提交起的截止时间（us），影响同优先级的排序和 deadline_miss 统计，0表示不限
+  * @retval 总线实例指针，参数相同时返回同一实例；实例数超过 BUS_QUEUE_HANDLE_NUM 时返回NULL
+  * @note   需要先调用 hard_i2c_init 和 i2c_queue_init；应在初始化阶段调用
+  */
+const bus_t *bus_i2c_queue(HARD_I2C_TypeDef hard_i2c, uint8_t priority, uint8_t flags, uint32_t deadline_us)
+{
+	bus_queue_ctx_t *c;
+	uint8_t i;
+
+	for(i = 0; i < BUS_QUEUE_HANDLE_NUM; i++)
+	{
+		c = &bus_queue_ctx[hard_i2c][i];
+		if(bus_queue_desc[hard_i2c][i].ops == NULL)
+		{
+			c->id = hard_i2c;
+			c->priority = priority;
+			c->flags = flags;
+			c->deadline_us = deadline_us;
+			bus_queue_desc[hard_i2c][i].ctx = c;
+			bus_queue_desc[hard_i2c][i].ops = &bus_queue_ops;
+			return &bus_queue_desc[hard_i2c][i];
+		}
+		if(c->priority == priority && c->flags == flags && c->deadline_us == deadline_us)
+			return &bus_queue_desc[hard_i2c][i];
+	}
+	return NULL;
+}
+/****************** user port area end   ****************/
@@ -0,0 +1,80 @@
+#ifndef _BUS_OPS_H
+#define _BUS_OPS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* 总线操作返回值，与 bsp_hard_i2c 的状态码保持一致 */
+#define BUS_OK               0   //成功
+#define BUS_ERR_NACK         1   //从机无应答
+#define BUS_ERR_BUS          2   //总线错误或仲裁丢失
+#define BUS_ERR_BUSY         3   //总线忙
+#define BUS_ERR_PARAM        4   //参数错误
+#define BUS_ERR_UNSUPPORTED  5   //该总线不支持此操作
+#define BUS_ERR_TIMEOUT      6   //传输超时
+
+/* 异步操作完成回调，可能在中断上下文中执行 */
+typedef void (*bus_done_cb_t)(int status, void *arg);
+
+/**
+  * 总线操作表，一种总线实现一份（软件I2C、硬件I2C+DMA、主机仿真等）
+  * ctx 为总线私有数据，由 bus_t 携带，驱动不关心其内容
+  * 不支持的操作填NULL，调用时返回 BUS_ERR_UNSUPPORTED，异步操作为NULL时退化为同步执行
+  */
+typedef struct {
+	int (*write_reg)(void *ctx, uint8_t addr, uint8_t reg, const uint8_t *buf, uint16_t len);
+	int (*read_reg)(void *ctx, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+	int (*write)(void *ctx, uint8_t addr, const uint8_t *buf, uint16_t len);   //无寄存器地址的突发写
+	int (*read)(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len);          //无寄存器地址的突发读
+	int (*write_reg_async)(void *ctx, uint8_t addr, uint8_t reg, const uint8_t *buf, uint16_t len, bus_done_cb_t done, void *arg);
+	int (*read_reg_async)(void *ctx, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len, bus_done_cb_t done, void *arg);
+	uint32_t (*timestamp_us)(void *ctx);                                       //总线时间戳（us）
+}bus_ops_t;
+
+/* 总线实例：驱动只持有该结构体指针 */
+typedef struct {
+	const bus_ops_t *ops;
+	void *ctx;
+}bus_t;
+
+static __inline int bus_write_reg(const bus_t *bus, uint8_t addr, uint8_t reg, const uint8_t *buf, uint16_t len)
+{
+	return bus->ops->write_reg ? bus->ops->write_reg(bus->ctx, addr, reg, buf, len) : BUS_ERR_UNSUPPORTED;
+}
+
+static __inline int bus_read_reg(const bus_t *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+	return bus->ops->read_reg ? bus->ops->read_reg(bus->ctx, addr, reg, buf, len) : BUS_ERR_UNSUPPORTED;
+}
+
+static __inline int bus_write(const bus_t *bus, uint8_t addr, const uint8_t *buf, uint16_t len)
+{
+	return bus->ops->write ? bus->ops->write(bus->ctx, addr, buf, len) : BUS_ERR_UNSUPPORTED;
+}
+
+static __inline int bus_read(const bus_t *bus, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+	return bus->ops->read ? bus->ops->read(bus->ctx, addr, buf, len) : BUS_ERR_UNSUPPORTED;
+}
+
+static __inline uint32_t bus_timestamp_us(const bus_t *bus)
+{
+	return bus->ops->timestamp_us ? bus->ops->timestamp_us(bus->ctx) : 0;
+}
+
+int bus_write_reg_async(const bus_t *bus, uint8_t addr, uint8_t reg, const uint8_t *buf, uint16_t len, bus_done_cb_t done, void *arg);
+int bus_read_reg_async(const bus_t *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len, bus_done_cb_t done, void *arg);
+
+/****************** user port area start ****************/
+#include "bsp_soft_i2c.h"
+#include "bsp_hard_i2c.h"
+
+const bus_t *bus_soft_i2c(SOFT_I2C_TypeDef soft_i2c);
+const bus_t *bus_hard_i2c(HARD_I2C_TypeDef hard_i2c);
+
+#define BUS_QUEUE_HANDLE_NUM  4      //每条硬件I2C可创建的队列总线实例数
+#define BUS_QUEUE_MERGE       0x01   //允许读请求与同一设备上地址相邻或重叠的读请求合并
+const bus_t *bus_i2c_queue(HARD_I2C_TypeDef hard_i2c, uint8_t priority, uint8_t flags, uint32_t deadline_us);
+/****************** user port area end   ****************/
+
+#endif
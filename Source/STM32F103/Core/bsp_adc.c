@@ -4,59 +4,59 @@
 
 void bsp_adc_init(void)
 {
-    //ʱӳʼ
+    //时钟初始化
     RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA
-                           |RCC_APB2Periph_ADC1	, ENABLE );	  //ʹADC1ͨʱ
-    //GPIOʼ
+                           |RCC_APB2Periph_ADC1	, ENABLE );	  //使能ADC1通道时钟
+    //GPIO初始化
     {
         GPIO_InitTypeDef GPIO_InitStructure;
 
-        //PA1 Ϊģͨ
+        //PA1 作为模拟通道输入引脚
         GPIO_InitStructure.GPIO_Pin = GPIO_Pin_1;
-        GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AIN;		//ģ
+        GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AIN;		//模拟输入引脚
         GPIO_Init(GPIOA, &GPIO_InitStructure);
     }
-    //ADC ʼ
+    //ADC 初始化
     {
         ADC_InitTypeDef ADC_InitStructure;
 
-        RCC_ADCCLKConfig(RCC_PCLK2_Div6);   //ADCƵ6 72M/6=12,ADCʱ䲻ܳ14M
-        ADC_DeInit(ADC1);  //λADC1
+        RCC_ADCCLKConfig(RCC_PCLK2_Div6);   //设置ADC分频因子6 72M/6=12,ADC最大时间不能超过14M
+        ADC_DeInit(ADC1);  //复位ADC1
 
-        ADC_InitStructure.ADC_Mode = ADC_Mode_Independent;	//ADCģʽ:ADC1ADC2ڶģʽ
-        ADC_InitStructure.ADC_ScanConvMode = DISABLE;	//ģתڵͨģʽ
-        ADC_InitStructure.ADC_ContinuousConvMode = DISABLE;	//ģתڵתģʽ
-        ADC_InitStructure.ADC_ExternalTrigConv = ADC_ExternalTrigConv_None;	//תⲿ
-        ADC_InitStructure.ADC_DataAlign = ADC_DataAlign_Right;	//ADCҶ
-        ADC_InitStructure.ADC_NbrOfChannel = 1;	//˳йתADCͨĿ
-        ADC_Init(ADC1, &ADC_InitStructure);	//ADC_InitStructָĲʼADCxļĴ
+        ADC_InitStructure.ADC_Mode = ADC_Mode_Independent;	//ADC工作模式:ADC1和ADC2工作在独立模式
+        ADC_InitStructure.ADC_ScanConvMode = DISABLE;	//模数转换工作在单通道模式
+        ADC_InitStructure.ADC_ContinuousConvMode = DISABLE;	//模数转换工作在单次转换模式
+        ADC_InitStructure.ADC_ExternalTrigConv = ADC_ExternalTrigConv_None;	//转换由软件而不是外部触发启动
+        ADC_InitStructure.ADC_DataAlign = ADC_DataAlign_Right;	//ADC数据右对齐
+        ADC_InitStructure.ADC_NbrOfChannel = 1;	//顺序进行规则转换的ADC通道的数目
+        ADC_Init(ADC1, &ADC_InitStructure);	//根据ADC_InitStruct中指定的参数初始化外设ADCx的寄存器
 
-        ADC_Cmd(ADC1, ENABLE);	//ʹָADC1
+        ADC_Cmd(ADC1, ENABLE);	//使能指定的ADC1
 
-        ADC_ResetCalibration(ADC1);	//ʹܸλУ׼
+        ADC_ResetCalibration(ADC1);	//使能复位校准
 
-        while(ADC_GetResetCalibrationStatus(ADC1));	//ȴλУ׼
+        while(ADC_GetResetCalibrationStatus(ADC1));	//等待复位校准结束
 
-        ADC_StartCalibration(ADC1);	 //ADУ׼
+        ADC_StartCalibration(ADC1);	 //开启AD校准
 
-        while(ADC_GetCalibrationStatus(ADC1));	 //ȴУ׼
+        while(ADC_GetCalibrationStatus(ADC1));	 //等待校准结束
 
-        //	ADC_SoftwareStartConvCmd(ADC1, ENABLE);		//ʹָADC1ת
+        //	ADC_SoftwareStartConvCmd(ADC1, ENABLE);		//使能指定的ADC1的软件转换启动功能
     }
 }
-//ADCֵ
-//ch:ֵͨ 0~3 ADC_Channel_1
+//获得ADC值
+//ch:通道值 0~3 ADC_Channel_1
 
 u16 get_adc_value(u8 ch)
 {
-    //ָADCĹͨһУʱ
-    ADC_RegularChannelConfig(ADC1, ch, 1, ADC_SampleTime_239Cycles5 );	//ADC1,ADCͨ,ʱΪ239.5
+    //设置指定ADC的规则组通道，一个序列，采样时间
+    ADC_RegularChannelConfig(ADC1, ch, 1, ADC_SampleTime_239Cycles5 );	//ADC1,ADC通道,采样时间为239.5周期
 
-    ADC_SoftwareStartConvCmd(ADC1, ENABLE);		//ʹָADC1ת
+    ADC_SoftwareStartConvCmd(ADC1, ENABLE);		//使能指定的ADC1的软件转换启动功能
 
-    while(!ADC_GetFlagStatus(ADC1, ADC_FLAG_EOC ));//ȴת
+    while(!ADC_GetFlagStatus(ADC1, ADC_FLAG_EOC ));//等待转换结束
 
-    return ADC_GetConversionValue(ADC1);	//һADC1ת
+    return ADC_GetConversionValue(ADC1);	//返回最近一次ADC1规则组的转换结果
 }
 
 
@@ -1,27 +1,27 @@
-#ifndef _BSP_DAC_H
-#define _BSP_DAC_H
-#include "bsp_sys.h"
-
-
-
-void bsp_dac_init(void);
-void Dac1_Set_Vol(u16 vol);
-
-#endif
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+#ifndef _BSP_DAC_H
+#define _BSP_DAC_H
+#include "bsp_sys.h"
+
+
+
+void bsp_dac_init(void);
+void Dac1_Set_Vol(u16 vol);
+
+#endif
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
@@ -1,46 +1,56 @@
 #include "bsp_delay.h"
 
-static u8  fac_us=0;							//usʱ
-static u16 fac_ms=0;							//msʱ,ucos,ÿĵms
+static u8  fac_us=0;							//us延时倍乘数
+static u16 fac_ms=0;							//ms延时倍乘数,在ucos下,代表每个节拍的ms数
 
 void delay_init()
 {
-    SysTick_CLKSourceConfig(SysTick_CLKSource_HCLK_Div8);	//ѡⲿʱ  HCLK/8
-    fac_us=SystemCoreClock/8000000;				//Ϊϵͳʱӵ1/8
-    fac_ms=(u16)fac_us*1000;					//OS,ÿmsҪsystickʱ
+    SysTick_CLKSourceConfig(SysTick_CLKSource_HCLK_Div8);	//选择外部时钟  HCLK/8
+    fac_us=SystemCoreClock/8000000;				//为系统时钟的1/8
+    fac_ms=(u16)fac_us*1000;					//非OS下,代表每个ms需要的systick时钟数
+}
+
+//使能DWT周期计数器,计数频率为内核时钟
+//DWT_CYCCNT_REG为32位自由运行计数器,72M下约59.6秒溢出一次,计算差值时直接相减即可
+void delay_cycle_init()
+{
+    if(DWT_CTRL_REG & DWT_CTRL_CYCCNTENA) return;	//已经开启
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;	//开启跟踪单元
+    DWT_CYCCNT_REG = 0;
+    DWT_CTRL_REG |= DWT_CTRL_CYCCNTENA;				//开启周期计数
 }
 
 void delay_us(u32 nus)
 {
     u32 temp;
-    SysTick->LOAD=nus*fac_us; 					//ʱ
-    SysTick->VAL=0x00;        					//ռ
-    SysTick->CTRL|=SysTick_CTRL_ENABLE_Msk ;	//ʼ
+    SysTick->LOAD=nus*fac_us; 					//时间加载
+    SysTick->VAL=0x00;        					//清空计数器
+    SysTick->CTRL|=SysTick_CTRL_ENABLE_Msk ;	//开始倒数
     do
     {
         temp=SysTick->CTRL;
-    } while((temp&0x01)&&!(temp&(1<<16)));		//ȴʱ䵽
-    SysTick->CTRL&=~SysTick_CTRL_ENABLE_Msk;	//رռ
-    SysTick->VAL =0X00;      					 //ռ
+    } while((temp&0x01)&&!(temp&(1<<16)));		//等待时间到达
+    SysTick->CTRL&=~SysTick_CTRL_ENABLE_Msk;	//关闭计数器
+    SysTick->VAL =0X00;      					 //清空计数器
 }
-//ʱnms
-//עnmsķΧ
-//SysTick->LOADΪ24λĴ,,ʱΪ:
+//延时nms
+//注意nms的范围
+//SysTick->LOAD为24位寄存器,所以,最大延时为:
 //nms<=0xffffff*8*1000/SYSCLK
-//SYSCLKλΪHz,nmsλΪms
-//72M,nms<=1864
+//SYSCLK单位为Hz,nms单位为ms
+//对72M条件下,nms<=1864
 void delay_ms(u16 nms)
 {
     u32 temp;
-    SysTick->LOAD=(u32)nms*fac_ms;				//ʱ(SysTick->LOADΪ24bit)
-    SysTick->VAL =0x00;							//ռ
-    SysTick->CTRL|=SysTick_CTRL_ENABLE_Msk ;	//ʼ
+    SysTick->LOAD=(u32)nms*fac_ms;				//时间加载(SysTick->LOAD为24bit)
+    SysTick->VAL =0x00;							//清空计数器
+    SysTick->CTRL|=SysTick_CTRL_ENABLE_Msk ;	//开始倒数
     do
     {
         temp=SysTick->CTRL;
-    } while((temp&0x01)&&!(temp&(1<<16)));		//ȴʱ䵽
-    SysTick->CTRL&=~SysTick_CTRL_ENABLE_Msk;	//رռ
-    SysTick->VAL =0X00;       					//ռ
+    } while((temp&0x01)&&!(temp&(1<<16)));		//等待时间到达
+    SysTick->CTRL&=~SysTick_CTRL_ENABLE_Msk;	//关闭计数器
+    SysTick->VAL =0X00;       					//清空计数器
 }
 
 
@@ -3,7 +3,13 @@
 
 #include "stm32f10x.h"
 
+//DWT周期计数器（CMSIS core_cm3.h中未定义DWT结构体，这里直接按地址访问）
+#define DWT_CTRL_REG      (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT_REG    (*(volatile uint32_t *)0xE0001004)
+#define DWT_CTRL_CYCCNTENA (1ul << 0)
+
 void delay_init(void);
+void delay_cycle_init(void);
 void delay_us(u32 nus);
 void delay_ms(u16 nms);
 
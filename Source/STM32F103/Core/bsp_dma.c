@@ -1,81 +1,81 @@
-#include "bsp_dma.h"
-
-
-//DMA_InitTypeDef DMA_InitStructure;
-
-//u16 DMA1_MEM_LEN;//DMAÿݴ͵ĳ 	    
-////DMA1ĸͨ
-////Ĵʽǹ̶,Ҫݲͬ޸
-////Ӵ洢->ģʽ/8λݿ/洢ģʽ
-////DMA_CHx:DMAͨCHx
-////cpar:ַ
-////cmar:洢ַ
-////cndtr:ݴ
-
-//void MYDMA_Config(DMA_Channel_TypeDef* DMA_CHx,u32 cpar,u32 cmar,u16 cndtr)
-//{
-// 	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);	//ʹDMA
-//	
-//    DMA_DeInit(DMA_CHx);   //DMAͨ1ĴΪȱʡֵ
-//	DMA1_MEM_LEN=cndtr;
-//	DMA_InitStructure.DMA_PeripheralBaseAddr = cpar;  //DMAADCַ
-//	DMA_InitStructure.DMA_MemoryBaseAddr = cmar;  //DMAڴַ
-//	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;  //ݴ䷽򣬴ڴȡ͵
-//	DMA_InitStructure.DMA_BufferSize = cndtr;  //DMAͨDMAĴС
-//	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;  //ַĴ
-//	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;  //ڴַĴ
-//	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;  //ݿΪ8λ
-//	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte; //ݿΪ8λ
-//	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;  //ģʽ
-//	DMA_InitStructure.DMA_Priority = DMA_Priority_Medium; //DMAͨ xӵȼ 
-//	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;  //DMAͨxûΪڴ浽ڴ洫
-//	DMA_Init(DMA_CHx, &DMA_InitStructure);  //DMA_InitStructָĲʼDMAͨUSART1_Tx_DMA_ChannelʶļĴ
-//	  	
-//} 
-
-
-
-////һDMA
-//void MYDMA_Enable(DMA_Channel_TypeDef *DMA_CHx)
-//{ 
-//	DMA_Cmd(DMA_CHx, DISABLE );  //رUSART1 TX DMA1 ָʾͨ      
-// 	DMA_SetCurrDataCounter(DMA_CHx,DMA1_MEM_LEN);//DMAͨDMAĴС
-// 	DMA_Cmd(DMA_CHx, ENABLE);  //ʹUSART1 TX DMA1 ָʾͨ 
-//}	  
-
-
-void bsp_usart1_tx_dma_init(uint32_t MemoryBaseAddr,uint16_t BufferSize)
-{
-	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);	//ʹDMA
-	
-    DMA_DeInit(DMA1_Channel4);   //DMAͨ1ĴΪȱʡֵ
-
-	DMA_InitTypeDef DMA_InitStructure;
-	
-	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&USART1->DR;  //DMAADCַ
-	DMA_InitStructure.DMA_MemoryBaseAddr = MemoryBaseAddr;  //DMAڴַ
-	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;  //ݴ䷽򣬴ڴȡ͵
-	DMA_InitStructure.DMA_BufferSize = BufferSize;  //DMAͨDMAĴС
-	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;  //ַĴ
-	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;  //ڴַĴ
-	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;  //ݿΪ8λ
-	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte; //ݿΪ8λ
-	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;  //ģʽ
-	DMA_InitStructure.DMA_Priority = DMA_Priority_Medium; //DMAͨ xӵȼ 
-	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;  //DMAͨxûΪڴ浽ڴ洫
-	DMA_Init(DMA1_Channel4, &DMA_InitStructure);  //DMA_InitStructָĲʼDMAͨUSART1_Tx_DMA_ChannelʶļĴ
-	
-	USART_DMACmd(USART1,USART_DMAReq_Tx,ENABLE);
-	DMA_Cmd(DMA1_Channel4, DISABLE );
-}
-
-void usart1_tx_dma_once(uint16_t BufferSize)
-{
-	DMA_Cmd(DMA1_Channel4, DISABLE );  //رUSART1 TX DMA1 ָʾͨ      
- 	DMA_SetCurrDataCounter(DMA1_Channel4,BufferSize);//DMAͨDMAĴС
- 	DMA_Cmd(DMA1_Channel4, ENABLE);    //ʹUSART1 TX DMA1 ָʾͨ 
-}
-
-
-
-
+#include "bsp_dma.h"
+
+
+//DMA_InitTypeDef DMA_InitStructure;
+
+//u16 DMA1_MEM_LEN;//保存DMA每次数据传送的长度 	    
+////DMA1的各通道配置
+////这里的传输形式是固定的,这点要根据不同的情况来修改
+////从存储器->外设模式/8位数据宽度/存储器增量模式
+////DMA_CHx:DMA通道CHx
+////cpar:外设地址
+////cmar:存储器地址
+////cndtr:数据传输量
+
+//void MYDMA_Config(DMA_Channel_TypeDef* DMA_CHx,u32 cpar,u32 cmar,u16 cndtr)
+//{
+// 	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);	//使能DMA传输
+//	
+//    DMA_DeInit(DMA_CHx);   //将DMA的通道1寄存器重设为缺省值
+//	DMA1_MEM_LEN=cndtr;
+//	DMA_InitStructure.DMA_PeripheralBaseAddr = cpar;  //DMA外设ADC基地址
+//	DMA_InitStructure.DMA_MemoryBaseAddr = cmar;  //DMA内存基地址
+//	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;  //数据传输方向，从内存读取发送到外设
+//	DMA_InitStructure.DMA_BufferSize = cndtr;  //DMA通道的DMA缓存的大小
+//	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;  //外设地址寄存器不变
+//	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;  //内存地址寄存器递增
+//	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;  //数据宽度为8位
+//	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte; //数据宽度为8位
+//	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;  //工作在正常缓存模式
+//	DMA_InitStructure.DMA_Priority = DMA_Priority_Medium; //DMA通道 x拥有中优先级 
+//	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;  //DMA通道x没有设置为内存到内存传输
+//	DMA_Init(DMA_CHx, &DMA_InitStructure);  //根据DMA_InitStruct中指定的参数初始化DMA的通道USART1_Tx_DMA_Channel所标识的寄存器
+//	  	
+//} 
+
+
+
+////开启一次DMA传输
+//void MYDMA_Enable(DMA_Channel_TypeDef *DMA_CHx)
+//{ 
+//	DMA_Cmd(DMA_CHx, DISABLE );  //关闭USART1 TX DMA1 所指示的通道      
+// 	DMA_SetCurrDataCounter(DMA_CHx,DMA1_MEM_LEN);//DMA通道的DMA缓存的大小
+// 	DMA_Cmd(DMA_CHx, ENABLE);  //使能USART1 TX DMA1 所指示的通道 
+//}	  
+
+
+void bsp_usart1_tx_dma_init(uint32_t MemoryBaseAddr,uint16_t BufferSize)
+{
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);	//使能DMA传输
+	
+    DMA_DeInit(DMA1_Channel4);   //将DMA的通道1寄存器重设为缺省值
+
+	DMA_InitTypeDef DMA_InitStructure;
+	
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&USART1->DR;  //DMA外设ADC基地址
+	DMA_InitStructure.DMA_MemoryBaseAddr = MemoryBaseAddr;  //DMA内存基地址
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;  //数据传输方向，从内存读取发送到外设
+	DMA_InitStructure.DMA_BufferSize = BufferSize;  //DMA通道的DMA缓存的大小
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;  //外设地址寄存器不变
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;  //内存地址寄存器递增
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;  //数据宽度为8位
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte; //数据宽度为8位
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;  //工作在正常缓存模式
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Medium; //DMA通道 x拥有中优先级 
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;  //DMA通道x没有设置为内存到内存传输
+	DMA_Init(DMA1_Channel4, &DMA_InitStructure);  //根据DMA_InitStruct中指定的参数初始化DMA的通道USART1_Tx_DMA_Channel所标识的寄存器
+	
+	USART_DMACmd(USART1,USART_DMAReq_Tx,ENABLE);
+	DMA_Cmd(DMA1_Channel4, DISABLE );
+}
+
+void usart1_tx_dma_once(uint16_t BufferSize)
+{
+	DMA_Cmd(DMA1_Channel4, DISABLE );  //关闭USART1 TX DMA1 所指示的通道      
+ 	DMA_SetCurrDataCounter(DMA1_Channel4,BufferSize);//DMA通道的DMA缓存的大小
+ 	DMA_Cmd(DMA1_Channel4, ENABLE);    //使能USART1 TX DMA1 所指示的通道 
+}
+
+
+
+
@@ -1,28 +1,28 @@
-#ifndef _BSP_DMA_H
-#define	_BSP_DMA_H	   
-#include "bsp_sys.h"
-//////////////////////////////////////////////////////////////////////////////////	 
-//ֻѧϰʹãδɣκ;
-//ALIENTEK miniSTM32
-//DMA 	   
-//ԭ@ALIENTEK
-//̳:www.openedv.com
-//޸:2012/9/8
-//汾V1.0
-//ȨУؾ
-//Copyright(C) ӿƼ޹˾ 2009-2019
-//All rights reserved									  
-//////////////////////////////////////////////////////////////////////////////////
-							    					    
-
-//void MYDMA_Config(DMA_Channel_TypeDef*DMA_CHx,u32 cpar,u32 cmar,u16 cndtr);//DMA1_CHx
-
-//void MYDMA_Enable(DMA_Channel_TypeDef*DMA_CHx);//ʹDMA1_CHx
-		   
-void bsp_usart1_tx_dma_init(uint32_t MemoryBaseAddr,uint16_t BufferSize);
-void usart1_tx_dma_once(uint16_t BufferSize);
-		   
-#endif
-
-
-
+#ifndef _BSP_DMA_H
+#define	_BSP_DMA_H	   
+#include "bsp_sys.h"
+//////////////////////////////////////////////////////////////////////////////////	 
+//本程序只供学习使用，未经作者许可，不得用于其它任何用途
+//ALIENTEK miniSTM32开发板
+//DMA 代码	   
+//正点原子@ALIENTEK
+//技术论坛:www.openedv.com
+//修改日期:2012/9/8
+//版本：V1.0
+//版权所有，盗版必究。
+//Copyright(C) 广州市星翼电子科技有限公司 2009-2019
+//All rights reserved									  
+//////////////////////////////////////////////////////////////////////////////////
+							    					    
+
+//void MYDMA_Config(DMA_Channel_TypeDef*DMA_CHx,u32 cpar,u32 cmar,u16 cndtr);//配置DMA1_CHx
+
+//void MYDMA_Enable(DMA_Channel_TypeDef*DMA_CHx);//使能DMA1_CHx
+		   
+void bsp_usart1_tx_dma_init(uint32_t MemoryBaseAddr,uint16_t BufferSize);
+void usart1_tx_dma_once(uint16_t BufferSize);
+		   
+#endif
+
+
+
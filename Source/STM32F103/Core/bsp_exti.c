@@ -1,22 +1,33 @@
 #include "bsp_exti.h"
 
-/*
+static exti_callback_t exti0_callback = 0;
+
+/**
+  * @brief  注册PA0上升沿的回调函数（中断上下文中执行），例如MPU6050的INT引脚数据就绪
+  * @param  cb: 回调函数，0表示不处理
+  * @retval 
+  */
+void bsp_exti_set_callback(exti_callback_t cb)
+{
+	exti0_callback = cb;
+}
+
 void EXTI0_IRQHandler(void)
 {
 	if(EXTI_GetITStatus(EXTI_Line0)!= RESET)
 	{
-
 		EXTI_ClearITPendingBit(EXTI_Line0);
+		if(exti0_callback)
+			exti0_callback();
 	}
 }
-*/
 
 void bsp_exti_init()
 {
-    //ʱ
+    //打开时钟
     RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA,ENABLE);
     RCC_APB2PeriphClockCmd(RCC_APB2Periph_AFIO,ENABLE);
-    //ųʼ
+    //引脚初始化
     {
         GPIO_InitTypeDef GPIO_InitStruct;
 
@@ -25,7 +36,7 @@ void bsp_exti_init()
 
         GPIO_Init(GPIOA,&GPIO_InitStruct);
     }
-    //ж߳ʼ
+    //中断线初始化
     {
         EXTI_InitTypeDef EXTI_InitStructure;
 
@@ -36,17 +47,17 @@ void bsp_exti_init()
 
         EXTI_Init(&EXTI_InitStructure);
 
-        //ʼж
+        //初始化中断线
         GPIO_EXTILineConfig(GPIO_PortSourceGPIOA,GPIO_PinSource0);
     }
-    //NVICʼ
+    //NVIC初始化
     {
         NVIC_InitTypeDef NVIC_InitStructure;
 
-        NVIC_InitStructure.NVIC_IRQChannel = EXTI0_IRQn;			//ʹⲿжͨ
-        NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 5;	//ռȼ5
-        NVIC_InitStructure.NVIC_IRQChannelSubPriority =        0;	//ȼ0
-        NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;				//ʹⲿжͨ
+        NVIC_InitStructure.NVIC_IRQChannel = EXTI0_IRQn;			//使能外部中断通道
+        NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 5;	//抢占优先级5，
+        NVIC_InitStructure.NVIC_IRQChannelSubPriority =        0;	//子优先级0
+        NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;				//使能外部中断通道
 
         NVIC_Init(&NVIC_InitStructure);
     }
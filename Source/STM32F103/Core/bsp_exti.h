@@ -3,7 +3,10 @@
 
 #include "main.h"
 
+typedef void (*exti_callback_t)(void);
+
 void bsp_exti_init(void);
+void bsp_exti_set_callback(exti_callback_t cb);
 
 #endif
 
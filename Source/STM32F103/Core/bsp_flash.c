@@ -0,0 +1,116 @@
+#include "bsp_flash.h"
+#include <string.h>
+
+/**
+  * @brief  按字节取出小端32位字，末尾不足4字节时用0xFF补齐（与擦除后的Flash一致）
+  * @param  p 数据   left 剩余字节数
+  * @retval 32位字
+  */
+static uint32_t flash_store_word(const uint8_t *p, uint16_t left)
+{
+	uint32_t w = 0xFFFFFFFF;
+	uint8_t i;
+	for(i = 0; i < 4 && i < left; i++)
+	{
+		w &= ~((uint32_t)0xFF << (i * 8));
+		w |= (uint32_t)p[i] << (i * 8);
+	}
+	return w;
+}
+
+/**
+  * @brief  累加计算CRC32（片上CRC单元，多项式0x04C11DB7）
+  * @param  buf 数据   len 字节数
+  * @retval 当前CRC值
+  */
+static uint32_t flash_store_crc_feed(const uint8_t *buf, uint16_t len)
+{
+	uint16_t i;
+	for(i = 0; i < len; i += 4)
+		CRC->DR = flash_store_word(buf + i, len - i);
+	return CRC->DR;
+}
+
+/**
+  * @brief  计算一段数据的CRC32
+  * @note   也可以用作配置参数的散列值
+  * @param  buf 数据   len 字节数
+  * @retval CRC32
+  */
+uint32_t flash_store_crc32(const void *buf, uint16_t len)
+{
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_CRC, ENABLE);
+	CRC_ResetDR();
+	return flash_store_crc_feed((const uint8_t *)buf, len);
+}
+
+/**
+  * @brief  读取记录
+  * @param  tag 记录标签   buf 数据缓存   len 期望的数据长度
+  * @retval FLASH_STORE_OK 成功 其他 见 FLASH_STORE_xxx，失败时 buf 内容不变
+  */
+uint8_t flash_store_read(uint32_t tag, void *buf, uint16_t len)
+{
+	const uint8_t *page = (const uint8_t *)FLASH_STORE_ADDR;
+	uint16_t data_len = (len + 3) & ~3;
+	uint32_t crc;
+
+	if(len > FLASH_STORE_MAX_LEN)
+		return FLASH_STORE_BAD_LEN;
+	if(*(const uint32_t *)page != tag)
+		return FLASH_STORE_EMPTY;
+	if(*(const uint16_t *)(page + 4) != len)
+		return FLASH_STORE_BAD_LEN;
+	//头部和数据在Flash中是连续的，一次算完
+	crc = flash_store_crc32(page, FLASH_STORE_HEAD + len);
+	if(*(const uint32_t *)(page + FLASH_STORE_HEAD + data_len) != crc)
+		return FLASH_STORE_BAD_CRC;
+	memcpy(buf, page + FLASH_STORE_HEAD, len);
+	return FLASH_STORE_OK;
+}
+
+/**
+  * @brief  写入记录（覆盖整页）
+  * @note   擦除一页约20ms，期间从Flash取指的代码和中断都会停顿，不要在中断或实时循环中调用
+  * @param  tag 记录标签   buf 数据   len 数据长度
+  * @retval FLASH_STORE_OK 成功 其他 见 FLASH_STORE_xxx
+  */
+uint8_t flash_store_write(uint32_t tag, const void *buf, uint16_t len)
+{
+	const uint8_t *page = (const uint8_t *)FLASH_STORE_ADDR;
+	const uint8_t *p = (const uint8_t *)buf;
+	uint32_t addr = FLASH_STORE_ADDR;
+	uint32_t head[2];
+	uint32_t crc, w;
+	uint16_t i;
+	FLASH_Status st;
+
+	if(len > FLASH_STORE_MAX_LEN)
+		return FLASH_STORE_BAD_LEN;
+	head[0] = tag;
+	head[1] = 0xFFFF0000 | len;
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_CRC, ENABLE);
+	CRC_ResetDR();
+	flash_store_crc_feed((const uint8_t *)head, FLASH_STORE_HEAD);
+	crc = flash_store_crc_feed(p, len);
+
+	//与已保存的记录完全相同时不擦写，减少Flash磨损
+	if(memcmp(page, head, FLASH_STORE_HEAD) == 0 && memcmp(page + FLASH_STORE_HEAD, p, len) == 0 &&
+	   *(const uint32_t *)(page + FLASH_STORE_HEAD + ((len + 3) & ~3)) == crc)
+		return FLASH_STORE_OK;
+
+	FLASH_Unlock();
+	FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_PGERR | FLASH_FLAG_WRPRTERR);
+	st = FLASH_ErasePage(FLASH_STORE_ADDR);
+	for(i = 0; st == FLASH_COMPLETE && i < FLASH_STORE_HEAD; i += 4, addr += 4)
+		st = FLASH_ProgramWord(addr, head[i / 4]);
+	for(i = 0; st == FLASH_COMPLETE && i < len; i += 4, addr += 4)
+	{
+		w = flash_store_word(p + i, len - i);
+		st = FLASH_ProgramWord(addr, w);
+	}
+	if(st == FLASH_COMPLETE)
+		st = FLASH_ProgramWord(addr, crc);
+	FLASH_Lock();
+	return st == FLASH_COMPLETE ? FLASH_STORE_OK : FLASH_STORE_ERR_WRITE;
+}
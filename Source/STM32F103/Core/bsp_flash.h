@@ -0,0 +1,33 @@
+#ifndef _BSP_FLASH_H
+#define _BSP_FLASH_H
+
+#include <stdint.h>
+#include "stm32f10x.h"
+
+/****************** user port area start ****************/
+/**
+  * 参数保存区：内部Flash中保留给应用数据的一页，程序代码不能占用这一页
+  * 默认使用64KB器件的最后一页，Keil 中 IROM1 的大小需要相应减去 FLASH_STORE_PAGE_SIZE
+  */
+#define FLASH_STORE_ADDR        0x0800FC00
+#define FLASH_STORE_PAGE_SIZE   0x400        //中容量器件每页1KB，大容量器件为2KB
+/****************** user port area end   ****************/
+
+/**
+  * 记录格式（小端）：标签(4) | 数据长度(2) | 保留(2) | 数据(N，补齐到4字节) | CRC32(4)
+  * CRC32 由片上CRC单元计算，覆盖标签到数据末尾；标签区分记录类型和版本
+  */
+#define FLASH_STORE_HEAD        8
+#define FLASH_STORE_MAX_LEN     (FLASH_STORE_PAGE_SIZE - FLASH_STORE_HEAD - 4)
+
+#define FLASH_STORE_OK          0
+#define FLASH_STORE_EMPTY       1   //没有记录或标签不匹配
+#define FLASH_STORE_BAD_LEN     2   //长度不匹配或超出一页
+#define FLASH_STORE_BAD_CRC     3   //校验失败
+#define FLASH_STORE_ERR_WRITE   4   //擦除或编程失败
+
+uint32_t flash_store_crc32(const void *buf, uint16_t len);
+uint8_t flash_store_read(uint32_t tag, void *buf, uint16_t len);
+uint8_t flash_store_write(uint32_t tag, const void *buf, uint16_t len);
+
+#endif
@@ -0,0 +1,644 @@
+/**
+  ******************************************************************************
+  * @file    bsp_hard_i2c.c
+  * @author  liqinghua <liqinghuaxx@163.com>
+  * @version V1.0.0
+  * @date    2026-01-29
+  * @brief   硬件I2C异步传输模块（中断 + DMA）
+  *
+  * @copyright (c) 2026 liqinghua
+  *
+  * Permission is hereby granted, free of charge, to any person obtaining a copy
+  * of this software and associated documentation files (the "Software"), to deal
+  * in the Software without restriction, including without limitation the rights
+  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  * copies of the Software, and to permit persons to whom the Software is
+  * furnished to do so, subject to the following conditions:
+
+  * The above copyright notice and this permission notice shall be included in all
+  * copies or substantial portions of the Software.
+
+  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  * SOFTWARE.
+  *
+  * @details
+  *          本模块基于STM32F1硬件I2C实现寄存器读写的异步传输，整个传输过程由
+  *          事件中断驱动，调用者发起传输后立即返回，完成后在中断中执行回调。
+  *          支持的功能：
+  *          - 寄存器读：START -> 地址(写) -> 寄存器 -> 重复START -> 地址(读) -> 数据 -> STOP
+  *          - 寄存器写：START -> 地址(写) -> 寄存器 -> 数据 -> STOP
+  *          - 读取1字节、2字节时按 STM32F101/102/103xx 中容量勘误手册（ES096）I2C章节的流程，
+  *            清ADDR与设置STOP/读DR之间关中断，避免多收一个字节或丢失STOP
+  *          - 读取3字节及以上使用DMA接收（DMA1通道7），配合LAST位自动在最后一个字节回NACK，
+  *            14字节的IMU数据读取期间CPU只处理5次中断
+  *          - 每次传输按长度计算DWT超时，hard_i2c_wait/hard_i2c_is_busy 发现超时后中止传输，
+  *            用GPIO打时钟释放被从机拉住的SDA并复位I2C外设，以 HARD_I2C_ERR_TIMEOUT 结束
+  *
+  * @warning I2C1与软件I2C1共用PB6/PB7，两者只能初始化其中一个
+  */
+#include "bsp_hard_i2c.h"
+#include "bsp_i2c_trace.h"
+
+/****************** user port area start ****************/
+#include "bsp_delay.h"
+#include "main.h"
+
+#define HARD_I2C_TIMEOUT_US       1000   //传输超时基础值（us），含START/地址/寄存器阶段
+#define HARD_I2C_BYTE_TIMEOUT_US  100    //每个数据字节追加的超时（us），100kHz下一个字节约90us
+
+typedef struct {
+	I2C_TypeDef *i2c;
+	uint32_t i2c_rcc;               //I2C时钟（APB1）
+	GPIO_TypeDef *port;
+	uint32_t port_rcc;              //端口时钟（APB2）
+	uint16_t scl_pin;
+	uint16_t sda_pin;
+	DMA_Channel_TypeDef *dma_rx;    //接收DMA通道
+	uint32_t dma_rx_tc;             //接收DMA传输完成标志
+	uint8_t ev_irq;
+	uint8_t er_irq;
+	uint8_t dma_irq;
+}hard_i2c_hw_t;
+
+static const hard_i2c_hw_t hard_i2c_hw[HARD_I2C_BUS_NUM] = {
+	{ I2C1, RCC_APB1Periph_I2C1, GPIOB, RCC_APB2Periph_GPIOB, GPIO_Pin_6, GPIO_Pin_7,
+	  DMA1_Channel7, DMA1_FLAG_TC7, I2C1_EV_IRQn, I2C1_ER_IRQn, DMA1_Channel7_IRQn },
+};
+/****************** user port area end   ****************/
+
+typedef enum {
+	HARD_I2C_STATE_IDLE = 0,
+	HARD_I2C_STATE_START,       //等待SB，发送写地址
+	HARD_I2C_STATE_ADDR_W,      //等待ADDR，发送寄存器地址
+	HARD_I2C_STATE_REG,         //等待寄存器地址发送完成
+	HARD_I2C_STATE_TX,          //发送数据
+	HARD_I2C_STATE_RESTART,     //等待重复START的SB，发送读地址
+	HARD_I2C_STATE_ADDR_R,      //等待ADDR，按长度选择接收流程
+	HARD_I2C_STATE_RX_1,        //单字节接收，等待RXNE
+	HARD_I2C_STATE_RX_2,        //双字节接收，等待BTF
+	HARD_I2C_STATE_RX_DMA,      //DMA接收，等待DMA传输完成
+}hard_i2c_state_t;
+
+typedef struct {
+	volatile hard_i2c_state_t state;
+	volatile uint8_t status;    //最近一次传输结果
+	uint8_t addr;
+	uint8_t reg;
+	uint8_t read;               //1: 读 0: 写
+	uint8_t *buf;
+	uint16_t len;
+	uint16_t idx;
+	hard_i2c_callback_t callback;
+	hard_i2c_callback_t idle_hook;  //每次传输结束后调用（I2C队列借此在直接调用者释放总线后继续调度）
+	uint32_t start;             //传输开始时的DWT计数
+	uint32_t timeout;           //本次传输的超时周期数
+	uint32_t clock_speed;       //SCL频率，复位外设后按此重新配置
+}hard_i2c_ctx_t;
+
+static hard_i2c_ctx_t hard_i2c_ctx[HARD_I2C_BUS_NUM];
+
+/**
+  * @brief  复位并配置I2C外设
+  * @param  bus: I2C编号
+  * @retval 无
+  */
+static void hard_i2c_config(HARD_I2C_TypeDef bus)
+{
+	const hard_i2c_hw_t *hw = &hard_i2c_hw[bus];
+	I2C_InitTypeDef I2C_InitStructure;
+
+	I2C_DeInit(hw->i2c);
+	I2C_InitStructure.I2C_Mode = I2C_Mode_I2C;
+	I2C_InitStructure.I2C_DutyCycle = I2C_DutyCycle_2;
+	I2C_InitStructure.I2C_OwnAddress1 = 0x00;
+	I2C_InitStructure.I2C_Ack = I2C_Ack_Enable;
+	I2C_InitStructure.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
+	I2C_InitStructure.I2C_ClockSpeed = hard_i2c_ctx[bus].clock_speed;
+	I2C_Init(hw->i2c, &I2C_InitStructure);
+	I2C_Cmd(hw->i2c, ENABLE);
+}
+
+/**
+  * @brief  硬件I2C初始化
+  * @note   配置引脚为复用开漏，初始化I2C、接收DMA通道以及事件/错误/DMA中断
+  * @param  bus: I2C编号
+  *   @arg  HARD_I2C1: 硬件I2C1（SCL: PB6, SDA: PB7）
+  * @param  clock_speed: SCL频率（Hz），最大400000
+  * @retval 无
+  */
+void hard_i2c_init(HARD_I2C_TypeDef bus, uint32_t clock_speed)
+{
+	const hard_i2c_hw_t *hw;
+
+	if(bus >= HARD_I2C_BUS_NUM)
+		return;
+	hw = &hard_i2c_hw[bus];
+
+	RCC_APB2PeriphClockCmd(hw->port_rcc, ENABLE);
+	RCC_APB1PeriphClockCmd(hw->i2c_rcc, ENABLE);
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+	//GPIO设置
+	{
+		GPIO_InitTypeDef GPIO_InitStructure;
+
+		GPIO_InitStructure.GPIO_Pin = hw->scl_pin | hw->sda_pin;
+		GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+		GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_OD;  //复用开漏
+		GPIO_Init(hw->port, &GPIO_InitStructure);
+	}
+	//I2C设置
+	hard_i2c_ctx[bus].clock_speed = clock_speed;
+	hard_i2c_config(bus);
+	//接收DMA设置，内存地址和长度在每次传输时填写
+	{
+		DMA_InitTypeDef DMA_InitStructure;
+
+		DMA_DeInit(hw->dma_rx);
+		DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&hw->i2c->DR;
+		DMA_InitStructure.DMA_MemoryBaseAddr = 0;
+		DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;  //外设到内存
+		DMA_InitStructure.DMA_BufferSize = 1;
+		DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+		DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+		DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+		DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+		DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+		DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+		DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+		DMA_Init(hw->dma_rx, &DMA_InitStructure);
+		DMA_ITConfig(hw->dma_rx, DMA_IT_TC, ENABLE);
+	}
+	//NVIC设置
+	{
+		NVIC_InitTypeDef NVIC_InitStructure;
+
+		NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 2;	//抢占优先级2，高于串口和外部中断
+		NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+		NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+		NVIC_InitStructure.NVIC_IRQChannel = hw->ev_irq;
+		NVIC_Init(&NVIC_InitStructure);
+		NVIC_InitStructure.NVIC_IRQChannel = hw->er_irq;
+		NVIC_Init(&NVIC_InitStructure);
+		NVIC_InitStructure.NVIC_IRQChannel = hw->dma_irq;
+		NVIC_Init(&NVIC_InitStructure);
+	}
+
+	delay_cycle_init();  //传输超时使用DWT计数
+	hard_i2c_ctx[bus].state = HARD_I2C_STATE_IDLE;
+	hard_i2c_ctx[bus].status = HARD_I2C_OK;
+}
+
+/**
+  * @brief  结束一次传输：关闭缓冲/DMA请求，恢复ACK，执行回调
+  * @param  bus: I2C编号
+  * @param  status: 传输结果
+  * @retval 无
+  */
+static void hard_i2c_finish(HARD_I2C_TypeDef bus, uint8_t status)
+{
+	const hard_i2c_hw_t *hw = &hard_i2c_hw[bus];
+	hard_i2c_ctx_t *ctx = &hard_i2c_ctx[bus];
+
+	hw->i2c->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_DMAEN | I2C_CR2_LAST);
+	hw->i2c->CR1 &= ~I2C_CR1_POS;
+	hw->i2c->CR1 |= I2C_CR1_ACK;
+
+	I2C_TRACE_FLAG(I2C_TRACE_BUS_HARD(bus), status == HARD_I2C_ERR_NACK ? I2C_TRACE_F_NACK :
+	               status != HARD_I2C_OK ? I2C_TRACE_F_ERR : 0);
+	I2C_TRACE_STOP(I2C_TRACE_BUS_HARD(bus));
+
+	ctx->status = status;
+	ctx->state = HARD_I2C_STATE_IDLE;
+	if(ctx->callback)
+		ctx->callback(bus, status);
+	if(ctx->idle_hook)
+		ctx->idle_hook(bus, status);
+}
+
+/**
+  * @brief  按DWT计数忙等待（恢复时可能处于中断中，不使用SysTick延时）
+  * @param  cycles: 等待的内核周期数
+  * @retval 无
+  */
+static void hard_i2c_delay_cycles(uint32_t cycles)
+{
+	uint32_t start = DWT_CYCCNT_REG;
+
+	while(DWT_CYCCNT_REG - start < cycles);
+}
+
+/**
+  * @brief  总线恢复并复位I2C外设
+  * @details 引脚临时切换为通用开漏输出，SDA被从机拉低时最多打9个时钟让从机
+  *          送完当前字节，再产生STOP；最后复位I2C外设清除BUSY等内部状态并重新配置
+  * @param  bus: I2C编号
+  * @retval 无
+  */
+static void hard_i2c_recover(HARD_I2C_TypeDef bus)
+{
+	const hard_i2c_hw_t *hw = &hard_i2c_hw[bus];
+	uint32_t half = SystemCoreClock / 200000;  //5us，标准模式半个时钟周期
+	GPIO_InitTypeDef GPIO_InitStructure;
+	uint8_t i;
+
+	hw->dma_rx->CCR &= ~DMA_CCR1_EN;
+	I2C_Cmd(hw->i2c, DISABLE);
+
+	GPIO_SetBits(hw->port, hw->scl_pin | hw->sda_pin);
+	GPIO_InitStructure.GPIO_Pin = hw->scl_pin | hw->sda_pin;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD;
+	GPIO_Init(hw->port, &GPIO_InitStructure);
+	hard_i2c_delay_cycles(half);
+
+	for(i = 0; i < 9 && !GPIO_ReadInputDataBit(hw->port, hw->sda_pin); i++)
+	{
+		GPIO_ResetBits(hw->port, hw->scl_pin);
+		hard_i2c_delay_cycles(half);
+		GPIO_SetBits(hw->port, hw->scl_pin);
+		hard_i2c_delay_cycles(half);
+	}
+
+	//产生STOP，让从机状态机回到空闲
+	GPIO_ResetBits(hw->port, hw->scl_pin);
+	hard_i2c_delay_cycles(half);
+	GPIO_ResetBits(hw->port, hw->sda_pin);
+	hard_i2c_delay_cycles(half);
+	GPIO_SetBits(hw->port, hw->scl_pin);
+	hard_i2c_delay_cycles(half);
+	GPIO_SetBits(hw->port, hw->sda_pin);
+	hard_i2c_delay_cycles(half);
+
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_OD;
+	GPIO_Init(hw->port, &GPIO_InitStructure);
+	hard_i2c_config(bus);
+}
+
+/**
+  * @brief  中止超时的传输
+  * @note   关闭中断请求后恢复总线，以 HARD_I2C_ERR_TIMEOUT 结束传输（执行回调）
+  * @param  bus: I2C编号
+  * @retval 无
+  */
+static void hard_i2c_abort(HARD_I2C_TypeDef bus)
+{
+	const hard_i2c_hw_t *hw = &hard_i2c_hw[bus];
+	hard_i2c_ctx_t *ctx = &hard_i2c_ctx[bus];
+	uint32_t primask;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	if(ctx->state == HARD_I2C_STATE_IDLE)
+	{
+		//检查超时后传输恰好在中断中完成
+		__set_PRIMASK(primask);
+		return;
+	}
+	hw->i2c->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_ITERREN | I2C_CR2_DMAEN | I2C_CR2_LAST);
+	hw->dma_rx->CCR &= ~DMA_CCR1_EN;
+	__set_PRIMASK(primask);
+
+	hard_i2c_recover(bus);
+	hard_i2c_finish(bus, HARD_I2C_ERR_TIMEOUT);
+}
+
+/**
+  * @brief  检查当前传输是否超时，超时则中止
+  * @param  bus: I2C编号
+  * @retval 无
+  */
+static void hard_i2c_check_timeout(HARD_I2C_TypeDef bus)
+{
+	hard_i2c_ctx_t *ctx = &hard_i2c_ctx[bus];
+
+	if(ctx->state != HARD_I2C_STATE_IDLE && DWT_CYCCNT_REG - ctx->start > ctx->timeout)
+		hard_i2c_abort(bus);
+}
+
+/**
+  * @brief  发起一次传输（读写共用）
+  * @param  bus: I2C编号
+  * @param  addr: 设备地址（7位）
+  * @param  reg: 寄存器地址
+  * @param  buf: 数据缓冲区
+  * @param  len: 数据长度
+  * @param  read: 1读 0写
+  * @param  callback: 完成回调，可以为NULL
+  * @retval HARD_I2C_OK 已发起；其他值为错误码
+  */
+static uint8_t hard_i2c_xfer_start(HARD_I2C_TypeDef bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len, uint8_t read, hard_i2c_callback_t callback)
+{
+	const hard_i2c_hw_t *hw;
+	hard_i2c_ctx_t *ctx;
+	uint32_t primask;
+
+	if(bus >= HARD_I2C_BUS_NUM || (read && (buf == NULL || len == 0)))
+		return HARD_I2C_ERR_PARAM;
+	hw = &hard_i2c_hw[bus];
+	ctx = &hard_i2c_ctx[bus];
+
+	//检查并占用总线，主循环和中断（如INT引脚触发的读取）可能同时发起传输
+	primask = __get_PRIMASK();
+	__disable_irq();
+	if(ctx->state != HARD_I2C_STATE_IDLE)
+	{
+		__set_PRIMASK(primask);
+		return HARD_I2C_ERR_BUSY;
+	}
+	ctx->state = HARD_I2C_STATE_START;
+	ctx->start = DWT_CYCCNT_REG;
+	ctx->timeout = (SystemCoreClock / 1000000) * (HARD_I2C_TIMEOUT_US + (uint32_t)len * HARD_I2C_BYTE_TIMEOUT_US);
+	__set_PRIMASK(primask);
+
+	//上一次传输的STOP尚未发出时不能设置START（从回调中连续发起传输时会遇到）
+	while(hw->i2c->CR1 & I2C_CR1_STOP)
+	{
+		if(DWT_CYCCNT_REG - ctx->start > ctx->timeout)
+		{
+			//SCL被拉住，STOP一直发不出去
+			hard_i2c_recover(bus);
+			ctx->status = HARD_I2C_ERR_TIMEOUT;
+			ctx->state = HARD_I2C_STATE_IDLE;
+			if(ctx->idle_hook)
+				ctx->idle_hook(bus, HARD_I2C_ERR_TIMEOUT);
+			return HARD_I2C_ERR_TIMEOUT;
+		}
+	}
+
+	ctx->addr = addr;
+	ctx->reg = reg;
+	ctx->buf = buf;
+	ctx->len = len;
+	ctx->idx = 0;
+	ctx->read = read;
+	ctx->callback = callback;
+	I2C_TRACE_XFER(I2C_TRACE_BUS_HARD(bus), addr, reg, len, read);
+
+	if(read && len >= HARD_I2C_DMA_MIN_LEN)
+	{
+		hw->dma_rx->CCR &= ~DMA_CCR1_EN;
+		hw->dma_rx->CMAR = (uint32_t)buf;
+		hw->dma_rx->CNDTR = len;
+	}
+
+	hw->i2c->CR1 |= I2C_CR1_ACK;
+	hw->i2c->CR2 |= I2C_CR2_ITEVTEN | I2C_CR2_ITERREN;
+	hw->i2c->CR1 |= I2C_CR1_START;
+	return HARD_I2C_OK;
+}
+
+/**
+  * @brief  异步读取设备寄存器
+  * @details 函数发起传输后立即返回，数据接收完成（或出错）后在中断中调用 callback
+  * @param  bus: I2C编号
+  * @param  addr: 设备地址（7位，不包含读写位）
+  * @param  reg: 起始寄存器地址
+  * @param  buf: 接收缓冲区，传输完成前必须保持有效
+  * @param  len: 读取长度（>0）
+  * @param  callback: 完成回调，可以为NULL（之后用 hard_i2c_wait 等待）
+  * @retval HARD_I2C_OK: 已发起
+  * @retval HARD_I2C_ERR_BUSY: 总线正在传输
+  * @retval HARD_I2C_ERR_PARAM: 参数错误
+  * @retval HARD_I2C_ERR_TIMEOUT: 上一次传输的STOP无法发出，已复位总线
+  */
+uint8_t i2c_xfer_async(HARD_I2C_TypeDef bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len, hard_i2c_callback_t callback)
+{
+	return hard_i2c_xfer_start(bus, addr, reg, buf, len, 1, callback);
+}
+
+/**
+  * @brief  异步写设备寄存器
+  * @param  bus: I2C编号
+  * @param  addr: 设备地址（7位，不包含读写位）
+  * @param  reg: 起始寄存器地址
+  * @param  buf: 待写数据，传输完成前必须保持有效
+  * @param  len: 写入长度（可以为0，只写寄存器地址）
+  * @param  callback: 完成回调，可以为NULL
+  * @retval 同 i2c_xfer_async
+  */
+uint8_t i2c_write_async(HARD_I2C_TypeDef bus, uint8_t addr, uint8_t reg, const uint8_t *buf, uint16_t len, hard_i2c_callback_t callback)
+{
+	return hard_i2c_xfer_start(bus, addr, reg, (uint8_t *)buf, len, 0, callback);
+}
+
+/**
+  * @brief  设置总线空闲钩子
+  * @note   钩子在每次传输结束、完成回调执行之后调用，通常在中断上下文中
+  * @param  bus: I2C编号
+  * @param  hook: 钩子函数，NULL取消
+  * @retval 无
+  */
+void hard_i2c_set_idle_hook(HARD_I2C_TypeDef bus, hard_i2c_callback_t hook)
+{
+	if(bus < HARD_I2C_BUS_NUM)
+		hard_i2c_ctx[bus].idle_hook = hook;
+}
+
+/**
+  * @brief  查询总线是否正在传输
+  * @note   传输超时时在此中止并复位总线
+  * @param  bus: I2C编号
+  * @retval 1: 忙 0: 空闲
+  */
+uint8_t hard_i2c_is_busy(HARD_I2C_TypeDef bus)
+{
+	hard_i2c_check_timeout(bus);
+	return hard_i2c_ctx[bus].state != HARD_I2C_STATE_IDLE;
+}
+
+/**
+  * @brief  等待当前传输结束
+  * @note   超过传输超时时间时中止传输并复位总线，返回 HARD_I2C_ERR_TIMEOUT
+  * @param  bus: I2C编号
+  * @retval 最近一次传输的结果
+  */
+uint8_t hard_i2c_wait(HARD_I2C_TypeDef bus)
+{
+	while(hard_i2c_ctx[bus].state != HARD_I2C_STATE_IDLE)
+		hard_i2c_check_timeout(bus);
+	return hard_i2c_ctx[bus].status;
+}
+
+/**
+  * @brief  事件中断处理
+  * @param  bus: I2C编号
+  * @retval 无
+  */
+static void hard_i2c_ev_handler(HARD_I2C_TypeDef bus)
+{
+	const hard_i2c_hw_t *hw = &hard_i2c_hw[bus];
+	hard_i2c_ctx_t *ctx = &hard_i2c_ctx[bus];
+	I2C_TypeDef *I2Cx = hw->i2c;
+	uint16_t sr1 = I2Cx->SR1;
+
+	//EV5：START已发出，写地址
+	if(sr1 & I2C_SR1_SB)
+	{
+		if(ctx->state == HARD_I2C_STATE_START)
+		{
+			I2Cx->DR = ctx->addr << 1;
+			ctx->state = HARD_I2C_STATE_ADDR_W;
+		}
+		else if(ctx->state == HARD_I2C_STATE_RESTART)
+		{
+			if(ctx->len == 2)
+				I2Cx->CR1 |= I2C_CR1_POS;  //双字节接收：ACK作用于移位寄存器中的下一个字节
+			I2Cx->DR = (ctx->addr << 1) | 1;
+			ctx->state = HARD_I2C_STATE_ADDR_R;
+		}
+		return;
+	}
+
+	//EV6：地址已应答
+	if(sr1 & I2C_SR1_ADDR)
+	{
+		if(ctx->state == HARD_I2C_STATE_ADDR_W)
+		{
+			(void)I2Cx->SR2;
+			I2Cx->DR = ctx->reg;
+			ctx->state = HARD_I2C_STATE_REG;
+		}
+		else if(ctx->state == HARD_I2C_STATE_ADDR_R)
+		{
+			if(ctx->len == 1)
+			{
+				//单字节：清ADDR前关ACK，清ADDR与设置STOP之间不能被打断
+				I2Cx->CR1 &= ~I2C_CR1_ACK;
+				__disable_irq();
+				(void)I2Cx->SR2;
+				I2Cx->CR1 |= I2C_CR1_STOP;
+				__enable_irq();
+				I2Cx->CR2 |= I2C_CR2_ITBUFEN;
+				ctx->state = HARD_I2C_STATE_RX_1;
+			}
+			else if(ctx->len == 2)
+			{
+				//双字节：POS已置位，清ADDR后立即关ACK，等待两个字节都到齐（BTF）
+				__disable_irq();
+				(void)I2Cx->SR2;
+				I2Cx->CR1 &= ~I2C_CR1_ACK;
+				__enable_irq();
+				ctx->state = HARD_I2C_STATE_RX_2;
+			}
+			else
+			{
+				//多字节：交给DMA，LAST使最后一个字节自动回NACK
+				I2Cx->CR2 |= I2C_CR2_DMAEN | I2C_CR2_LAST;
+				hw->dma_rx->CCR |= DMA_CCR1_EN;
+				(void)I2Cx->SR2;
+				ctx->state = HARD_I2C_STATE_RX_DMA;
+			}
+		}
+		return;
+	}
+
+	//单字节接收完成（STOP已在EV6中设置）
+	if(ctx->state == HARD_I2C_STATE_RX_1)
+	{
+		if(sr1 & I2C_SR1_RXNE)
+		{
+			ctx->buf[0] = I2Cx->DR;
+			hard_i2c_finish(bus, HARD_I2C_OK);
+		}
+		return;
+	}
+
+	if(!(sr1 & I2C_SR1_BTF))
+		return;
+
+	//EV8_2：字节发送完成
+	switch(ctx->state)
+	{
+		case HARD_I2C_STATE_REG:
+			if(ctx->read)
+			{
+				I2Cx->CR1 |= I2C_CR1_START;  //重复START，同时清除BTF
+				ctx->state = HARD_I2C_STATE_RESTART;
+				break;
+			}
+			ctx->state = HARD_I2C_STATE_TX;
+			//fall through
+		case HARD_I2C_STATE_TX:
+			if(ctx->idx < ctx->len)
+			{
+				I2Cx->DR = ctx->buf[ctx->idx++];
+			}
+			else
+			{
+				I2Cx->CR1 |= I2C_CR1_STOP;
+				hard_i2c_finish(bus, HARD_I2C_OK);
+			}
+			break;
+		case HARD_I2C_STATE_RX_2:
+			//EV7_3：DR和移位寄存器中各有一个字节，设置STOP后连续读出
+			__disable_irq();
+			I2Cx->CR1 |= I2C_CR1_STOP;
+			ctx->buf[0] = I2Cx->DR;
+			__enable_irq();
+			ctx->buf[1] = I2Cx->DR;
+			hard_i2c_finish(bus, HARD_I2C_OK);
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+  * @brief  错误中断处理
+  * @param  bus: I2C编号
+  * @retval 无
+  */
+static void hard_i2c_er_handler(HARD_I2C_TypeDef bus)
+{
+	const hard_i2c_hw_t *hw = &hard_i2c_hw[bus];
+	I2C_TypeDef *I2Cx = hw->i2c;
+	uint16_t sr1 = I2Cx->SR1;
+	uint16_t err = sr1 & (I2C_SR1_AF | I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_OVR);
+
+	if(err == 0)
+		return;
+	I2Cx->SR1 = (uint16_t)~err;  //写0清除错误标志
+	hw->dma_rx->CCR &= ~DMA_CCR1_EN;
+	if(!(err & I2C_SR1_ARLO))
+		I2Cx->CR1 |= I2C_CR1_STOP;  //仲裁丢失时已自动退回从模式，不能再发STOP
+	if(hard_i2c_ctx[bus].state != HARD_I2C_STATE_IDLE)
+		hard_i2c_finish(bus, (err & I2C_SR1_AF) ? HARD_I2C_ERR_NACK : HARD_I2C_ERR_BUS);
+}
+
+/**
+  * @brief  接收DMA完成处理
+  * @note   DMA模式下STOP需要在DMA传输完成中断中设置（EV7_1由LAST自动完成）
+  * @param  bus: I2C编号
+  * @retval 无
+  */
+static void hard_i2c_dma_rx_handler(HARD_I2C_TypeDef bus)
+{
+	const hard_i2c_hw_t *hw = &hard_i2c_hw[bus];
+
+	if(DMA_GetFlagStatus(hw->dma_rx_tc) == RESET)
+		return;
+	DMA_ClearFlag(hw->dma_rx_tc);
+	hw->dma_rx->CCR &= ~DMA_CCR1_EN;
+	hw->i2c->CR1 |= I2C_CR1_STOP;
+	hard_i2c_finish(bus, HARD_I2C_OK);
+}
+
+void I2C1_EV_IRQHandler(void)
+{
+	hard_i2c_ev_handler(HARD_I2C1);
+}
+
+void I2C1_ER_IRQHandler(void)
+{
+	hard_i2c_er_handler(HARD_I2C1);
+}
+
+void DMA1_Channel7_IRQHandler(void)
+{
+	hard_i2c_dma_rx_handler(HARD_I2C1);
+}
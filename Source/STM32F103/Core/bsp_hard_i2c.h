@@ -0,0 +1,34 @@
+#ifndef _BSP_HARD_I2C_H
+#define _BSP_HARD_I2C_H
+
+#include <stdint.h>
+#include "stm32f10x.h"
+
+typedef enum {
+	HARD_I2C1 = 0,
+	HARD_I2C_BUS_NUM
+}HARD_I2C_TypeDef;
+
+/* 传输结果 */
+#define HARD_I2C_OK          0   //传输完成
+#define HARD_I2C_ERR_NACK    1   //从机无应答
+#define HARD_I2C_ERR_BUS     2   //总线错误或仲裁丢失
+#define HARD_I2C_ERR_BUSY    3   //上一次传输尚未结束
+#define HARD_I2C_ERR_PARAM   4   //参数错误
+#define HARD_I2C_ERR_TIMEOUT 6   //传输超时，已复位总线（5为 bus_ops 的 BUS_ERR_UNSUPPORTED）
+
+//RX长度不小于该值时使用DMA接收，1、2字节按勘误手册的专用流程用中断接收
+#define HARD_I2C_DMA_MIN_LEN 3
+
+/* 传输完成回调，在中断上下文中执行 */
+typedef void (*hard_i2c_callback_t)(HARD_I2C_TypeDef bus, uint8_t status);
+
+void hard_i2c_init(HARD_I2C_TypeDef bus, uint32_t clock_speed);
+
+uint8_t i2c_xfer_async(HARD_I2C_TypeDef bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len, hard_i2c_callback_t callback);
+uint8_t i2c_write_async(HARD_I2C_TypeDef bus, uint8_t addr, uint8_t reg, const uint8_t *buf, uint16_t len, hard_i2c_callback_t callback);
+void hard_i2c_set_idle_hook(HARD_I2C_TypeDef bus, hard_i2c_callback_t hook);
+uint8_t hard_i2c_is_busy(HARD_I2C_TypeDef bus);
+uint8_t hard_i2c_wait(HARD_I2C_TypeDef bus);
+
+#endif
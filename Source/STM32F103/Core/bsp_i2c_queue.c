@@ -0,0 +1,380 @@
+/**
+  ******************************************************************************
+  * @file    bsp_i2c_queue.c
+  * @author  liqinghua <liqinghuaxx@163.com>
+  * @version V1.0.0
+  * @date    2026-01-29
+  * @brief   I2C传输队列模块
+  *
+  * @copyright (c) 2026 liqinghua
+  *
+  * Permission is hereby granted, free of charge, to any person obtaining a copy
+  * of this software and associated documentation files (the "Software"), to deal
+  * in the Software without restriction, including without limitation the rights
+  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  * copies of the Software, and to permit persons to whom the Software is
+  * furnished to do so, subject to the following conditions:
+
+  * The above copyright notice and this permission notice shall be included in all
+  * copies or substantial portions of the Software.
+
+  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  * SOFTWARE.
+  *
+  * @details
+  *          多个设备驱动共用一条硬件I2C总线时，各自提交请求到本队列，由队列
+  *          按顺序交给 bsp_hard_i2c 异步执行，驱动无需阻塞等待总线。
+  *          基于 bus_ops 的驱动通过 bus_i2c_queue 获取的总线实例接入本队列。
+  *          支持的功能：
+  *          - 按优先级排序，同优先级按截止时间剩余量排序，再按提交顺序
+  *          - 同一设备上地址相邻或重叠的读请求合并为一次突发读取
+  *          - 统计队列深度、等待时间、截止时间超时次数，便于性能分析
+  *          - 总线被直接调用 bsp_hard_i2c 的代码占用时请求继续排队，占用结束后自动发起
+  *
+  * @note    合并读取依赖设备寄存器地址自动递增，FIFO等寄存器需设置 no_merge
+  */
+#include "bsp_i2c_queue.h"
+#include <string.h>
+
+/****************** user port area start ****************/
+#include "bsp_delay.h"
+#include "main.h"
+
+//时间基准使用DWT周期计数器
+#define i2c_queue_now()            (DWT_CYCCNT_REG)
+#define i2c_queue_cycles_to_us(c)  ((c) / (SystemCoreClock / 1000000))
+#define i2c_queue_us_to_cycles(u)  ((u) * (SystemCoreClock / 1000000))
+/****************** user port area end   ****************/
+
+typedef enum {
+	I2C_SLOT_FREE = 0,
+	I2C_SLOT_PENDING,      //等待传输
+	I2C_SLOT_ACTIVE,       //正在传输
+}i2c_slot_state_t;
+
+typedef struct {
+	i2c_request_t req;
+	uint32_t submit_time;  //提交时刻（周期数）
+	uint32_t seq;          //提交序号，保证同条件下先进先出
+	i2c_slot_state_t state;
+}i2c_slot_t;
+
+typedef struct {
+	i2c_slot_t slot[I2C_QUEUE_DEPTH];
+	uint8_t merge_buf[I2C_QUEUE_MERGE_MAX];
+	uint8_t active_reg;    //当前传输的起始寄存器
+	uint8_t active_merged; //当前传输是否使用合并缓冲区
+	uint8_t running;       //总线上有队列发起的传输
+	uint32_t seq;
+	i2c_queue_stats_t stats;
+}i2c_queue_t;
+
+static i2c_queue_t i2c_queue[HARD_I2C_BUS_NUM];
+
+static void i2c_queue_dispatch(HARD_I2C_TypeDef bus);
+
+/**
+  * @brief  总线空闲钩子：任何传输（包括直接调用 bsp_hard_i2c 的）结束后继续调度
+  * @param  bus: I2C编号
+  * @param  status: 传输结果（未使用）
+  * @retval 无
+  */
+static void i2c_queue_idle(HARD_I2C_TypeDef bus, uint8_t status)
+{
+	(void)status;
+	i2c_queue_dispatch(bus);
+}
+
+/**
+  * @brief  I2C队列初始化
+  * @note   需要先调用 hard_i2c_init 初始化总线
+  * @param  bus: I2C编号
+  * @retval 无
+  */
+void i2c_queue_init(HARD_I2C_TypeDef bus)
+{
+	if(bus >= HARD_I2C_BUS_NUM)
+		return;
+	memset(&i2c_queue[bus], 0, sizeof(i2c_queue_t));
+	delay_cycle_init();
+	hard_i2c_set_idle_hook(bus, i2c_queue_idle);
+}
+
+/**
+  * @brief  计算请求距离截止时间还剩多少周期
+  * @param  s: 请求槽
+  * @param  now: 当前时刻
+  * @retval 剩余周期数（已超时为负），无截止时间返回最大值
+  */
+static int32_t i2c_queue_slack(const i2c_slot_t *s, uint32_t now)
+{
+	if(s->req.deadline_us == 0)
+		return 0x7FFFFFFF;
+	return (int32_t)(i2c_queue_us_to_cycles(s->req.deadline_us) - (now - s->submit_time));
+}
+
+/**
+  * @brief  挑选下一个要传输的请求
+  * @param  q: 队列
+  * @param  now: 当前时刻
+  * @retval 请求槽下标，没有等待的请求返回-1
+  */
+static int i2c_queue_pick(i2c_queue_t *q, uint32_t now)
+{
+	int i, best = -1;
+	int32_t best_slack = 0, slack;
+
+	for(i = 0; i < I2C_QUEUE_DEPTH; i++)
+	{
+		const i2c_slot_t *s = &q->slot[i];
+		if(s->state != I2C_SLOT_PENDING)
+			continue;
+		slack = i2c_queue_slack(s, now);
+		if(best < 0 ||
+		   s->req.priority < q->slot[best].req.priority ||
+		   (s->req.priority == q->slot[best].req.priority &&
+		    (slack < best_slack || (slack == best_slack && (int32_t)(s->seq - q->slot[best].seq) < 0))))
+		{
+			best = i;
+			best_slack = slack;
+		}
+	}
+	return best;
+}
+
+/**
+  * @brief  把同一设备上地址相邻或重叠的读请求并入当前传输
+  * @param  q: 队列
+  * @param  first: 已选中的请求（状态已设为ACTIVE）
+  * @param  lo: 输入输出，合并后的起始寄存器
+  * @param  hi: 输入输出，合并后的结束寄存器（不含）
+  * @retval 并入的请求数
+  */
+static uint8_t i2c_queue_merge(i2c_queue_t *q, const i2c_slot_t *first, uint16_t *lo, uint16_t *hi)
+{
+	uint8_t changed, count = 0;
+	uint16_t s_lo, s_hi, n_lo, n_hi;
+	int i;
+
+	if(first->req.no_merge)
+		return 0;
+	do
+	{
+		changed = 0;
+		for(i = 0; i < I2C_QUEUE_DEPTH; i++)
+		{
+			i2c_slot_t *s = &q->slot[i];
+			if(s->state != I2C_SLOT_PENDING || !s->req.read || s->req.no_merge ||
+			   s->req.addr != first->req.addr)
+				continue;
+			s_lo = s->req.reg;
+			s_hi = s_lo + s->req.len;
+			if(s_lo > *hi || s_hi < *lo)
+				continue;  //既不相邻也不重叠
+			n_lo = s_lo < *lo ? s_lo : *lo;
+			n_hi = s_hi > *hi ? s_hi : *hi;
+			if(n_hi - n_lo > I2C_QUEUE_MERGE_MAX)
+				continue;
+			*lo = n_lo;
+			*hi = n_hi;
+			s->state = I2C_SLOT_ACTIVE;
+			count++;
+			changed = 1;
+		}
+	}while(changed);
+	return count;
+}
+
+/**
+  * @brief  底层传输完成回调：分发数据、统计并启动下一次传输
+  * @param  bus: I2C编号
+  * @param  status: 传输结果
+  * @retval 无
+  */
+static void i2c_queue_done(HARD_I2C_TypeDef bus, uint8_t status)
+{
+	i2c_queue_t *q = &i2c_queue[bus];
+	uint32_t now = i2c_queue_now();
+	int i;
+
+	for(i = 0; i < I2C_QUEUE_DEPTH; i++)
+	{
+		i2c_slot_t *s = &q->slot[i];
+		if(s->state != I2C_SLOT_ACTIVE)
+			continue;
+		if(q->active_merged && status == HARD_I2C_OK)
+			memcpy(s->req.buf, &q->merge_buf[s->req.reg - q->active_reg], s->req.len);
+		if(s->req.deadline_us && i2c_queue_slack(s, now) < 0)
+			q->stats.deadline_miss++;
+		q->stats.completed++;
+		q->stats.depth--;
+		s->state = I2C_SLOT_FREE;
+		if(s->req.callback)
+			s->req.callback(status, s->req.arg);
+	}
+	q->running = 0;
+	i2c_queue_dispatch(bus);
+}
+
+/**
+  * @brief  总线空闲时取出下一个请求发起传输
+  * @note   总线被直接调用 bsp_hard_i2c 的用户占用时，请求退回等待状态，
+  *         由空闲钩子在其传输结束后再次调度
+  * @param  bus: I2C编号
+  * @retval 无
+  */
+static void i2c_queue_dispatch(HARD_I2C_TypeDef bus)
+{
+	i2c_queue_t *q = &i2c_queue[bus];
+	uint32_t primask, now, wait, wait_total, wait_max;
+	uint16_t lo, hi;
+	uint8_t *buf, ret, merged;
+	i2c_slot_t *s;
+	int i;
+
+	for(;;)
+	{
+		primask = __get_PRIMASK();
+		__disable_irq();
+		if(q->running || (i = i2c_queue_pick(q, now = i2c_queue_now())) < 0)
+		{
+			__set_PRIMASK(primask);
+			return;
+		}
+		s = &q->slot[i];
+		s->state = I2C_SLOT_ACTIVE;
+		lo = s->req.reg;
+		hi = lo + s->req.len;
+		merged = 0;
+		if(s->req.read)
+			merged = i2c_queue_merge(q, s, &lo, &hi);
+		q->active_merged = merged ? 1 : 0;
+		q->active_reg = lo;
+		q->running = 1;
+
+		//等待时间，传输发起成功后再计入统计
+		wait_total = 0;
+		wait_max = 0;
+		for(i = 0; i < I2C_QUEUE_DEPTH; i++)
+		{
+			if(q->slot[i].state != I2C_SLOT_ACTIVE)
+				continue;
+			wait = i2c_queue_cycles_to_us(now - q->slot[i].submit_time);
+			wait_total += wait;
+			if(wait > wait_max)
+				wait_max = wait;
+		}
+		__set_PRIMASK(primask);
+
+		buf = q->active_merged ? q->merge_buf : s->req.buf;
+		if(s->req.read)
+			ret = i2c_xfer_async(bus, s->req.addr, lo, buf, hi - lo, i2c_queue_done);
+		else
+			ret = i2c_write_async(bus, s->req.addr, lo, buf, s->req.len, i2c_queue_done);
+		if(ret != HARD_I2C_ERR_BUSY)
+			break;
+
+		//总线被占用：请求退回等待状态，不算失败
+		primask = __get_PRIMASK();
+		__disable_irq();
+		for(i = 0; i < I2C_QUEUE_DEPTH; i++)
+		{
+			if(q->slot[i].state == I2C_SLOT_ACTIVE)
+				q->slot[i].state = I2C_SLOT_PENDING;
+		}
+		q->running = 0;
+		q->stats.busy_retry++;
+		__set_PRIMASK(primask);
+
+		//占用者可能在退回期间已经结束（其空闲钩子看到running而直接返回），此时重试
+		if(hard_i2c_is_busy(bus))
+			return;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	q->stats.transfers++;
+	q->stats.merged += merged;
+	q->stats.wait_us_total += wait_total;
+	if(wait_max > q->stats.wait_us_max)
+		q->stats.wait_us_max = wait_max;
+	__set_PRIMASK(primask);
+
+	if(ret != HARD_I2C_OK)
+		i2c_queue_done(bus, ret);
+}
+
+/**
+  * @brief  提交一个I2C请求
+  * @details 请求被复制进队列，总线空闲时立即开始传输，否则排队等待。
+  *          完成后在中断上下文中调用 req->callback
+  * @param  bus: I2C编号
+  * @param  req: 请求描述（函数返回后即可释放，但 req->buf 必须保持有效直到完成）
+  * @retval 0: 已提交
+  * @retval 1: 队列已满或参数错误
+  */
+uint8_t i2c_queue_submit(HARD_I2C_TypeDef bus, const i2c_request_t *req)
+{
+	i2c_queue_t *q;
+	uint32_t primask;
+	int i;
+
+	if(bus >= HARD_I2C_BUS_NUM || req == NULL || (req->read && req->len == 0))
+		return 1;
+	q = &i2c_queue[bus];
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	for(i = 0; i < I2C_QUEUE_DEPTH; i++)
+	{
+		if(q->slot[i].state == I2C_SLOT_FREE)
+			break;
+	}
+	if(i == I2C_QUEUE_DEPTH)
+	{
+		q->stats.rejected++;
+		__set_PRIMASK(primask);
+		return 1;
+	}
+	q->slot[i].req = *req;
+	q->slot[i].submit_time = i2c_queue_now();
+	q->slot[i].seq = q->seq++;
+	q->slot[i].state = I2C_SLOT_PENDING;
+	q->stats.submitted++;
+	q->stats.depth++;
+	if(q->stats.depth > q->stats.depth_max)
+		q->stats.depth_max = q->stats.depth;
+	__set_PRIMASK(primask);
+
+	i2c_queue_dispatch(bus);
+	return 0;
+}
+
+/**
+  * @brief  获取队列统计信息
+  * @param  bus: I2C编号
+  * @retval 统计信息指针
+  */
+const i2c_queue_stats_t *i2c_queue_get_stats(HARD_I2C_TypeDef bus)
+{
+	return &i2c_queue[bus].stats;
+}
+
+/**
+  * @brief  清零队列统计信息（保留当前深度）
+  * @param  bus: I2C编号
+  * @retval 无
+  */
+void i2c_queue_clear_stats(HARD_I2C_TypeDef bus)
+{
+	uint16_t depth = i2c_queue[bus].stats.depth;
+
+	memset(&i2c_queue[bus].stats, 0, sizeof(i2c_queue_stats_t));
+	i2c_queue[bus].stats.depth = depth;
+	i2c_queue[bus].stats.depth_max = depth;
+}
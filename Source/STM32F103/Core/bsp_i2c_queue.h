@@ -0,0 +1,45 @@
+#ifndef _BSP_I2C_QUEUE_H
+#define _BSP_I2C_QUEUE_H
+
+#include <stdint.h>
+#include "bsp_hard_i2c.h"
+
+#define I2C_QUEUE_DEPTH       16   //每条总线最多排队的请求数
+#define I2C_QUEUE_MERGE_MAX   32   //合并读取的最大字节数（合并缓冲区大小）
+
+/* 请求完成回调，在中断上下文中执行 */
+typedef void (*i2c_queue_callback_t)(uint8_t status, void *arg);
+
+typedef struct {
+	uint8_t addr;                  //设备地址（7位）
+	uint8_t reg;                   //起始寄存器地址
+	uint8_t read;                  //1: 读 0: 写
+	uint8_t priority;              //优先级，数值越小越优先
+	uint8_t no_merge;              //1: 禁止与其他请求合并（如FIFO等不自动递增地址的寄存器）
+	uint8_t *buf;                  //数据缓冲区，完成前必须保持有效
+	uint16_t len;                  //数据长度
+	uint32_t deadline_us;          //从提交起的截止时间（us），0表示不限
+	i2c_queue_callback_t callback; //完成回调，可以为NULL
+	void *arg;                     //回调参数
+}i2c_request_t;
+
+typedef struct {
+	uint16_t depth;                //当前排队数（含正在传输的）
+	uint16_t depth_max;            //历史最大排队数
+	uint32_t submitted;            //提交总数
+	uint32_t completed;            //完成总数
+	uint32_t rejected;             //队列满被拒绝的次数
+	uint32_t merged;               //被合并进其他请求的次数
+	uint32_t transfers;            //实际发起的总线传输次数
+	uint32_t busy_retry;           //总线被直接调用者占用、推迟到其结束后再发起的次数
+	uint32_t deadline_miss;        //超过截止时间才完成的次数
+	uint32_t wait_us_max;          //提交到开始传输的最大等待时间
+	uint32_t wait_us_total;        //等待时间累计（平均值 = wait_us_total / completed）
+}i2c_queue_stats_t;
+
+void i2c_queue_init(HARD_I2C_TypeDef bus);
+uint8_t i2c_queue_submit(HARD_I2C_TypeDef bus, const i2c_request_t *req);
+const i2c_queue_stats_t *i2c_queue_get_stats(HARD_I2C_TypeDef bus);
+void i2c_queue_clear_stats(HARD_I2C_TypeDef bus);
+
+#endif
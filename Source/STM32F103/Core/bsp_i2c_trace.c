@@ -0,0 +1,481 @@
+/**
+  ******************************************************************************
+  * @file    bsp_i2c_trace.c
+  * @author  liqinghua <liqinghuaxx@163.com>
+  * @version V1.0.0
+  * @date    2026-01-29
+  * @brief   I2C总线跟踪模块
+  *
+  * @copyright (c) 2026 liqinghua
+  *
+  * Permission is hereby granted, free of charge, to any person obtaining a copy
+  * of this software and associated documentation files (the "Software"), to deal
+  * in the Software without restriction, including without limitation the rights
+  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  * copies of the Software, and to permit persons to whom the Software is
+  * furnished to do so, subject to the following conditions:
+
+  * The above copyright notice and this permission notice shall be included in all
+  * copies or substantial portions of the Software.
+
+  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  * SOFTWARE.
+  *
+  * @details
+  *          软件I2C和硬件I2C驱动在START、发送字节、接收、应答失败、STOP等位置
+  *          调用跟踪钩子，本模块把每次传输整理成一条记录：
+  *          - 记录写入固定大小的环形缓冲区，多个生产者（主循环、中断）用
+  *            LDREX/STREX 预留位置，不关中断；缓冲区满时丢弃并计数
+  *          - 按设备统计传输时间的对数直方图和最大值
+  *          - 主循环调用 i2c_trace_drain / i2c_trace_drain_hist 通过USART1 DMA
+  *            以二进制帧发出（帧格式见 bsp_i2c_trace.h）
+  *
+  * @note    I2C_TRACE_ENABLE 为0时钩子展开为空语句，本文件也不产生任何代码
+  * @note    drain 使用 DMA1_Channel4（USART1 TX），不能与其他 USART1 DMA 发送同时使用
+  */
+#include "bsp_i2c_trace.h"
+
+#if I2C_TRACE_ENABLE
+
+#include <string.h>
+#include "bsp_delay.h"
+#include "bsp_dma.h"
+
+#define I2C_TRACE_MASK   (I2C_TRACE_DEPTH - 1)
+
+/* 正在进行的传输（每条总线一份，只被该总线的驱动访问） */
+typedef struct {
+	uint32_t start;
+	uint16_t len;
+	uint8_t active;
+	uint8_t nbyte;          //本次START之后发送的字节数
+	uint8_t addr;
+	uint8_t reg;
+	uint8_t flags;
+}i2c_trace_cur_t;
+
+static i2c_trace_cur_t i2c_trace_cur[2][I2C_TRACE_BUS_PER_TYPE];
+
+static i2c_trace_rec_t i2c_trace_ring[I2C_TRACE_DEPTH];
+static volatile uint32_t i2c_trace_head = 0;    //已预留的记录总数
+static volatile uint32_t i2c_trace_tail = 0;    //已取走的记录总数
+static volatile uint32_t i2c_trace_drop = 0;    //缓冲区满丢弃的记录数
+
+static i2c_trace_hist_t i2c_trace_hist[I2C_TRACE_DEV_MAX];
+
+static uint8_t i2c_trace_tx_buf[4 + 3 + I2C_TRACE_FRAME_RECS * 14 + 1];
+static uint8_t i2c_trace_dma_ready = 0;
+
+#define i2c_trace_cur_of(bus)  (&i2c_trace_cur[(bus) >> 4][(bus) & (I2C_TRACE_BUS_PER_TYPE - 1)])
+
+/**
+  * @brief  原子加
+  * @param  p: 目标地址
+  * @param  v: 增量
+  * @retval 无
+  */
+static void i2c_trace_atomic_add(volatile uint32_t *p, uint32_t v)
+{
+	uint32_t x;
+	do {
+		x = __LDREXW((uint32_t *)p) + v;
+	} while(__STREXW(x, (uint32_t *)p));
+}
+
+/**
+  * @brief  原子取最大值
+  * @param  p: 目标地址
+  * @param  v: 新值
+  * @retval 无
+  */
+static void i2c_trace_atomic_max(volatile uint32_t *p, uint32_t v)
+{
+	do {
+		if(__LDREXW((uint32_t *)p) >= v)
+		{
+			__CLREX();
+			return;
+		}
+	} while(__STREXW(v, (uint32_t *)p));
+}
+
+/**
+  * @brief  查找（不存在则占用）设备的直方图
+  * @param  key: 设备键值
+  * @retval 直方图指针，表已满返回NULL
+  */
+static i2c_trace_hist_t *i2c_trace_hist_of(uint32_t key)
+{
+	uint8_t i;
+	uint32_t cur;
+
+	for(i = 0; i < I2C_TRACE_DEV_MAX; i++)
+	{
+		volatile uint32_t *k = &i2c_trace_hist[i].key;
+		do {
+			cur = __LDREXW((uint32_t *)k);
+			if(cur != 0)
+			{
+				__CLREX();
+				break;
+			}
+		} while(__STREXW(key, (uint32_t *)k));
+		if(cur == 0 || cur == key)
+			return &i2c_trace_hist[i];
+	}
+	return NULL;
+}
+
+/**
+  * @brief  提交一条记录：写入环形缓冲区并更新直方图
+  * @param  bus: 总线编号
+  * @param  cur: 传输状态
+  * @retval 无
+  */
+static void i2c_trace_commit(uint8_t bus, const i2c_trace_cur_t *cur)
+{
+	i2c_trace_rec_t *rec;
+	i2c_trace_hist_t *h;
+	uint32_t now = DWT_CYCCNT_REG;
+	uint32_t cycles = now - cur->start;
+	uint32_t us = cycles / (SystemCoreClock / 1000000);
+	uint32_t pos;
+	uint8_t bin;
+
+	//预留一个位置
+	do {
+		pos = __LDREXW((uint32_t *)&i2c_trace_head);
+		if(pos - i2c_trace_tail >= I2C_TRACE_DEPTH)
+		{
+			__CLREX();
+			i2c_trace_atomic_add(&i2c_trace_drop, 1);
+			pos = 0xFFFFFFFF;
+			break;
+		}
+	} while(__STREXW(pos + 1, (uint32_t *)&i2c_trace_head));
+
+	if(pos != 0xFFFFFFFF)
+	{
+		rec = &i2c_trace_ring[pos & I2C_TRACE_MASK];
+		rec->start  = cur->start;
+		rec->cycles = cycles;
+		rec->len    = cur->len;
+		rec->bus    = bus;
+		rec->addr   = cur->addr;
+		rec->reg    = cur->reg;
+		rec->flags  = cur->flags;
+		__DMB();
+		rec->seq    = (uint8_t)((pos / I2C_TRACE_DEPTH) | 0x80);  //最后写提交标记，读取方据此判断记录已完整
+	}
+
+	h = i2c_trace_hist_of(0x8000 | ((uint32_t)bus << 8) | cur->addr);
+	if(h != NULL)
+	{
+		for(bin = 0; bin < I2C_TRACE_HIST_BINS - 1 && (us >> (bin + 1)) != 0; bin++);
+		i2c_trace_atomic_add(&h->hist[bin], 1);
+		i2c_trace_atomic_add(&h->count, 1);
+		i2c_trace_atomic_max(&h->max_us, us);
+	}
+}
+
+/**
+  * @brief  跟踪钩子：START（含重复START）
+  * @param  bus: 总线编号
+  * @retval 无
+  */
+void i2c_trace_start(uint8_t bus)
+{
+	i2c_trace_cur_t *cur = i2c_trace_cur_of(bus);
+
+	if(!cur->active)
+	{
+		cur->active = 1;
+		cur->start = DWT_CYCCNT_REG;
+		cur->len = 0;
+		cur->addr = 0;
+		cur->reg = 0;
+		cur->flags = 0;
+	}
+	cur->nbyte = 0;
+}
+
+/**
+  * @brief  跟踪钩子：主机发送一个字节
+  * @note   START后第1个字节为地址，写传输的第2个字节记为寄存器地址
+  *         （没有寄存器地址的写入，第1个数据字节同样会记在 reg 中）
+  * @param  bus: 总线编号
+  * @param  byte: 发送的字节
+  * @retval 无
+  */
+void i2c_trace_tx(uint8_t bus, uint8_t byte)
+{
+	i2c_trace_cur_t *cur = i2c_trace_cur_of(bus);
+
+	if(!cur->active)
+		return;
+	if(cur->nbyte == 0)
+	{
+		cur->addr = byte >> 1;
+		if(byte & 1)
+			cur->flags |= I2C_TRACE_F_READ;
+	}
+	else if(cur->nbyte == 1 && !(cur->flags & (I2C_TRACE_F_READ | I2C_TRACE_F_REG)))
+	{
+		cur->reg = byte;
+		cur->flags |= I2C_TRACE_F_REG;
+	}
+	else
+	{
+		cur->len++;
+	}
+	cur->nbyte++;
+}
+
+/**
+  * @brief  跟踪钩子：主机接收数据
+  * @param  bus: 总线编号
+  * @param  n: 接收字节数
+  * @retval 无
+  */
+void i2c_trace_rx(uint8_t bus, uint16_t n)
+{
+	i2c_trace_cur_of(bus)->len += n;
+}
+
+/**
+  * @brief  跟踪钩子：置位标志（无应答、错误）
+  * @param  bus: 总线编号
+  * @param  flags: I2C_TRACE_F_xxx
+  * @retval 无
+  */
+void i2c_trace_flag(uint8_t bus, uint8_t flags)
+{
+	i2c_trace_cur_of(bus)->flags |= flags;
+}
+
+/**
+  * @brief  跟踪钩子：STOP，结束本次传输并提交记录
+  * @param  bus: 总线编号
+  * @retval 无
+  */
+void i2c_trace_stop(uint8_t bus)
+{
+	i2c_trace_cur_t *cur = i2c_trace_cur_of(bus);
+
+	if(!cur->active)
+		return;
+	cur->active = 0;
+	i2c_trace_commit(bus, cur);
+}
+
+/**
+  * @brief  跟踪钩子：硬件I2C发起一次完整传输（地址、寄存器、长度已知）
+  * @param  bus: 总线编号
+  * @param  addr: 设备地址
+  * @param  reg: 寄存器地址
+  * @param  len: 数据长度
+  * @param  read: 1读 0写
+  * @retval 无
+  */
+void i2c_trace_xfer(uint8_t bus, uint8_t addr, uint8_t reg, uint16_t len, uint8_t read)
+{
+	i2c_trace_cur_t *cur = i2c_trace_cur_of(bus);
+
+	cur->active = 1;
+	cur->start = DWT_CYCCNT_REG;
+	cur->len = len;
+	cur->addr = addr;
+	cur->reg = reg;
+	cur->flags = I2C_TRACE_F_REG | (read ? I2C_TRACE_F_READ : 0);
+	cur->nbyte = 0;
+}
+
+/**
+  * @brief  跟踪模块初始化，清空缓冲区和直方图
+  * @retval 无
+  */
+void i2c_trace_init(void)
+{
+	delay_cycle_init();
+	memset(i2c_trace_cur, 0, sizeof(i2c_trace_cur));
+	memset(i2c_trace_hist, 0, sizeof(i2c_trace_hist));
+	i2c_trace_tail = i2c_trace_head;
+	i2c_trace_drop = 0;
+}
+
+/**
+  * @brief  取出一条记录（只允许一个读取方，通常为主循环）
+  * @param  rec: 记录保存地址
+  * @retval 1: 取到记录 0: 缓冲区为空或最早的记录尚未写完
+  */
+uint8_t i2c_trace_read(i2c_trace_rec_t *rec)
+{
+	uint32_t t = i2c_trace_tail;
+	const i2c_trace_rec_t *src;
+
+	if(t == i2c_trace_head)
+		return 0;
+	src = &i2c_trace_ring[t & I2C_TRACE_MASK];
+	if(src->seq != (uint8_t)((t / I2C_TRACE_DEPTH) | 0x80))
+		return 0;
+	__DMB();
+	*rec = *src;
+	__DMB();
+	i2c_trace_tail = t + 1;
+	return 1;
+}
+
+/**
+  * @brief  获取缓冲区满而丢弃的记录数
+  * @retval 丢弃数
+  */
+uint32_t i2c_trace_dropped(void)
+{
+	return i2c_trace_drop;
+}
+
+/**
+  * @brief  获取设备延时直方图
+  * @param  idx: 序号（0 ~ I2C_TRACE_DEV_MAX-1）
+  * @retval 直方图指针，该位置未使用时返回NULL
+  */
+const i2c_trace_hist_t *i2c_trace_get_hist(uint8_t idx)
+{
+	if(idx >= I2C_TRACE_DEV_MAX || i2c_trace_hist[idx].key == 0)
+		return NULL;
+	return &i2c_trace_hist[idx];
+}
+
+/****************** user port area start ****************/
+/**
+  * @brief  查询USART1 DMA是否空闲
+  * @retval 1: 空闲 0: 正在发送
+  */
+static uint8_t i2c_trace_tx_idle(void)
+{
+	if(!i2c_trace_dma_ready)
+	{
+		bsp_usart1_tx_dma_init((uint32_t)i2c_trace_tx_buf, 0);
+		i2c_trace_dma_ready = 1;
+		return 1;
+	}
+	return DMA_GetCurrDataCounter(DMA1_Channel4) == 0;
+}
+
+/**
+  * @brief  启动一帧发送
+  * @param  len: 帧长度
+  * @retval 无
+  */
+static void i2c_trace_tx_start(uint16_t len)
+{
+	usart1_tx_dma_once(len);
+}
+/****************** user port area end   ****************/
+
+static uint8_t *i2c_trace_put16(uint8_t *p, uint16_t v)
+{
+	*p++ = (uint8_t)v;
+	*p++ = (uint8_t)(v >> 8);
+	return p;
+}
+
+static uint8_t *i2c_trace_put32(uint8_t *p, uint32_t v)
+{
+	p = i2c_trace_put16(p, (uint16_t)v);
+	return i2c_trace_put16(p, (uint16_t)(v >> 16));
+}
+
+/**
+  * @brief  封装帧头和校验后发送
+  * @param  type: 帧类型
+  * @param  end: 负载结束位置
+  * @retval 无
+  */
+static void i2c_trace_send_frame(uint8_t type, uint8_t *end)
+{
+	uint8_t *p = &i2c_trace_tx_buf[4];
+	uint8_t sum = 0;
+
+	i2c_trace_tx_buf[0] = 0xA5;
+	i2c_trace_tx_buf[1] = 0x5A;
+	i2c_trace_tx_buf[2] = type;
+	i2c_trace_tx_buf[3] = (uint8_t)(end - p);
+	while(p < end)
+		sum += *p++;
+	*end++ = sum;
+	i2c_trace_tx_start((uint16_t)(end - i2c_trace_tx_buf));
+}
+
+/**
+  * @brief  把缓冲区中的记录打包成一帧从USART1发出
+  * @note   非阻塞，上一帧还在发送时直接返回；在主循环中周期调用
+  * @retval 本次发出的记录数
+  */
+uint8_t i2c_trace_drain(void)
+{
+	i2c_trace_rec_t rec;
+	uint8_t *p;
+	uint8_t n = 0;
+
+	if(i2c_trace_head == i2c_trace_tail || !i2c_trace_tx_idle())
+		return 0;
+
+	p = &i2c_trace_tx_buf[4];
+	*p++ = (uint8_t)(SystemCoreClock / 1000000);
+	p = i2c_trace_put16(p, (uint16_t)i2c_trace_drop);
+	while(n < I2C_TRACE_FRAME_RECS && i2c_trace_read(&rec))
+	{
+		p = i2c_trace_put32(p, rec.start);
+		p = i2c_trace_put32(p, rec.cycles);
+		p = i2c_trace_put16(p, rec.len);
+		*p++ = rec.bus;
+		*p++ = rec.addr;
+		*p++ = rec.reg;
+		*p++ = rec.flags;
+		n++;
+	}
+	if(n)
+		i2c_trace_send_frame(I2C_TRACE_FRAME_REC, p);
+	return n;
+}
+
+/**
+  * @brief  依次发出各设备的延时直方图，每次调用发送一个设备
+  * @note   非阻塞，上一帧还在发送时直接返回
+  * @retval 1: 发出了一帧 0: 未发送（DMA忙或没有数据）
+  */
+uint8_t i2c_trace_drain_hist(void)
+{
+	static uint8_t idx = 0;
+	const i2c_trace_hist_t *h;
+	uint8_t *p;
+	uint8_t i, tries;
+
+	if(!i2c_trace_tx_idle())
+		return 0;
+	for(tries = 0; tries < I2C_TRACE_DEV_MAX; tries++)
+	{
+		h = i2c_trace_get_hist(idx);
+		idx = (idx + 1) % I2C_TRACE_DEV_MAX;
+		if(h == NULL)
+			continue;
+		p = &i2c_trace_tx_buf[4];
+		*p++ = (uint8_t)((h->key >> 8) & 0x7F);
+		*p++ = (uint8_t)h->key;
+		p = i2c_trace_put32(p, h->count);
+		p = i2c_trace_put32(p, h->max_us);
+		for(i = 0; i < I2C_TRACE_HIST_BINS; i++)
+			p = i2c_trace_put32(p, h->hist[i]);
+		i2c_trace_send_frame(I2C_TRACE_FRAME_HIST, p);
+		return 1;
+	}
+	return 0;
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef _BSP_I2C_TRACE_H
+#define _BSP_I2C_TRACE_H
+
+#include <stdint.h>
+#include "stm32f10x.h"
+
+/****************** user port area start ****************/
+#define I2C_TRACE_ENABLE      0     //1: 开启I2C跟踪 0: 关闭（钩子全部展开为空，不产生任何代码）
+#define I2C_TRACE_DEPTH       64    //环形缓冲区记录数，必须为2的幂
+#define I2C_TRACE_DEV_MAX     8     //延时直方图最多统计的设备数
+#define I2C_TRACE_HIST_BINS   12    //直方图桶数：第n个桶统计 [2^n, 2^(n+1)) us，最后一个桶包含所有更大的值
+/****************** user port area end   ****************/
+
+/* 总线编号：高4位为总线类型，低4位为该类型下的编号 */
+#define I2C_TRACE_BUS_SOFT(n)   (0x00 | (n))
+#define I2C_TRACE_BUS_HARD(n)   (0x10 | (n))
+#define I2C_TRACE_BUS_PER_TYPE  4
+
+/* 记录标志 */
+#define I2C_TRACE_F_READ      0x01  //读传输
+#define I2C_TRACE_F_NACK      0x02  //从机无应答
+#define I2C_TRACE_F_ERR       0x04  //时钟拉伸超时、总线错误等
+#define I2C_TRACE_F_REG       0x08  //reg 字段有效
+
+/* 一次传输（START到STOP）的记录 */
+typedef struct {
+	uint32_t start;         //开始时刻（DWT周期数）
+	uint32_t cycles;        //持续时间（周期数）
+	uint16_t len;           //数据字节数（不含地址和寄存器地址）
+	uint8_t bus;            //总线编号，见 I2C_TRACE_BUS_xxx
+	uint8_t addr;           //设备地址（7位）
+	uint8_t reg;            //寄存器地址
+	uint8_t flags;          //I2C_TRACE_F_xxx
+	uint8_t seq;            //提交标记，内部使用
+	uint8_t rsv;
+}i2c_trace_rec_t;
+
+/* 单个设备的延时直方图 */
+typedef struct {
+	uint32_t key;           //0x8000 | 总线编号<<8 | 设备地址，0表示未使用
+	uint32_t count;         //传输次数
+	uint32_t max_us;        //最长一次传输（us）
+	uint32_t hist[I2C_TRACE_HIST_BINS];
+}i2c_trace_hist_t;
+
+/**
+  * USART1 二进制帧格式（小端）：
+  *   0xA5 0x5A | 类型(1) | 负载长度N(1) | 负载(N) | 校验(1，负载字节累加和的低8位)
+  * 类型 0x01 传输记录：
+  *   CPU频率MHz(1) | 丢弃计数(2) | 记录 x K，每条14字节：
+  *   start(4) cycles(4) len(2) bus(1) addr(1) reg(1) flags(1)
+  * 类型 0x02 延时直方图（每个设备一帧）：
+  *   bus(1) addr(1) count(4) max_us(4) hist(4 x I2C_TRACE_HIST_BINS)
+  */
+#define I2C_TRACE_FRAME_REC    0x01
+#define I2C_TRACE_FRAME_HIST   0x02
+#define I2C_TRACE_FRAME_RECS   16    //每帧最多携带的记录数
+
+#if I2C_TRACE_ENABLE
+
+void i2c_trace_start(uint8_t bus);
+void i2c_trace_tx(uint8_t bus, uint8_t byte);
+void i2c_trace_rx(uint8_t bus, uint16_t n);
+void i2c_trace_flag(uint8_t bus, uint8_t flags);
+void i2c_trace_stop(uint8_t bus);
+void i2c_trace_xfer(uint8_t bus, uint8_t addr, uint8_t reg, uint16_t len, uint8_t read);
+
+/* 总线驱动中的跟踪钩子 */
+#define I2C_TRACE_START(bus)                       i2c_trace_start(bus)
+#define I2C_TRACE_TX(bus, byte)                    i2c_trace_tx(bus, byte)
+#define I2C_TRACE_RX(bus, n)                       i2c_trace_rx(bus, n)
+#define I2C_TRACE_FLAG(bus, f)                     i2c_trace_flag(bus, f)
+#define I2C_TRACE_STOP(bus)                        i2c_trace_stop(bus)
+#define I2C_TRACE_XFER(bus, addr, reg, len, read)  i2c_trace_xfer(bus, addr, reg, len, read)
+
+void i2c_trace_init(void);
+uint8_t i2c_trace_read(i2c_trace_rec_t *rec);
+uint32_t i2c_trace_dropped(void);
+const i2c_trace_hist_t *i2c_trace_get_hist(uint8_t idx);
+uint8_t i2c_trace_drain(void);
+uint8_t i2c_trace_drain_hist(void);
+
+#else
+
+#define I2C_TRACE_START(bus)                       ((void)0)
+#define I2C_TRACE_TX(bus, byte)                    ((void)0)
+#define I2C_TRACE_RX(bus, n)                       ((void)0)
+#define I2C_TRACE_FLAG(bus, f)                     ((void)0)
+#define I2C_TRACE_STOP(bus)                        ((void)0)
+#define I2C_TRACE_XFER(bus, addr, reg, len, read)  ((void)0)
+
+#endif
+
+#endif
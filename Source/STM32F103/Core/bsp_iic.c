@@ -3,23 +3,23 @@
 #include "bsp_delay.h"
 
 
-//IICʼ
+//IIC初始化
 void IIC_Init(void)
 {
     GPIO_InitTypeDef GPIO_InitStructure;
 
-    //˿ʱ
+    //开启端口时钟
     RCC_APB2PeriphClockCmd(IIC_SCL_PORT_RCC | IIC_SDA_PORT_RCC, ENABLE);
 
-    //SCLSDA
+    //配置SCL、SDA引脚
     GPIO_InitStructure.GPIO_Pin = IIC_SCL_PIN;
     GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD; //
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD; //推挽输出
     GPIO_Init(IIC_SCL_PORT, &GPIO_InitStructure);
 
     GPIO_InitStructure.GPIO_Pin = IIC_SDA_PIN;
     GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD; //
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD; //推挽输出
     GPIO_Init(IIC_SDA_PORT, &GPIO_InitStructure);
 
     IIC_SDA_1;
@@ -32,35 +32,35 @@ void IIC_Delay()
 	//for (int i = 0; i < 10; i++);
 }
 
-//IICʼź
+//产生IIC起始信号
 void IIC_Start(void)
 {
-    SDA_OUT();     //sda
+    SDA_OUT();     //sda线输出
     IIC_SDA_1;
     IIC_SCL_1;
     IIC_Delay();
     IIC_SDA_0;//START:when CLK is high,DATA change form high to low
     IIC_Delay();
-    IIC_SCL_0;//ǯסI2Cߣ׼ͻ
+    IIC_SCL_0;//钳住I2C总线，准备发送或接收数据
 }
-//IICֹͣź
+//产生IIC停止信号
 void IIC_Stop(void)
 {
-    SDA_OUT();//sda
+    SDA_OUT();//sda线输出
     IIC_SCL_0;
     IIC_SDA_0;//STOP:when CLK is high DATA change form low to high
     IIC_Delay();
     IIC_SCL_1;
-    IIC_SDA_1;//I2C߽ź
+    IIC_SDA_1;//发送I2C总线结束信号
     IIC_Delay();
 }
-//ȴӦźŵ
-//ֵ1Ӧʧ
-//        0Ӧɹ
+//等待应答信号到来
+//返回值：1，接收应答失败
+//        0，接收应答成功
 uint8_t IIC_Wait_Ack(void)
 {
     uint8_t ucErrTime=0;
-    SDA_IN();      //SDAΪ
+    SDA_IN();      //SDA设置为输入
     IIC_SDA_1;
     IIC_Delay();
     IIC_SCL_1;
@@ -74,10 +74,10 @@ uint8_t IIC_Wait_Ack(void)
             return 1;
         }
     }
-    IIC_SCL_0;//ʱ0
+    IIC_SCL_0;//时钟输出0
     return 0;
 }
-//ACKӦ
+//产生ACK应答
 void IIC_Ack(void)
 {
     IIC_SCL_0;
@@ -88,7 +88,7 @@ void IIC_Ack(void)
     IIC_Delay();
     IIC_SCL_0;
 }
-//ACKӦ
+//不产生ACK应答
 void IIC_NAck(void)
 {
     IIC_SCL_0;
@@ -99,31 +99,31 @@ void IIC_NAck(void)
     IIC_Delay();
     IIC_SCL_0;
 }
-//IICһֽ
-//شӻӦ
-//1Ӧ
-//0Ӧ
+//IIC发送一个字节
+//返回从机有无应答
+//1，有应答
+//0，无应答
 void IIC_Send_Byte(uint8_t txd)
 {
     uint8_t t;
     SDA_OUT();
-    IIC_SCL_0;//ʱӿʼݴ
+    IIC_SCL_0;//拉低时钟开始数据传输
     for(t=0; t<8; t++)
     {
         IIC_SDA=(txd&0x80)>>7;
         txd<<=1;
-        IIC_Delay();   //TEA5767ʱǱ
+        IIC_Delay();   //对TEA5767这三个延时都是必须的
         IIC_SCL_1;
         IIC_Delay();
         IIC_SCL_0;
         IIC_Delay();
     }
 }
-//1ֽڣack=1ʱACKack=0nACK
+//读1个字节，ack=1时，发送ACK，ack=0，发送nACK
 uint8_t IIC_Read_Byte(unsigned char ack)
 {
     unsigned char i,receive=0;
-    SDA_IN();//SDAΪ
+    SDA_IN();//SDA设置为输入
     for(i=0; i<8; i++ )
     {
         IIC_SCL_0;
@@ -134,9 +134,9 @@ uint8_t IIC_Read_Byte(unsigned char ack)
         IIC_Delay();
     }
     if (!ack)
-        IIC_NAck();//nACK
+        IIC_NAck();//发送nACK
     else
-        IIC_Ack(); //ACK
+        IIC_Ack(); //发送ACK
     return receive;
 }
 
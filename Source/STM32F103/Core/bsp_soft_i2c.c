@@ -1,558 +1,1183 @@
-/**
-  ******************************************************************************
-  * @file    bsp_soft_i2c.c
-  * @author  liqinghua <liqinghuaxx@163.com>
-  * @version V1.0.0
-  * @date    2026-01-29
-  * @brief   I2Cģ
-  *
-  * @copyright (c) 2026 liqinghua
-  * 
-  * Permission is hereby granted, free of charge, to any person obtaining a copy
-  * of this software and associated documentation files (the "Software"), to deal
-  * in the Software without restriction, including without limitation the rights
-  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-  * copies of the Software, and to permit persons to whom the Software is
-  * furnished to do so, subject to the following conditions:
-
-  * The above copyright notice and this permission notice shall be included in all
-  * copies or substantial portions of the Software.
-
-  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-  * SOFTWARE.
-  *
-  * @details 
-  *          ģʵֻGPIOI2Cͨţֶ֧I2Cߡ
-  *          ֵ֧Ĺܣ
-  *          - I2Cʼ
-  *          - I2C߿ƣʼֹͣӦȣ
-  *          - ֽڶд
-  *          - ֽڶд
-  *
-  * @warning ųʼʱʹÿ©ģʽGPIO_Mode_Out_OD
-  */  
-#include "bsp_soft_i2c.h"
-
-/****************** user port area start ****************/
-#include "bsp_delay.h"
-#include "main.h"
-
-/**
-  * @brief  I2Cʱ΢뼶
-  * @note   ʱʱڿI2CߵʱƵ
-  * @param  
-  * @retval 
-  */
-void soft_i2c_delay_us()
-{
-	delay_us(4);
-}
-
-/**
-  * @brief  I2Cģʼ
-  * @note   ע⣺ųʼһҪǿ©ģʽGPIO_Mode_Out_OD
-  *         SCL: PB6, SDA: PB7
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @retval 
-  */
-void soft_i2c_init(SOFT_I2C_TypeDef soft_i2c)
-{
-	if(soft_i2c == SOFT_I2C1){
-		GPIO_InitTypeDef GPIO_InitStructure;
-		//˿ʱ
-		RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB, ENABLE);
-
-		//SCLSDA
-		GPIO_InitStructure.GPIO_Pin = GPIO_Pin_6 | GPIO_Pin_7;
-		GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-		GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD; //©
-		GPIO_Init(GPIOB, &GPIO_InitStructure);
-		
-		GPIO_SetBits(GPIOB,GPIO_Pin_6);
-		GPIO_SetBits(GPIOB,GPIO_Pin_7); //豸Уߵƽ
-	}else if(soft_i2c == SOFT_I2C2){
-	}
-}
-
-/**
-  * @brief  SCLŵƽ
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @param  level: Ŀƽ
-  *   @arg  0: ͵ƽ
-  *   @arg  1: ߵƽ
-  * @retval 
-  */
-void soft_i2c_set_scl_level(SOFT_I2C_TypeDef soft_i2c,uint8_t level)
-{
-	if(soft_i2c == SOFT_I2C1){
-		if(level == 0) GPIO_ResetBits(GPIOB,GPIO_Pin_6);
-		else GPIO_SetBits(GPIOB,GPIO_Pin_6);
-	}else if(soft_i2c == SOFT_I2C2){}
-}
-
-/**
-  * @brief  SDAŵƽ
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @param  level: Ŀƽ
-  *   @arg  0: ͵ƽ
-  *   @arg  1: ߵƽ
-  * @retval 
-  */
-void soft_i2c_set_sda_level(SOFT_I2C_TypeDef soft_i2c,uint8_t level)
-{
-	if(soft_i2c == SOFT_I2C1){
-		if(level == 0) GPIO_ResetBits(GPIOB,GPIO_Pin_7);
-		else GPIO_SetBits(GPIOB,GPIO_Pin_7);
-	}else if(soft_i2c == SOFT_I2C2){}
-}
-
-/**
-  * @brief  ȡSDAŵƽ
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @retval SDAŵƽֵ (0: ͵ƽ, 1: ߵƽ)
-  */
-uint8_t soft_i2c_get_sda_level(SOFT_I2C_TypeDef soft_i2c)
-{
-	uint8_t level;
-	if(soft_i2c == SOFT_I2C1){
-		level = GPIO_ReadInputDataBit(GPIOB,GPIO_Pin_7);
-	}else if(soft_i2c == SOFT_I2C2){}
-	return level;
-}
-/****************** user port area end   ****************/
-
-/**
-  * @brief  I2CʼźţSTART
-  * @details ʼSCLʱSDAӸ߱
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @retval 
-  */
-void soft_i2c_start(SOFT_I2C_TypeDef soft_i2c)
-{
-	soft_i2c_set_sda_level(soft_i2c,1);
-	soft_i2c_set_scl_level(soft_i2c,1);
-	soft_i2c_delay_us();
-	soft_i2c_set_sda_level(soft_i2c,0);
-	soft_i2c_delay_us();
-	soft_i2c_set_scl_level(soft_i2c,0);
-}
-
-/**
-  * @brief  I2CֹͣźţSTOP
-  * @details ֹͣSCLʱSDAӵͱ
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @retval 
-  */
-void soft_i2c_stop(SOFT_I2C_TypeDef soft_i2c)
-{	
-	soft_i2c_set_scl_level(soft_i2c,0);
-	soft_i2c_set_sda_level(soft_i2c,0);
-	soft_i2c_delay_us();
-	soft_i2c_set_scl_level(soft_i2c,1);
-	soft_i2c_set_sda_level(soft_i2c,1);
-	soft_i2c_delay_us();
-}
-
-/**
-  * @brief  ȴI2CӦźŵ
-  * @details ڵ9ʱʱӻSDAʾӦ
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @retval 0: Ӧɹ
-  * @retval 1: Ӧʧܣʱ
-  */
-uint8_t soft_i2c_wait_ack(SOFT_I2C_TypeDef soft_i2c)
-{
-    uint8_t ucErrTime=0;
-	soft_i2c_set_sda_level(soft_i2c,1);	 
-    soft_i2c_delay_us();
-	soft_i2c_set_scl_level(soft_i2c,1);	 
-    soft_i2c_delay_us();
-    while(soft_i2c_get_sda_level(soft_i2c))
-    {
-        ucErrTime++;
-        if(ucErrTime>250)
-        {
-            soft_i2c_stop(soft_i2c);
-            return 1;
-        }
-    } 
-	soft_i2c_set_scl_level(soft_i2c,0);	 
-    return 0;
-}
-
-/**
-  * @brief  I2CӦźţACK
-  * @details SDASCLڼ䱣
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @retval 
-  */
-void soft_i2c_ack(SOFT_I2C_TypeDef soft_i2c)
-{	
-	soft_i2c_set_sda_level(soft_i2c, 0);  //  SDAACK źţ
-    soft_i2c_delay_us();
-    soft_i2c_set_scl_level(soft_i2c, 1);  //  SCLӻȡ ACK
-    soft_i2c_delay_us();
-    soft_i2c_set_scl_level(soft_i2c, 0);  //  SCL 9 ʱڣ
-    
-    // ؼͷ SDAΪߵƽģʽôӻԷһֽ
-    soft_i2c_set_sda_level(soft_i2c, 1);  
-    soft_i2c_delay_us();
-}
-
-/**
-  * @brief  I2CӦźţNACK
-  * @details SDAߵƽSCLڼͷ
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @retval 
-  */
-void soft_i2c_nack(SOFT_I2C_TypeDef soft_i2c)
-{
-	soft_i2c_set_sda_level(soft_i2c, 1);  //  SDA ߵƽNACK
-    soft_i2c_delay_us();
-    soft_i2c_set_scl_level(soft_i2c, 1);  //  SCL
-    soft_i2c_delay_us();
-    soft_i2c_set_scl_level(soft_i2c, 0);  //  SCL
-    // NACK ͨ STOPԲ SDA stop 
-}
-
-/**
-  * @brief  I2Cһֽ
-  * @details λȷMSB
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @param  txd: ֽ
-  * @retval 
-  */
-void soft_i2c_send_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t txd)
-{
-    uint8_t i;  
-	soft_i2c_set_scl_level(soft_i2c,0);	
-    for (i = 0; i < 8; i++)
-    {
-		if((txd&0x80)>>7)
-			soft_i2c_set_sda_level(soft_i2c,1);			
-		else
-			soft_i2c_set_sda_level(soft_i2c,0);	
-        txd<<=1;
-		soft_i2c_set_scl_level(soft_i2c,1);
-        soft_i2c_delay_us();  
-		soft_i2c_set_scl_level(soft_i2c,0);
-        soft_i2c_delay_us();  
-    }
-}
-
-/**
-  * @brief  I2Cȡһֽ
-  * @details λȶMSB
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @param  ack: ȡǷӦ
-  *   @arg  1: Ӧ𣨼գ
-  *   @arg  0: Ӧ𣨽գ
-  * @retval ȡֽ
-  */
-uint8_t soft_i2c_read_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t ack)
-{
-    uint8_t i,receive = 0;  
-
-    for (i = 0; i < 8; i++)
-    {
-		soft_i2c_set_scl_level(soft_i2c,0);
-        soft_i2c_delay_us();  
-		soft_i2c_set_scl_level(soft_i2c,1);
-        receive <<= 1; 
-        if (soft_i2c_get_sda_level(soft_i2c))
-        {
-            receive++; 
-        }
-        soft_i2c_delay_us();  
-    }
-	
-	soft_i2c_set_scl_level(soft_i2c, 0);
-    soft_i2c_delay_us();
-	
-    if (!ack)
-        soft_i2c_nack(soft_i2c); //Ӧ
-    else
-        soft_i2c_ack(soft_i2c); //Ӧ
-
-    return receive;
-}
-
-/**
-  * @brief  ָI2C豸ļĴȡһֽ
-  * @details I2C̣ͨSTART -> ʹӻַ(д) -> ͼĴַ -> 
-  *          ظSTART -> ʹӻַ() -> ȡ -> NACK -> STOP
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @param  addr: I2C豸ַ7λдλ
-  * @param  reg: 豸Ĵַ
-  * @param  data: ָݱ滺ָ
-  * @retval 0: ȡɹ
-  * @retval 1: ȡʧ
-  */
-uint8_t soft_i2c_read_dev_one_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t reg,uint8_t *data)
-{
-    soft_i2c_start(soft_i2c);
-    soft_i2c_send_byte(soft_i2c,(addr<<1)|0);     
-    if(soft_i2c_wait_ack(soft_i2c))               
-    {
-        soft_i2c_stop(soft_i2c);
-        return 1;
-    }
-    soft_i2c_send_byte(soft_i2c,reg);             
-    if(soft_i2c_wait_ack(soft_i2c))               
-    {
-        soft_i2c_stop(soft_i2c);
-        return 1;
-    }
-    soft_i2c_start(soft_i2c);                     
-    soft_i2c_send_byte(soft_i2c,(addr<<1)|1);     
-    if(soft_i2c_wait_ack(soft_i2c))               
-    {
-        soft_i2c_stop(soft_i2c);
-        return 1;
-    }
-    *data = soft_i2c_read_byte(soft_i2c,0);    
-    soft_i2c_stop(soft_i2c);
-
-    return 0;
-}
-
-/**
-  * @brief  ָI2C豸ļĴдһֽ
-  * @details I2C̣ͨSTART -> ʹӻַ(д) -> ͼĴַ -> 
-  *          ֽ -> STOP
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @param  addr: I2C豸ַ7λдλ
-  * @param  reg: 豸Ĵַ
-  * @param  data: дֽ
-  * @retval 0: дɹ
-  * @retval 1: дʧ
-  */
-uint8_t soft_i2c_write_dev_one_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t reg,uint8_t data)
-{
-    soft_i2c_start(soft_i2c);
-    soft_i2c_send_byte(soft_i2c,(addr<<1)|0);      
-    if(soft_i2c_wait_ack(soft_i2c))               
-    {
-        soft_i2c_stop(soft_i2c);
-        return 1;
-    }
-    soft_i2c_send_byte(soft_i2c,reg);             
-    if(soft_i2c_wait_ack(soft_i2c))                
-    {
-        soft_i2c_stop(soft_i2c);
-        return 1;
-    }
-    soft_i2c_send_byte(soft_i2c,data);             
-    if(soft_i2c_wait_ack(soft_i2c))                
-    {
-        soft_i2c_stop(soft_i2c);
-        return 1;
-    }
-    soft_i2c_stop(soft_i2c);
-    return 0;
-}
-
-/**
-  * @brief  ָI2C豸ļĴȡֽ
-  * @details I2C̣ͨSTART -> ʹӻַ(д) -> ͼĴַ -> 
-  *          ظSTART -> ʹӻַ() -> ȡlenֽ -> 
-  *          һֽںNACK -> STOP
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @param  addr: I2C豸ַ7λдλ
-  * @param  reg: 豸Ĵַ
-  * @param  len: ȡֽ
-  * @param  buf: ָݱ滺ָ
-  * @retval 0: ȡɹ
-  * @retval 1: ȡʧ
-  */
-uint8_t soft_i2c_read_dev_len_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t reg,uint8_t len,uint8_t *buf)
-{
-    soft_i2c_start(soft_i2c);
-    soft_i2c_send_byte(soft_i2c,(addr<<1)|0);  
-    if(soft_i2c_wait_ack(soft_i2c))          
-    {
-        soft_i2c_stop(soft_i2c);
-        return 1;
-    }
-    soft_i2c_send_byte(soft_i2c,reg); 
-    if(soft_i2c_wait_ack(soft_i2c))                
-    {
-        soft_i2c_stop(soft_i2c);
-        return 1;
-    }
-    soft_i2c_start(soft_i2c);
-    soft_i2c_send_byte(soft_i2c,(addr<<1)|1); 
-    if(soft_i2c_wait_ack(soft_i2c))                
-    {
-        soft_i2c_stop(soft_i2c);
-        return 1;
-    }
-    while(len)
-    {
-        if(len==1)*buf=soft_i2c_read_byte(soft_i2c,0);
-        else *buf=soft_i2c_read_byte(soft_i2c,1);		
-        len--;
-        buf++;
-    }
-    soft_i2c_stop(soft_i2c);                
-    return 0;
-}
-
-/**
-  * @brief  ָI2C豸ļĴдֽ
-  * @details I2C̣ͨSTART -> ʹӻַ(д) -> ͼĴַ -> 
-  *          lenֽڣÿֽںȴӦ -> STOP
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @param  addr: I2C豸ַ7λдλ
-  * @param  reg: 豸Ĵַ
-  * @param  len: дֽ
-  * @param  buf: ָдݵĻָ
-  * @retval 0: дɹ
-  * @retval 1: дʧ
-  */
-uint8_t soft_i2c_write_dev_len_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t reg,uint8_t len,uint8_t *buf)
-{
-    uint8_t i;
-    soft_i2c_start(soft_i2c);
-    soft_i2c_send_byte(soft_i2c,(addr<<1)|0);  
-    if(soft_i2c_wait_ack(soft_i2c))         
-    {
-        soft_i2c_stop(soft_i2c);
-        return 1;
-    }
-    soft_i2c_send_byte(soft_i2c,reg); 
-    if(soft_i2c_wait_ack(soft_i2c))               
-    {
-        soft_i2c_stop(soft_i2c);
-        return 1;
-    }
-    for(i=0; i<len; i++)
-    {
-        soft_i2c_send_byte(soft_i2c,buf[i]);  
-        if(soft_i2c_wait_ack(soft_i2c))          
-		{
-			soft_i2c_stop(soft_i2c);
-			return 1;
-		}
-    }
-    soft_i2c_stop(soft_i2c);
-    return 0;
-}
-
-/**
-  * @brief  I2C豸дݣ򻯽ӿڣ
-  * @details I2C̣ͨSTART -> ʹӻַ(д) -> lenֽ ->
-  *          ÿֽںȴӦ -> STOP
-  *           soft_i2c_write_dev_len_byte˺ҪָĴַ
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @param  addr: I2C豸ַ7λдλ
-  * @param  buf: ָдݵĻָ
-  * @param  len: дֽ
-  * @retval 0: дɹ
-  * @retval 1: дʧ
-  */
-uint8_t soft_i2c_write(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,const uint8_t *buf,uint8_t len)
-{
-    uint8_t i;
-
-    soft_i2c_start(soft_i2c);
-
-    soft_i2c_send_byte(soft_i2c, (addr << 1) | 0);
-    if (soft_i2c_wait_ack(soft_i2c))
-        goto err;
-
-    for (i = 0; i < len; i++)
-    {
-        soft_i2c_send_byte(soft_i2c, buf[i]);
-        if (soft_i2c_wait_ack(soft_i2c))
-            goto err;
-    }
-
-    soft_i2c_stop(soft_i2c);
-    return 0;
-
-err:
-    soft_i2c_stop(soft_i2c);
-    return 1;
-}
-
-/**
-  * @brief  I2C豸ȡݣ򻯽ӿڣ
-  * @details I2C̣ͨSTART -> ʹӻַ() -> ȡlenֽ ->
-  *          һֽںNACK -> STOP
-  *           soft_i2c_read_dev_len_byte˺ҪָĴַ
-  * @param  soft_i2c: I2C
-  *   @arg  SOFT_I2C1: I2C1
-  *   @arg  SOFT_I2C2: I2C2
-  * @param  addr: I2C豸ַ7λдλ
-  * @param  buf: ָݱ滺ָ
-  * @param  len: ȡֽ0
-  * @retval 0: ȡɹ
-  * @retval 1: ȡʧܻ򳤶Ϊ0
-  * @note   lenΪ0ʱʧ
-  */
-uint8_t soft_i2c_read(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t *buf,uint8_t len)
-{
-    uint8_t i;
-
-    if (len == 0)
-        return 1;
-
-    soft_i2c_start(soft_i2c);
-
-    soft_i2c_send_byte(soft_i2c, (addr << 1) | 1);
-    if (soft_i2c_wait_ack(soft_i2c))
-        goto err;
-
-    for (i = 0; i < len; i++)
-    {
-        if (i == (len - 1))
-            buf[i] = soft_i2c_read_byte(soft_i2c, 0); // NACK
-        else
-            buf[i] = soft_i2c_read_byte(soft_i2c, 1); // ACK
-    }
-
-    soft_i2c_stop(soft_i2c);
-    return 0;
-
-err:
-    soft_i2c_stop(soft_i2c);
-    return 1;
-}
+/**
+  ******************************************************************************
+  * @file    bsp_soft_i2c.c
+  * @author  liqinghua <liqinghuaxx@163.com>
+  * @version V1.0.0
+  * @date    2026-01-29
+  * @brief   软件I2C驱动模块
+  *
+  * @copyright (c) 2026 liqinghua
+  * 
+  * Permission is hereby granted, free of charge, to any person obtaining a copy
+  * of this software and associated documentation files (the "Software"), to deal
+  * in the Software without restriction, including without limitation the rights
+  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  * copies of the Software, and to permit persons to whom the Software is
+  * furnished to do so, subject to the following conditions:
+
+  * The above copyright notice and this permission notice shall be included in all
+  * copies or substantial portions of the Software.
+
+  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  * SOFTWARE.
+  *
+  * @details 
+  *          本模块实现基于GPIO的软件I2C通信，支持多个I2C总线。
+  *          支持的功能：
+  *          - I2C初始化
+  *          - I2C总线控制（起始、停止、应答等）
+  *          - 单字节读写
+  *          - 多字节读写
+  *          - 总线引脚编译期绑定（SOFT_I2C_BUS_LIST），引脚翻转为单次寄存器写
+  *          - 每条总线可独立设置速度（100k/400k/1MHz），延时基于DWT实测校准
+  *          - 支持从机时钟拉伸（带超时）、SDA被拉低时自动总线恢复、错误计数
+  *
+  * @warning 引脚初始化时必须使用开漏输出模式（GPIO_Mode_Out_OD）
+  */  
+#include "bsp_soft_i2c.h"
+#include "bsp_i2c_trace.h"
+#include <string.h>
+
+/****************** user port area start ****************/
+#include "bsp_delay.h"
+#include "main.h"
+
+#define SOFT_I2C_BUS_DESC(name, port, rcc, scl, sda, speed) \
+	{ &(port)->BSRR, &(port)->BRR, &(port)->IDR, (scl), (sda), (port), (rcc), (speed) },
+
+/* 总线描述符表，由 SOFT_I2C_BUS_LIST 在编译期生成 */
+const soft_i2c_bus_t soft_i2c_bus[SOFT_I2C_BUS_NUM] = {
+	SOFT_I2C_BUS_LIST(SOFT_I2C_BUS_DESC)
+};
+
+/* 并行总线描述符表，由 SOFT_I2C_PAR_LIST 在编译期生成 */
+const soft_i2c_bus_t soft_i2c_par_bus[SOFT_I2C_PAR_NUM] = {
+	SOFT_I2C_PAR_LIST(SOFT_I2C_BUS_DESC)
+};
+
+/* 各速度模式下SCL高/低电平的目标保持时间（ns），在I2C规范最小值基础上留有余量 */
+static const uint16_t soft_i2c_timing_ns[3][2] = {
+	{5000, 5000},   //标准模式：tHIGH>=4.0us tLOW>=4.7us
+	{1200, 1300},   //快速模式：tHIGH>=0.6us tLOW>=1.3us
+	{ 450,  550},   //增强快速模式：tHIGH>=0.26us tLOW>=0.5us
+};
+
+/* 每条总线的延时循环次数，由 soft_i2c_set_speed 计算 */
+static struct {
+	uint32_t high_loops;
+	uint32_t low_loops;
+}soft_i2c_timing[SOFT_I2C_BUS_NUM];
+
+/* 并行总线的延时循环次数及设备SDA引脚位号 */
+static struct {
+	uint32_t high_loops;
+	uint32_t low_loops;
+	uint8_t num;                           //设备数
+	uint8_t shift[SOFT_I2C_PAR_DEV_MAX];   //设备序号 -> SDA引脚位号
+}soft_i2c_par[SOFT_I2C_PAR_NUM];
+
+static uint32_t soft_i2c_loop_cycles  = 0;   //延时循环每圈耗费的周期数
+static uint32_t soft_i2c_fixed_cycles = 0;   //延时调用固定开销 + 一次引脚翻转开销
+static uint32_t soft_i2c_stretch_cycles = 0; //时钟拉伸超时对应的周期数
+
+/**
+  * @brief  I2C延时循环
+  * @note   循环体只有一条NOP，每圈耗时由 soft_i2c_delay_calibrate 实测
+  * @param  n: 循环次数
+  * @retval 无
+  */
+static void soft_i2c_delay_loop(uint32_t n)
+{
+	while(n--)
+		__NOP();
+}
+
+#define soft_i2c_delay_high(soft_i2c)  soft_i2c_delay_loop(soft_i2c_timing[soft_i2c].high_loops)
+#define soft_i2c_delay_low(soft_i2c)   soft_i2c_delay_loop(soft_i2c_timing[soft_i2c].low_loops)
+
+/**
+  * @brief  延时校准
+  * @note   用DWT周期计数器实测延时循环的每圈周期、调用固定开销以及一次引脚写入的开销，
+  *         计算延时循环次数时扣除这些开销，使SCL实际频率贴近目标值
+  * @param  bus: 用于测量引脚写入开销的总线（总线空闲时SCL为高，写高电平不影响总线）
+  * @retval 无
+  */
+static void soft_i2c_delay_calibrate(const soft_i2c_bus_t *bus)
+{
+	uint32_t t0, t1, t2, t3, t4, rd;
+
+	delay_cycle_init();
+
+	t0 = DWT_CYCCNT_REG;
+	t1 = DWT_CYCCNT_REG;
+	soft_i2c_delay_loop(0);
+	t2 = DWT_CYCCNT_REG;
+	soft_i2c_delay_loop(64);
+	t3 = DWT_CYCCNT_REG;
+	soft_i2c_scl_h(bus);
+	t4 = DWT_CYCCNT_REG;
+
+	rd = t1 - t0;                                     //读计数器本身的开销
+	soft_i2c_loop_cycles  = ((t3 - t2) - (t2 - t1)) / 64;
+	soft_i2c_fixed_cycles = (t2 - t1 - rd) + (t4 - t3 - rd);
+	if(soft_i2c_loop_cycles == 0)
+		soft_i2c_loop_cycles = 1;
+}
+
+/**
+  * @brief  将目标时间换算为延时循环次数（向上取整，保证不短于目标时间）
+  * @param  ns: 目标时间（ns）
+  * @retval 延时循环次数
+  */
+static uint32_t soft_i2c_ns_to_loops(uint32_t ns)
+{
+	uint32_t cycles = (SystemCoreClock / 1000000) * ns / 1000;
+
+	if(cycles <= soft_i2c_fixed_cycles)
+		return 0;
+	return (cycles - soft_i2c_fixed_cycles + soft_i2c_loop_cycles - 1) / soft_i2c_loop_cycles;
+}
+
+/**
+  * @brief  设置I2C总线速度
+  * @note   需在 soft_i2c_init 之后调用（init 中会完成延时校准并设置默认速度）
+  *         速度越高对代码开销越敏感，1MHz下若延时已为0则实际频率由代码开销决定
+  * @param  soft_i2c: I2C编号
+  * @param  speed: 速度模式
+  *   @arg  SOFT_I2C_SPEED_STANDARD:  100kHz
+  *   @arg  SOFT_I2C_SPEED_FAST:      400kHz
+  *   @arg  SOFT_I2C_SPEED_FAST_PLUS: 1MHz
+  * @retval 无
+  */
+void soft_i2c_set_speed(SOFT_I2C_TypeDef soft_i2c,SOFT_I2C_Speed_TypeDef speed)
+{
+	if(soft_i2c >= SOFT_I2C_BUS_NUM || speed > SOFT_I2C_SPEED_FAST_PLUS)
+		return;
+	soft_i2c_timing[soft_i2c].high_loops = soft_i2c_ns_to_loops(soft_i2c_timing_ns[speed][0]);
+	soft_i2c_timing[soft_i2c].low_loops  = soft_i2c_ns_to_loops(soft_i2c_timing_ns[speed][1]);
+}
+
+/**
+  * @brief  估算当前设置下SCL的实际频率
+  * @note   按校准得到的开销计算，未计入字节循环中移位、判断等指令，实际值略低
+  * @param  soft_i2c: I2C编号
+  * @retval SCL频率（Hz）
+  */
+uint32_t soft_i2c_get_scl_freq(SOFT_I2C_TypeDef soft_i2c)
+{
+	uint32_t cycles;
+
+	if(soft_i2c >= SOFT_I2C_BUS_NUM)
+		return 0;
+	cycles = 2 * soft_i2c_fixed_cycles +
+	         (soft_i2c_timing[soft_i2c].high_loops + soft_i2c_timing[soft_i2c].low_loops) * soft_i2c_loop_cycles;
+	if(cycles == 0)
+		return 0;
+	return SystemCoreClock / cycles;
+}
+
+/**
+  * @brief  I2C模块初始化
+  * @note   注意：引脚初始化一定要是开漏模式（GPIO_Mode_Out_OD）
+  *         引脚由 bsp_soft_i2c.h 中的 SOFT_I2C_BUS_LIST 绑定
+  * @param  soft_i2c: I2C编号
+  *   @arg  SOFT_I2C1: 软件I2C1
+  *   @arg  SOFT_I2C2: 软件I2C2
+  * @retval 无
+  */
+void soft_i2c_init(SOFT_I2C_TypeDef soft_i2c)
+{
+	const soft_i2c_bus_t *bus;
+	GPIO_InitTypeDef GPIO_InitStructure;
+
+	if(soft_i2c >= SOFT_I2C_BUS_NUM)
+		return;
+	bus = &soft_i2c_bus[soft_i2c];
+
+	//开启端口时钟
+	RCC_APB2PeriphClockCmd(bus->rcc, ENABLE);
+
+	//配置SCL和SDA引脚
+	GPIO_InitStructure.GPIO_Pin = bus->scl_pin | bus->sda_pin;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD; //开漏输出
+	GPIO_Init(bus->port, &GPIO_InitStructure);
+
+	soft_i2c_scl_h(bus);
+	soft_i2c_sda_h(bus); //总线设备空闲，都保持高电平
+
+	//首次初始化时校准延时，再按总线表中的默认速度计算延时
+	if(soft_i2c_loop_cycles == 0)
+		soft_i2c_delay_calibrate(bus);
+	soft_i2c_stretch_cycles = (SystemCoreClock / 1000000) * SOFT_I2C_STRETCH_TIMEOUT_US;
+	soft_i2c_set_speed(soft_i2c, bus->speed);
+}
+
+/**
+  * @brief  设置并行I2C总线速度
+  * @param  par: 并行总线编号
+  * @param  speed: 速度模式，同 soft_i2c_set_speed
+  * @retval 无
+  */
+void soft_i2c_par_set_speed(SOFT_I2C_PAR_TypeDef par,SOFT_I2C_Speed_TypeDef speed)
+{
+	if(par >= SOFT_I2C_PAR_NUM || speed > SOFT_I2C_SPEED_FAST_PLUS)
+		return;
+	soft_i2c_par[par].high_loops = soft_i2c_ns_to_loops(soft_i2c_timing_ns[speed][0]);
+	soft_i2c_par[par].low_loops  = soft_i2c_ns_to_loops(soft_i2c_timing_ns[speed][1]);
+}
+
+/**
+  * @brief  并行I2C模块初始化
+  * @note   引脚由 bsp_soft_i2c.h 中的 SOFT_I2C_PAR_LIST 绑定，同样必须为开漏输出
+  * @param  par: 并行总线编号
+  *   @arg  SOFT_I2C_PAR1: 并行软件I2C1
+  * @retval 无
+  */
+void soft_i2c_par_init(SOFT_I2C_PAR_TypeDef par)
+{
+	const soft_i2c_bus_t *bus;
+	GPIO_InitTypeDef GPIO_InitStructure;
+	uint8_t pin;
+
+	if(par >= SOFT_I2C_PAR_NUM)
+		return;
+	bus = &soft_i2c_par_bus[par];
+
+	RCC_APB2PeriphClockCmd(bus->rcc, ENABLE);
+
+	GPIO_InitStructure.GPIO_Pin = bus->scl_pin | bus->sda_pin;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD; //开漏输出
+	GPIO_Init(bus->port, &GPIO_InitStructure);
+
+	soft_i2c_scl_h(bus);
+	soft_i2c_sda_h(bus);
+
+	//按引脚号从小到大记录每个设备的SDA位号
+	soft_i2c_par[par].num = 0;
+	for(pin = 0; pin < 16; pin++)
+	{
+		if(bus->sda_pin & (1u << pin))
+			soft_i2c_par[par].shift[soft_i2c_par[par].num++] = pin;
+	}
+
+	if(soft_i2c_loop_cycles == 0)
+		soft_i2c_delay_calibrate(bus);
+	soft_i2c_stretch_cycles = (SystemCoreClock / 1000000) * SOFT_I2C_STRETCH_TIMEOUT_US;
+	soft_i2c_par_set_speed(par, bus->speed);
+}
+/****************** user port area end   ****************/
+
+/* 每条总线的错误计数 */
+static soft_i2c_err_t soft_i2c_err[SOFT_I2C_BUS_NUM];
+/* 本次传输中是否发生了时钟拉伸超时，在START时清零 */
+static uint8_t soft_i2c_stretch_fail[SOFT_I2C_BUS_NUM];
+
+/**
+  * @brief  释放SCL并等待其真正变高
+  * @details 从机可以拉低SCL进行时钟拉伸，主机必须等待SCL回读为高才能继续。
+  *          SCL立即变高时只多一次IDR读取；超过 SOFT_I2C_STRETCH_TIMEOUT_US 则放弃并计数。
+  *          SOFT_I2C_STRETCH_ENABLE 为0时只释放SCL，不回读
+  * @param  soft_i2c: I2C编号
+  * @param  bus: 总线描述符
+  * @retval 0: SCL已变高
+  * @retval 1: 时钟拉伸超时
+  */
+static uint8_t soft_i2c_scl_release(SOFT_I2C_TypeDef soft_i2c,const soft_i2c_bus_t *bus)
+{
+#if SOFT_I2C_STRETCH_ENABLE
+	uint32_t start;
+
+	soft_i2c_scl_h(bus);
+	if(soft_i2c_scl_read(bus))
+		return 0;
+
+	start = DWT_CYCCNT_REG;
+	while(!soft_i2c_scl_read(bus))
+	{
+		if(DWT_CYCCNT_REG - start > soft_i2c_stretch_cycles)
+		{
+			soft_i2c_err[soft_i2c].stretch_timeout++;
+			soft_i2c_stretch_fail[soft_i2c] = 1;
+			I2C_TRACE_FLAG(I2C_TRACE_BUS_SOFT(soft_i2c), I2C_TRACE_F_ERR);
+			return 1;
+		}
+	}
+	return 0;
+#else
+	(void)soft_i2c;
+	soft_i2c_scl_h(bus);
+	return 0;
+#endif
+}
+
+/**
+  * @brief  I2C总线恢复
+  * @details 从机在传输中途被复位（或主机复位）时可能一直拉低SDA。
+  *          释放SDA后最多输出9个SCL时钟，让从机把剩余的位移出并释放SDA，随后产生STOP。
+  *          soft_i2c_start 检测到SDA被拉低时会自动调用
+  * @param  soft_i2c: I2C编号
+  *   @arg  SOFT_I2C1: 软件I2C1
+  *   @arg  SOFT_I2C2: 软件I2C2
+  * @retval 0: 恢复成功，总线空闲
+  * @retval 1: 恢复失败（SCL或SDA仍被拉低）
+  */
+uint8_t soft_i2c_bus_recover(SOFT_I2C_TypeDef soft_i2c)
+{
+	const soft_i2c_bus_t *bus = &soft_i2c_bus[soft_i2c];
+	uint8_t i;
+
+	soft_i2c_err[soft_i2c].bus_recover++;
+
+	soft_i2c_sda_h(bus);
+	for(i = 0; i < 9 && !soft_i2c_sda_read(bus); i++)
+	{
+		soft_i2c_scl_l(bus);
+		soft_i2c_delay_low(soft_i2c);
+		if(soft_i2c_scl_release(soft_i2c,bus))
+			break;  //SCL被一直拉低，再打时钟也没有意义
+		soft_i2c_delay_high(soft_i2c);
+	}
+
+	//产生STOP，让从机状态机回到空闲
+	soft_i2c_scl_l(bus);
+	soft_i2c_delay_low(soft_i2c);
+	soft_i2c_sda_l(bus);
+	soft_i2c_delay_low(soft_i2c);
+	soft_i2c_scl_release(soft_i2c,bus);
+	soft_i2c_delay_high(soft_i2c);
+	soft_i2c_sda_h(bus);
+	soft_i2c_delay_low(soft_i2c);
+
+	if(!soft_i2c_scl_read(bus) || !soft_i2c_sda_read(bus))
+	{
+		soft_i2c_err[soft_i2c].recover_fail++;
+		return 1;
+	}
+	return 0;
+}
+
+/**
+  * @brief  获取总线错误计数
+  * @param  soft_i2c: I2C编号
+  * @retval 错误计数结构体指针
+  */
+const soft_i2c_err_t *soft_i2c_get_error(SOFT_I2C_TypeDef soft_i2c)
+{
+	return &soft_i2c_err[soft_i2c];
+}
+
+/**
+  * @brief  清零总线错误计数
+  * @param  soft_i2c: I2C编号
+  * @retval 无
+  */
+void soft_i2c_clear_error(SOFT_I2C_TypeDef soft_i2c)
+{
+	memset(&soft_i2c_err[soft_i2c], 0, sizeof(soft_i2c_err_t));
+}
+
+/**
+  * @brief  I2C产生起始信号（START）
+  * @details 起始条件：SCL高时，SDA从高变低
+  *          若发现SDA被拉低则自动执行总线恢复
+  * @param  soft_i2c: I2C编号
+  *   @arg  SOFT_I2C1: 软件I2C1
+  *   @arg  SOFT_I2C2: 软件I2C2
+  * @retval 0: 成功
+  * @retval 1: 总线被占用且恢复失败
+  */
+uint8_t soft_i2c_start(SOFT_I2C_TypeDef soft_i2c)
+{
+	const soft_i2c_bus_t *bus = &soft_i2c_bus[soft_i2c];
+	soft_i2c_stretch_fail[soft_i2c] = 0;
+	I2C_TRACE_START(I2C_TRACE_BUS_SOFT(soft_i2c));
+	soft_i2c_sda_h(bus);
+	//SCL释放后SDA仍为低，说明有从机卡住了总线，先尝试恢复
+	if(soft_i2c_scl_release(soft_i2c,bus) || !soft_i2c_sda_read(bus))
+	{
+		if(soft_i2c_bus_recover(soft_i2c))
+		{
+			//没有STOP可记，在这里结束本次跟踪记录
+			I2C_TRACE_FLAG(I2C_TRACE_BUS_SOFT(soft_i2c), I2C_TRACE_F_ERR);
+			I2C_TRACE_STOP(I2C_TRACE_BUS_SOFT(soft_i2c));
+			return 1;
+		}
+		soft_i2c_stretch_fail[soft_i2c] = 0;
+	}
+	soft_i2c_delay_high(soft_i2c);
+	soft_i2c_sda_l(bus);
+	soft_i2c_delay_high(soft_i2c);
+	soft_i2c_scl_l(bus);
+	return 0;
+}
+
+/**
+  * @brief  I2C产生停止信号（STOP）
+  * @details 停止条件：SCL高时，SDA从低变高
+  * @param  soft_i2c: I2C编号
+  *   @arg  SOFT_I2C1: 软件I2C1
+  *   @arg  SOFT_I2C2: 软件I2C2
+  * @retval 无
+  */
+void soft_i2c_stop(SOFT_I2C_TypeDef soft_i2c)
+{
+	const soft_i2c_bus_t *bus = &soft_i2c_bus[soft_i2c];
+	soft_i2c_scl_l(bus);
+	soft_i2c_sda_l(bus);
+	soft_i2c_delay_low(soft_i2c);
+	soft_i2c_scl_release(soft_i2c,bus);
+	soft_i2c_delay_high(soft_i2c);  //停止条件建立时间
+	soft_i2c_sda_h(bus);
+	soft_i2c_delay_low(soft_i2c);   //总线空闲时间
+	I2C_TRACE_STOP(I2C_TRACE_BUS_SOFT(soft_i2c));
+}
+
+/**
+  * @brief  等待I2C应答信号到来
+  * @details 在第9个时钟周期时，从机拉低SDA表示应答
+  * @param  soft_i2c: I2C编号
+  *   @arg  SOFT_I2C1: 软件I2C1
+  *   @arg  SOFT_I2C2: 软件I2C2
+  * @retval 0: 接收应答成功
+  * @retval 1: 接收应答失败（无应答或时钟拉伸超时）
+  */
+uint8_t soft_i2c_wait_ack(SOFT_I2C_TypeDef soft_i2c)
+{
+	const soft_i2c_bus_t *bus = &soft_i2c_bus[soft_i2c];
+	soft_i2c_sda_h(bus);	 
+    soft_i2c_delay_low(soft_i2c);
+	soft_i2c_scl_release(soft_i2c,bus);	 
+    soft_i2c_delay_high(soft_i2c);
+    //SCL高电平期间SDA已稳定，采样一次即可；本字节内出现过拉伸超时同样视为失败
+    if(soft_i2c_stretch_fail[soft_i2c] || soft_i2c_sda_read(bus))
+    {
+        if(!soft_i2c_stretch_fail[soft_i2c])
+        {
+            soft_i2c_err[soft_i2c].nack++;
+            I2C_TRACE_FLAG(I2C_TRACE_BUS_SOFT(soft_i2c), I2C_TRACE_F_NACK);
+        }
+        soft_i2c_stop(soft_i2c);
+        return 1;
+    }
+	soft_i2c_scl_l(bus);	 
+    return 0;
+}
+
+/**
+  * @brief  主机产生I2C应答信号（ACK）
+  * @details 拉低SDA，在SCL高期间保持
+  * @param  soft_i2c: I2C编号
+  *   @arg  SOFT_I2C1: 软件I2C1
+  *   @arg  SOFT_I2C2: 软件I2C2
+  * @retval 无
+  */
+void soft_i2c_ack(SOFT_I2C_TypeDef soft_i2c)
+{
+	const soft_i2c_bus_t *bus = &soft_i2c_bus[soft_i2c];
+	soft_i2c_sda_l(bus);  // 拉低 SDA（ACK 信号）
+    soft_i2c_delay_low(soft_i2c);
+    soft_i2c_scl_release(soft_i2c,bus);  // 拉高 SCL（从机读取 ACK）
+    soft_i2c_delay_high(soft_i2c);
+    soft_i2c_scl_l(bus);  // 拉低 SCL（结束第 9 个时钟周期）
+    
+    // 【关键】释放 SDA，设为高电平（或输入模式），让从机可以发送下一个字节
+    soft_i2c_sda_h(bus);  
+    soft_i2c_delay_low(soft_i2c);
+}
+
+/**
+  * @brief  主机产生I2C非应答信号（NACK）
+  * @details 保持SDA高电平，在SCL高期间释放
+  * @param  soft_i2c: I2C编号
+  *   @arg  SOFT_I2C1: 软件I2C1
+  *   @arg  SOFT_I2C2: 软件I2C2
+  * @retval 无
+  */
+void soft_i2c_nack(SOFT_I2C_TypeDef soft_i2c)
+{
+	const soft_i2c_bus_t *bus = &soft_i2c_bus[soft_i2c];
+	soft_i2c_sda_h(bus);  // 保持 SDA 高电平（NACK）
+    soft_i2c_delay_low(soft_i2c);
+    soft_i2c_scl_release(soft_i2c,bus);  // 拉高 SCL
+    soft_i2c_delay_high(soft_i2c);
+    soft_i2c_scl_l(bus);  // 拉低 SCL
+    // NACK 后通常紧跟 STOP，所以这里可以不处理 SDA，由 stop 函数处理
+}
+
+/**
+  * @brief  I2C发送一个字节数据
+  * @details 高位先发（MSB）
+  * @param  soft_i2c: I2C编号
+  *   @arg  SOFT_I2C1: 软件I2C1
+  *   @arg  SOFT_I2C2: 软件I2C2
+  * @param  txd: 待发送字节数据
+  * @retval 无
+  */
+void soft_i2c_send_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t txd)
+{
+	const soft_i2c_bus_t *bus = &soft_i2c_bus[soft_i2c];
+    uint8_t i;  
+	I2C_TRACE_TX(I2C_TRACE_BUS_SOFT(soft_i2c), txd);
+	soft_i2c_scl_l(bus);	
+    for (i = 0; i < 8; i++)
+    {
+		if(txd&0x80)
+			soft_i2c_sda_h(bus);			
+		else
+			soft_i2c_sda_l(bus);	
+        txd<<=1;
+		soft_i2c_scl_release(soft_i2c,bus);
+        soft_i2c_delay_high(soft_i2c);  
+		soft_i2c_scl_l(bus);
+        soft_i2c_delay_low(soft_i2c);  
+    }
+}
+
+/**
+  * @brief  I2C读取一个字节数据
+  * @details 高位先读（MSB）
+  * @param  soft_i2c: I2C编号
+  *   @arg  SOFT_I2C1: 软件I2C1
+  *   @arg  SOFT_I2C2: 软件I2C2
+  * @param  ack: 读取后是否产生应答
+  *   @arg  1: 产生应答（继续接收）
+  *   @arg  0: 不产生应答（结束接收）
+  * @retval 读取的字节数据
+  */
+uint8_t soft_i2c_read_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t ack)
+{
+	const soft_i2c_bus_t *bus = &soft_i2c_bus[soft_i2c];
+    uint8_t i,receive = 0;  
+
+    for (i = 0; i < 8; i++)
+    {
+		soft_i2c_scl_l(bus);
+        soft_i2c_delay_low(soft_i2c);  
+		soft_i2c_scl_release(soft_i2c,bus);
+        receive <<= 1; 
+        if (soft_i2c_sda_read(bus))
+        {
+            receive++; 
+        }
+        soft_i2c_delay_high(soft_i2c);  
+    }
+	
+	soft_i2c_scl_l(bus);
+    soft_i2c_delay_low(soft_i2c);
+	
+    if (!ack)
+        soft_i2c_nack(soft_i2c); //非应答
+    else
+        soft_i2c_ack(soft_i2c); //应答
+    I2C_TRACE_RX(I2C_TRACE_BUS_SOFT(soft_i2c), 1);
+
+    return receive;
+}
+
+/**
+  * @brief  块读取中的一个数据位
+  * @details SCL低电平期间从机放好数据，SCL上升后立即采样；
+  *          SCL没有立即变高时才进入带超时的时钟拉伸等待，关闭时钟拉伸时不回读SCL
+  * @param  soft_i2c: I2C编号
+  * @param  bus: 总线描述符
+  * @param  rx: 接收移位寄存器，采样到的位移入最低位
+  * @param  low: 低电平延时循环次数
+  * @param  high: 高电平延时循环次数
+  * @retval 0: 读取成功
+  * @retval 1: 时钟拉伸超时
+  */
+static __INLINE uint8_t soft_i2c_read_bit(SOFT_I2C_TypeDef soft_i2c,const soft_i2c_bus_t *bus,
+                                          uint32_t *rx,uint32_t low,uint32_t high)
+{
+	soft_i2c_scl_l(bus);
+	soft_i2c_delay_loop(low);
+	soft_i2c_scl_h(bus);
+#if SOFT_I2C_STRETCH_ENABLE
+	if(!soft_i2c_scl_read(bus) && soft_i2c_scl_release(soft_i2c,bus))
+		return 1;
+#else
+	(void)soft_i2c;
+#endif
+	*rx = (*rx << 1) | (soft_i2c_sda_read(bus) ? 1 : 0);
+	soft_i2c_delay_loop(high);
+	return 0;
+}
+
+/**
+  * @brief  连续读取多个字节（块读取）
+  * @details 与逐字节调用 soft_i2c_read_byte 相比：
+  *          - 总线描述符和延时循环次数只取一次，数据位由内联的 soft_i2c_read_bit 读取，没有逐位的函数调用
+  *          - 数据位期间SDA始终保持释放，只在ACK时钟拉低
+  *          - ACK时钟之后的低电平直接作为下一字节第1位的低电平，
+  *            省去了 read_byte 末尾和 ack 末尾两段多余的低电平延时
+  *          调用前SCL为低（读地址字节应答之后），返回时SCL为低、SDA释放，最后一个字节已发送NACK
+  * @param  soft_i2c: I2C编号
+  * @param  buf: 指向数据保存缓冲区的指针
+  * @param  len: 读取字节数（必须大于0）
+  * @retval 0: 读取成功
+  * @retval 1: 时钟拉伸超时
+  */
+static uint8_t soft_i2c_read_block(SOFT_I2C_TypeDef soft_i2c,uint8_t *buf,uint16_t len)
+{
+	const soft_i2c_bus_t *bus = &soft_i2c_bus[soft_i2c];
+	const uint32_t high = soft_i2c_timing[soft_i2c].high_loops;
+	const uint32_t low  = soft_i2c_timing[soft_i2c].low_loops;
+	uint32_t rx;
+	uint8_t i;
+
+	soft_i2c_sda_h(bus);
+	while(len)
+	{
+		rx = 0;
+		for(i = 0; i < 8; i++)
+		{
+			if(soft_i2c_read_bit(soft_i2c,bus,&rx,low,high))
+				return 1;
+		}
+		*buf++ = (uint8_t)rx;
+		len--;
+
+		//第9个时钟：还有数据则ACK（拉低SDA），最后一个字节NACK（保持释放）
+		soft_i2c_scl_l(bus);
+		if(len)
+			soft_i2c_sda_l(bus);
+		soft_i2c_delay_loop(low);
+		soft_i2c_scl_h(bus);
+#if SOFT_I2C_STRETCH_ENABLE
+		if(!soft_i2c_scl_read(bus) && soft_i2c_scl_release(soft_i2c,bus))
+			return 1;
+#endif
+		soft_i2c_delay_loop(high);
+		soft_i2c_scl_l(bus);
+		soft_i2c_sda_h(bus);
+		I2C_TRACE_RX(I2C_TRACE_BUS_SOFT(soft_i2c), 1);
+	}
+	return 0;
+}
+
+/**
+  * @brief  从指定I2C设备的寄存器读取一个字节
+  * @details I2C通信流程：START -> 发送从机地址(写) -> 发送寄存器地址 -> 
+  *          重复START -> 发送从机地址(读) -> 读取数据 -> NACK -> STOP
+  * @param  soft_i2c: I2C编号
+  *   @arg  SOFT_I2C1: 软件I2C1
+  *   @arg  SOFT_I2C2: 软件I2C2
+  * @param  addr: I2C设备地址（7位，不包含读写位）
+  * @param  reg: 设备寄存器地址
+  * @param  data: 指向数据保存缓冲区的指针
+  * @retval 0: 读取成功
+  * @retval 1: 读取失败
+  */
+uint8_t soft_i2c_read_dev_one_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t reg,uint8_t *data)
+{
+    if(soft_i2c_start(soft_i2c))
+        return 1;
+    soft_i2c_send_byte(soft_i2c,(addr<<1)|0);     
+    if(soft_i2c_wait_ack(soft_i2c))               
+    {
+        soft_i2c_stop(soft_i2c);
+        return 1;
+    }
+    soft_i2c_send_byte(soft_i2c,reg);             
+    if(soft_i2c_wait_ack(soft_i2c))               
+    {
+        soft_i2c_stop(soft_i2c);
+        return 1;
+    }
+    if(soft_i2c_start(soft_i2c))
+    {
+        soft_i2c_stop(soft_i2c);
+        return 1;
+    }
+    soft_i2c_send_byte(soft_i2c,(addr<<1)|1);     
+    if(soft_i2c_wait_ack(soft_i2c))               
+    {
+        soft_i2c_stop(soft_i2c);
+        return 1;
+    }
+    *data = soft_i2c_read_byte(soft_i2c,0);    
+    soft_i2c_stop(soft_i2c);
+
+    return soft_i2c_stretch_fail[soft_i2c];
+}
+
+/**
+  * @brief  向指定I2C设备的寄存器写入一个字节
+  * @details I2C通信流程：START -> 发送从机地址(写) -> 发送寄存器地址 -> 
+  *          发送数据字节 -> STOP
+  * @param  soft_i2c: I2C编号
+  *   @arg  SOFT_I2C1: 软件I2C1
+  *   @arg  SOFT_I2C2: 软件I2C2
+  * @param  addr: I2C设备地址（7位，不包含读写位）
+  * @param  reg: 设备寄存器地址
+  * @param  data: 待写入的字节数据
+  * @retval 0: 写入成功
+  * @retval 1: 写入失败
+  */
+uint8_t soft_i2c_write_dev_one_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t reg,uint8_t data)
+{
+    if(soft_i2c_start(soft_i2c))
+        return 1;
+    soft_i2c_send_byte(soft_i2c,(addr<<1)|0);      
+    if(soft_i2c_wait_ack(soft_i2c))               
+    {
+        soft_i2c_stop(soft_i2c);
+        return 1;
+    }
+    soft_i2c_send_byte(soft_i2c,reg);             
+    if(soft_i2c_wait_ack(soft_i2c))                
+    {
+        soft_i2c_stop(soft_i2c);
+        return 1;
+    }
+    soft_i2c_send_byte(soft_i2c,data);             
+    if(soft_i2c_wait_ack(soft_i2c))                
+    {
+        soft_i2c_stop(soft_i2c);
+        return 1;
+    }
+    soft_i2c_stop(soft_i2c);
+    return 0;
+}
+
+/**
+  * @brief  从指定I2C设备的寄存器读取多个字节
+  * @details I2C通信流程：START -> 发送从机地址(写) -> 发送寄存器地址 -> 
+  *          重复START -> 发送从机地址(读) -> 连续读取len个字节 -> 
+  *          最后一个字节后NACK -> STOP
+  * @param  soft_i2c: I2C编号
+  *   @arg  SOFT_I2C1: 软件I2C1
+  *   @arg  SOFT_I2C2: 软件I2C2
+  * @param  addr: I2C设备地址（7位，不包含读写位）
+  * @param  reg: 设备寄存器地址
+  * @param  len: 读取字节数（必须大于0，可以超过255，例如MPU6050整个DMP存储区）
+  * @param  buf: 指向数据保存缓冲区的指针
+  * @retval 0: 读取成功
+  * @retval 1: 读取失败或长度为0
+  * @note   数据字节使用块读取（soft_i2c_read_block），多字节连续读取时总线时间更短
+  */
+uint8_t soft_i2c_read_dev_len_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t reg,uint16_t len,uint8_t *buf)
+{
+    //长度为0时从机已经开始输出第一个字节，主机无法正常产生STOP，直接拒绝
+    if(len == 0)
+        return 1;
+    if(soft_i2c_start(soft_i2c))
+        return 1;
+    soft_i2c_send_byte(soft_i2c,(addr<<1)|0);  
+    if(soft_i2c_wait_ack(soft_i2c))          
+    {
+        soft_i2c_stop(soft_i2c);
+        return 1;
+    }
+    soft_i2c_send_byte(soft_i2c,reg); 
+    if(soft_i2c_wait_ack(soft_i2c))                
+    {
+        soft_i2c_stop(soft_i2c);
+        return 1;
+    }
+    if(soft_i2c_start(soft_i2c))
+    {
+        soft_i2c_stop(soft_i2c);
+        return 1;
+    }
+    soft_i2c_send_byte(soft_i2c,(addr<<1)|1); 
+    if(soft_i2c_wait_ack(soft_i2c))                
+    {
+        soft_i2c_stop(soft_i2c);
+        return 1;
+    }
+    if(soft_i2c_read_block(soft_i2c,buf,len))
+    {
+        soft_i2c_stop(soft_i2c);
+        return 1;
+    }
+    soft_i2c_stop(soft_i2c);                
+    return 0;
+}
+
+/**
+  * @brief  向指定I2C设备的寄存器写入多个字节
+  * @details I2C通信流程：START -> 发送从机地址(写) -> 发送寄存器地址 -> 
+  *          连续发送len个字节，每个字节后等待应答 -> STOP
+  * @param  soft_i2c: I2C编号
+  *   @arg  SOFT_I2C1: 软件I2C1
+  *   @arg  SOFT_I2C2: 软件I2C2
+  * @param  addr: I2C设备地址（7位，不包含读写位）
+  * @param  reg: 设备寄存器地址
+  * @param  len: 写入字节数（可以超过255）
+  * @param  buf: 指向待写入数据的缓冲区指针
+  * @retval 0: 写入成功
+  * @retval 1: 写入失败
+  */
+uint8_t soft_i2c_write_dev_len_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t reg,uint16_t len,uint8_t *buf)
+{
+    uint16_t i;
+    if(soft_i2c_start(soft_i2c))
+        return 1;
+    soft_i2c_send_byte(soft_i2c,(addr<<1)|0);  
+    if(soft_i2c_wait_ack(soft_i2c))         
+    {
+        soft_i2c_stop(soft_i2c);
+        return 1;
+    }
+    soft_i2c_send_byte(soft_i2c,reg); 
+    if(soft_i2c_wait_ack(soft_i2c))               
+    {
+        soft_i2c_stop(soft_i2c);
+        return 1;
+    }
+    for(i=0; i<len; i++)
+    {
+        soft_i2c_send_byte(soft_i2c,buf[i]);  
+        if(soft_i2c_wait_ack(soft_i2c))          
+		{
+			soft_i2c_stop(soft_i2c);
+			return 1;
+		}
+    }
+    soft_i2c_stop(soft_i2c);
+    return 0;
+}
+
+/**
+  * @brief  向I2C设备写入数据（简化接口）
+  * @details I2C通信流程：START -> 发送从机地址(写) -> 连续发送len个字节 ->
+  *          每个字节后等待应答 -> STOP
+  *          相比 soft_i2c_write_dev_len_byte，此函数不需要指定寄存器地址
+  * @param  soft_i2c: I2C编号
+  *   @arg  SOFT_I2C1: 软件I2C1
+  *   @arg  SOFT_I2C2: 软件I2C2
+  * @param  addr: I2C设备地址（7位，不包含读写位）
+  * @param  buf: 指向待写入数据的缓冲区指针
+  * @param  len: 写入字节数
+  * @retval 0: 写入成功
+  * @retval 1: 写入失败
+  */
+uint8_t soft_i2c_write(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,const uint8_t *buf,uint8_t len)
+{
+    uint8_t i;
+
+    if (soft_i2c_start(soft_i2c))
+        return 1;
+
+    soft_i2c_send_byte(soft_i2c, (addr << 1) | 0);
+    if (soft_i2c_wait_ack(soft_i2c))
+        goto err;
+
+    for (i = 0; i < len; i++)
+    {
+        soft_i2c_send_byte(soft_i2c, buf[i]);
+        if (soft_i2c_wait_ack(soft_i2c))
+            goto err;
+    }
+
+    soft_i2c_stop(soft_i2c);
+    return 0;
+
+err:
+    soft_i2c_stop(soft_i2c);
+    return 1;
+}
+
+/**
+  * @brief  从I2C设备读取数据（简化接口）
+  * @details I2C通信流程：START -> 发送从机地址(读) -> 连续读取len个字节 ->
+  *          最后一个字节后NACK -> STOP
+  *          相比 soft_i2c_read_dev_len_byte，此函数不需要指定寄存器地址
+  * @param  soft_i2c: I2C编号
+  *   @arg  SOFT_I2C1: 软件I2C1
+  *   @arg  SOFT_I2C2: 软件I2C2
+  * @param  addr: I2C设备地址（7位，不包含读写位）
+  * @param  buf: 指向数据保存缓冲区的指针
+  * @param  len: 读取字节数（必须大于0）
+  * @retval 0: 读取成功
+  * @retval 1: 读取失败或长度为0
+  * @note   当len为0时返回失败
+  */
+uint8_t soft_i2c_read(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t *buf,uint8_t len)
+{
+    if (len == 0)
+        return 1;
+
+    if (soft_i2c_start(soft_i2c))
+        return 1;
+
+    soft_i2c_send_byte(soft_i2c, (addr << 1) | 1);
+    if (soft_i2c_wait_ack(soft_i2c))
+        goto err;
+
+    if (soft_i2c_read_block(soft_i2c, buf, len))
+        goto err;
+
+    soft_i2c_stop(soft_i2c);
+    return 0;
+
+err:
+    soft_i2c_stop(soft_i2c);
+    return 1;
+}
+
+/* ======================== 并行软件I2C ======================== */
+/*
+ * 并行总线上的所有设备收到完全相同的时钟和主机数据，因此起始、停止、发送字节
+ * 都是对全部SDA引脚同时操作；只有从机返回的数据（应答位和读出的字节）各不相同，
+ * 每个时钟沿读一次IDR保存下来，字节结束后再按引脚拆分到各设备的缓冲区。
+ * 某个设备无应答时不能单独停止它（SCL是共用的），传输继续进行，
+ * 该设备的SDA保持释放，读出的数据为0xFF，并在返回的失败掩码中标出。
+ */
+
+#define soft_i2c_par_delay_high(par)  soft_i2c_delay_loop(soft_i2c_par[par].high_loops)
+#define soft_i2c_par_delay_low(par)   soft_i2c_delay_loop(soft_i2c_par[par].low_loops)
+
+/**
+  * @brief  释放共用SCL并等待其变高（任意一个从机都可以拉伸时钟）
+  * @param  bus: 并行总线描述符
+  * @retval 0: SCL已变高 1: 时钟拉伸超时
+  */
+static uint8_t soft_i2c_par_scl_release(const soft_i2c_bus_t *bus)
+{
+#if SOFT_I2C_STRETCH_ENABLE
+	uint32_t start;
+
+	soft_i2c_scl_h(bus);
+	if(soft_i2c_scl_read(bus))
+		return 0;
+	start = DWT_CYCCNT_REG;
+	while(!soft_i2c_scl_read(bus))
+	{
+		if(DWT_CYCCNT_REG - start > soft_i2c_stretch_cycles)
+			return 1;
+	}
+	return 0;
+#else
+	soft_i2c_scl_h(bus);
+	return 0;
+#endif
+}
+
+/**
+  * @brief  将SDA引脚掩码转换为设备序号掩码
+  * @param  par: 并行总线编号
+  * @param  pins: SDA引脚掩码（IDR中对应位）
+  * @retval 设备序号掩码，bit n 对应第n个设备
+  */
+static uint16_t soft_i2c_par_pin_to_dev(SOFT_I2C_PAR_TypeDef par,uint32_t pins)
+{
+	uint16_t mask = 0;
+	uint8_t d;
+
+	for(d = 0; d < soft_i2c_par[par].num; d++)
+	{
+		if(pins & (1u << soft_i2c_par[par].shift[d]))
+			mask |= 1u << d;
+	}
+	return mask;
+}
+
+/**
+  * @brief  并行总线产生起始信号
+  * @param  par: 并行总线编号
+  * @retval 0: 成功 1: SCL或某根SDA被拉低，总线不可用
+  */
+static uint8_t soft_i2c_par_start(SOFT_I2C_PAR_TypeDef par)
+{
+	const soft_i2c_bus_t *bus = &soft_i2c_par_bus[par];
+
+	soft_i2c_sda_h(bus);
+	if(soft_i2c_par_scl_release(bus) || soft_i2c_sda_read(bus) != bus->sda_pin)
+		return 1;
+	soft_i2c_par_delay_high(par);
+	soft_i2c_sda_l(bus);
+	soft_i2c_par_delay_high(par);
+	soft_i2c_scl_l(bus);
+	return 0;
+}
+
+/**
+  * @brief  并行总线产生停止信号
+  * @param  par: 并行总线编号
+  * @retval 无
+  */
+static void soft_i2c_par_stop(SOFT_I2C_PAR_TypeDef par)
+{
+	const soft_i2c_bus_t *bus = &soft_i2c_par_bus[par];
+
+	soft_i2c_scl_l(bus);
+	soft_i2c_sda_l(bus);
+	soft_i2c_par_delay_low(par);
+	soft_i2c_par_scl_release(bus);
+	soft_i2c_par_delay_high(par);
+	soft_i2c_sda_h(bus);
+	soft_i2c_par_delay_low(par);
+}
+
+/**
+  * @brief  向全部设备发送同一个字节并采样各自的应答
+  * @param  par: 并行总线编号
+  * @param  txd: 待发送字节
+  * @retval 无应答的SDA引脚掩码；时钟拉伸超时返回全部SDA引脚
+  */
+static uint32_t soft_i2c_par_send_byte(SOFT_I2C_PAR_TypeDef par,uint8_t txd)
+{
+	const soft_i2c_bus_t *bus = &soft_i2c_par_bus[par];
+	uint32_t nack;
+	uint8_t i;
+
+	soft_i2c_scl_l(bus);
+	for(i = 0; i < 8; i++)
+	{
+		if(txd & 0x80)
+			soft_i2c_sda_h(bus);
+		else
+			soft_i2c_sda_l(bus);
+		txd <<= 1;
+		soft_i2c_par_delay_low(par);
+		if(soft_i2c_par_scl_release(bus))
+			return bus->sda_pin;
+		soft_i2c_par_delay_high(par);
+		soft_i2c_scl_l(bus);
+	}
+
+	//第9个时钟：释放SDA，读取全部设备的应答
+	soft_i2c_sda_h(bus);
+	soft_i2c_par_delay_low(par);
+	if(soft_i2c_par_scl_release(bus))
+		return bus->sda_pin;
+	nack = soft_i2c_sda_read(bus);
+	soft_i2c_par_delay_high(par);
+	soft_i2c_scl_l(bus);
+	return nack;
+}
+
+/**
+  * @brief  从全部设备同时读取多个字节
+  * @details 与 soft_i2c_read_block 相同的时序（ACK时钟折叠进下一字节），
+  *          每个数据位只读一次IDR，8个采样在字节结束后拆分到各设备
+  * @param  par: 并行总线编号
+  * @param  buf: 数据缓冲区，第d个设备的数据存放在 buf[d*len] 开始处
+  * @param  len: 每个设备读取的字节数（必须大于0）
+  * @retval 0: 成功 1: 时钟拉伸超时
+  */
+static uint8_t soft_i2c_par_read_block(SOFT_I2C_PAR_TypeDef par,uint8_t *buf,uint8_t len)
+{
+	const soft_i2c_bus_t *bus = &soft_i2c_par_bus[par];
+	const uint32_t high = soft_i2c_par[par].high_loops;
+	const uint32_t low  = soft_i2c_par[par].low_loops;
+	const uint8_t num = soft_i2c_par[par].num;
+	uint32_t sample[8];
+	uint32_t rx;
+	uint8_t i, b, d, shift;
+
+	soft_i2c_sda_h(bus);
+	for(i = 0; i < len; i++)
+	{
+		for(b = 0; b < 8; b++)
+		{
+			soft_i2c_scl_l(bus);
+			soft_i2c_delay_loop(low);
+			soft_i2c_scl_h(bus);
+#if SOFT_I2C_STRETCH_ENABLE
+			if(!soft_i2c_scl_read(bus) && soft_i2c_par_scl_release(bus))
+				return 1;
+#endif
+			sample[b] = *bus->idr;
+			soft_i2c_delay_loop(high);
+		}
+
+		//第9个时钟：还有数据则全部ACK，最后一个字节全部NACK
+		soft_i2c_scl_l(bus);
+		if(i + 1 < len)
+			soft_i2c_sda_l(bus);
+
+		//拆分放在SCL低电平期间进行，主机拉长低电平不影响从机
+		for(d = 0; d < num; d++)
+		{
+			shift = soft_i2c_par[par].shift[d];
+			rx = 0;
+			for(b = 0; b < 8; b++)
+				rx = (rx << 1) | ((sample[b] >> shift) & 1);
+			buf[d * len + i] = (uint8_t)rx;
+		}
+
+		soft_i2c_delay_loop(low);
+		if(soft_i2c_par_scl_release(bus))
+			return 1;
+		soft_i2c_delay_loop(high);
+		soft_i2c_scl_l(bus);
+		soft_i2c_sda_h(bus);
+	}
+	return 0;
+}
+
+/**
+  * @brief  获取并行总线上的设备数
+  * @param  par: 并行总线编号
+  * @retval 设备数（soft_i2c_par_init 之后有效）
+  */
+uint8_t soft_i2c_par_dev_num(SOFT_I2C_PAR_TypeDef par)
+{
+	return soft_i2c_par[par].num;
+}
+
+/**
+  * @brief  向并行总线上全部设备的同一寄存器写入同一个字节
+  * @param  par: 并行总线编号
+  * @param  addr: I2C设备地址（7位，各设备相同）
+  * @param  reg: 设备寄存器地址
+  * @param  data: 待写入的字节数据
+  * @retval 失败设备掩码，bit n 为1表示第n个设备无应答；0 表示全部成功
+  */
+uint16_t soft_i2c_par_write_dev_one_byte(SOFT_I2C_PAR_TypeDef par,uint8_t addr,uint8_t reg,uint8_t data)
+{
+	uint32_t nack;
+
+	if(soft_i2c_par_start(par))
+		return soft_i2c_par_pin_to_dev(par, soft_i2c_par_bus[par].sda_pin);
+	nack  = soft_i2c_par_send_byte(par, (addr << 1) | 0);
+	nack |= soft_i2c_par_send_byte(par, reg);
+	nack |= soft_i2c_par_send_byte(par, data);
+	soft_i2c_par_stop(par);
+	return soft_i2c_par_pin_to_dev(par, nack);
+}
+
+/**
+  * @brief  从并行总线上全部设备的寄存器同时读取多个字节
+  * @details 通信流程与 soft_i2c_read_dev_len_byte 相同，全部设备共用一次总线传输
+  * @param  par: 并行总线编号
+  * @param  addr: I2C设备地址（7位，各设备相同）
+  * @param  reg: 设备寄存器地址
+  * @param  len: 每个设备读取的字节数（必须大于0）
+  * @param  buf: 数据缓冲区，大小至少为 设备数*len，第d个设备的数据存放在 buf[d*len] 开始处
+  * @retval 失败设备掩码，bit n 为1表示第n个设备无应答（其数据为0xFF）；0 表示全部成功
+  *         总线不可用或时钟拉伸超时时全部设备置位
+  */
+uint16_t soft_i2c_par_read_dev_len_byte(SOFT_I2C_PAR_TypeDef par,uint8_t addr,uint8_t reg,uint8_t len,uint8_t *buf)
+{
+	const uint32_t all = soft_i2c_par_bus[par].sda_pin;
+	uint32_t nack;
+
+	if(len == 0 || soft_i2c_par_start(par))
+		return soft_i2c_par_pin_to_dev(par, all);
+	nack  = soft_i2c_par_send_byte(par, (addr << 1) | 0);
+	nack |= soft_i2c_par_send_byte(par, reg);
+	if(nack == all || soft_i2c_par_start(par))
+	{
+		soft_i2c_par_stop(par);
+		return soft_i2c_par_pin_to_dev(par, all);
+	}
+	nack |= soft_i2c_par_send_byte(par, (addr << 1) | 1);
+	if(nack == all || soft_i2c_par_read_block(par, buf, len))
+	{
+		soft_i2c_par_stop(par);
+		return soft_i2c_par_pin_to_dev(par, all);
+	}
+	soft_i2c_par_stop(par);
+	return soft_i2c_par_pin_to_dev(par, nack);
+}
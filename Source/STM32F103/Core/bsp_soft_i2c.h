@@ -1,29 +1,116 @@
-#ifndef _BSP_SOFT_I2C_H
-#define _BSP_SOFT_I2C_H
-
-#include <stdint.h>
-
-typedef enum {
-	SOFT_I2C1 = 0,
-	SOFT_I2C2 ,
-}SOFT_I2C_TypeDef;
-
-void soft_i2c_init(SOFT_I2C_TypeDef soft_i2c);
-void soft_i2c_start(SOFT_I2C_TypeDef soft_i2c);
-void soft_i2c_stop(SOFT_I2C_TypeDef soft_i2c);
-uint8_t soft_i2c_wait_ack(SOFT_I2C_TypeDef soft_i2c);
-void soft_i2c_ack(SOFT_I2C_TypeDef soft_i2c);
-void soft_i2c_nack(SOFT_I2C_TypeDef soft_i2c);
-void soft_i2c_send_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t txd);
-uint8_t soft_i2c_read_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t ack);
-
-uint8_t soft_i2c_write_dev_one_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t reg,uint8_t data);
-uint8_t soft_i2c_read_dev_one_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t reg,uint8_t *data);
-uint8_t soft_i2c_write_dev_len_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t reg,uint8_t len,uint8_t *buf);
-uint8_t soft_i2c_read_dev_len_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t reg,uint8_t len,uint8_t *buf);
-
-uint8_t soft_i2c_write(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,const uint8_t *buf,uint8_t len);
-uint8_t soft_i2c_read(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t *buf,uint8_t len);
-
-#endif
-
+#ifndef _BSP_SOFT_I2C_H
+#define _BSP_SOFT_I2C_H
+
+#include <stdint.h>
+#include "stm32f10x.h"
+
+typedef enum {
+	SOFT_I2C_SPEED_STANDARD = 0,   //标准模式 100kHz
+	SOFT_I2C_SPEED_FAST,           //快速模式 400kHz
+	SOFT_I2C_SPEED_FAST_PLUS,      //增强快速模式 1MHz
+}SOFT_I2C_Speed_TypeDef;
+
+/****************** user port area start ****************/
+/**
+  * 软件I2C总线引脚绑定表（编译期确定）
+  * 每一行描述一条总线：X(总线编号, GPIO端口, 端口时钟, SCL引脚, SDA引脚, 默认速度)
+  * 新增总线只需在此追加一行，总线编号会自动加入 SOFT_I2C_TypeDef
+  * 注意：SCL和SDA必须位于同一个GPIO端口
+  */
+#define SOFT_I2C_BUS_LIST(X) \
+	X(SOFT_I2C1, GPIOB, RCC_APB2Periph_GPIOB, GPIO_Pin_6,  GPIO_Pin_7 , SOFT_I2C_SPEED_FAST    ) \
+	X(SOFT_I2C2, GPIOB, RCC_APB2Periph_GPIOB, GPIO_Pin_10, GPIO_Pin_11, SOFT_I2C_SPEED_STANDARD)
+
+//从机时钟拉伸的最长等待时间（us），超时后本次传输失败
+#define SOFT_I2C_STRETCH_TIMEOUT_US   1000
+//1: 支持从机时钟拉伸，每次释放SCL后回读确认其变高  0: 总线上没有会拉伸时钟的从机，释放SCL后不再回读
+#define SOFT_I2C_STRETCH_ENABLE       1
+
+/**
+  * 并行软件I2C总线表：多个相同的设备共用一根SCL，每个设备单独占用一根SDA
+  * 每个时钟沿只读一次IDR就能同时采样全部设备，N个设备的读取时间与1个设备相同
+  * 每一行描述一组设备：X(总线编号, GPIO端口, 端口时钟, SCL引脚, SDA引脚掩码, 默认速度)
+  * 设备序号按SDA引脚号从小到大排列，最多16个
+  * 注意：SCL和全部SDA必须位于同一个GPIO端口；示例引脚与SPI2冲突，二者择一使用
+  */
+#define SOFT_I2C_PAR_LIST(X) \
+	X(SOFT_I2C_PAR1, GPIOB, RCC_APB2Periph_GPIOB, GPIO_Pin_12, GPIO_Pin_13|GPIO_Pin_14|GPIO_Pin_15, SOFT_I2C_SPEED_FAST)
+/****************** user port area end   ****************/
+
+#define SOFT_I2C_BUS_ENUM(name, port, rcc, scl, sda, speed)  name,
+
+typedef enum {
+	SOFT_I2C_BUS_LIST(SOFT_I2C_BUS_ENUM)
+	SOFT_I2C_BUS_NUM
+}SOFT_I2C_TypeDef;
+
+/* 总线描述符：端口寄存器地址在编译期算好，每次翻转只需一次写操作 */
+typedef struct {
+	volatile uint32_t *bsrr;   //置位寄存器地址（写1拉高）
+	volatile uint32_t *brr;    //复位寄存器地址（写1拉低）
+	volatile uint32_t *idr;    //输入寄存器地址
+	uint16_t scl_pin;          //SCL引脚掩码
+	uint16_t sda_pin;          //SDA引脚掩码
+	GPIO_TypeDef *port;        //GPIO端口
+	uint32_t rcc;              //端口时钟
+	SOFT_I2C_Speed_TypeDef speed;  //默认速度
+}soft_i2c_bus_t;
+
+extern const soft_i2c_bus_t soft_i2c_bus[SOFT_I2C_BUS_NUM];
+
+typedef enum {
+	SOFT_I2C_PAR_LIST(SOFT_I2C_BUS_ENUM)
+	SOFT_I2C_PAR_NUM
+}SOFT_I2C_PAR_TypeDef;
+
+#define SOFT_I2C_PAR_DEV_MAX   16   //一组并行总线最多的设备数（一个GPIO端口16个引脚）
+
+/* 并行总线复用总线描述符，sda_pin 为全部SDA引脚的掩码 */
+extern const soft_i2c_bus_t soft_i2c_par_bus[SOFT_I2C_PAR_NUM];
+
+/* 总线错误计数 */
+typedef struct {
+	uint32_t nack;             //从机无应答次数
+	uint32_t stretch_timeout;  //时钟拉伸超时次数
+	uint32_t bus_recover;      //总线恢复次数
+	uint32_t recover_fail;     //总线恢复失败次数
+}soft_i2c_err_t;
+
+/* 引脚访问内联函数（开漏输出，拉高即释放总线） */
+static __INLINE void soft_i2c_scl_h(const soft_i2c_bus_t *bus) { *bus->bsrr = bus->scl_pin; }
+static __INLINE void soft_i2c_scl_l(const soft_i2c_bus_t *bus) { *bus->brr  = bus->scl_pin; }
+static __INLINE void soft_i2c_sda_h(const soft_i2c_bus_t *bus) { *bus->bsrr = bus->sda_pin; }
+static __INLINE void soft_i2c_sda_l(const soft_i2c_bus_t *bus) { *bus->brr  = bus->sda_pin; }
+static __INLINE uint32_t soft_i2c_sda_read(const soft_i2c_bus_t *bus) { return *bus->idr & bus->sda_pin; }
+static __INLINE uint32_t soft_i2c_scl_read(const soft_i2c_bus_t *bus) { return *bus->idr & bus->scl_pin; }
+
+void soft_i2c_init(SOFT_I2C_TypeDef soft_i2c);
+void soft_i2c_set_speed(SOFT_I2C_TypeDef soft_i2c,SOFT_I2C_Speed_TypeDef speed);
+uint32_t soft_i2c_get_scl_freq(SOFT_I2C_TypeDef soft_i2c);
+uint8_t soft_i2c_start(SOFT_I2C_TypeDef soft_i2c);
+void soft_i2c_stop(SOFT_I2C_TypeDef soft_i2c);
+uint8_t soft_i2c_wait_ack(SOFT_I2C_TypeDef soft_i2c);
+void soft_i2c_ack(SOFT_I2C_TypeDef soft_i2c);
+void soft_i2c_nack(SOFT_I2C_TypeDef soft_i2c);
+void soft_i2c_send_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t txd);
+uint8_t soft_i2c_read_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t ack);
+
+uint8_t soft_i2c_bus_recover(SOFT_I2C_TypeDef soft_i2c);
+const soft_i2c_err_t *soft_i2c_get_error(SOFT_I2C_TypeDef soft_i2c);
+void soft_i2c_clear_error(SOFT_I2C_TypeDef soft_i2c);
+
+uint8_t soft_i2c_write_dev_one_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t reg,uint8_t data);
+uint8_t soft_i2c_read_dev_one_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t reg,uint8_t *data);
+uint8_t soft_i2c_write_dev_len_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t reg,uint16_t len,uint8_t *buf);
+uint8_t soft_i2c_read_dev_len_byte(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t reg,uint16_t len,uint8_t *buf);
+
+uint8_t soft_i2c_write(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,const uint8_t *buf,uint8_t len);
+uint8_t soft_i2c_read(SOFT_I2C_TypeDef soft_i2c,uint8_t addr,uint8_t *buf,uint8_t len);
+
+void soft_i2c_par_init(SOFT_I2C_PAR_TypeDef par);
+void soft_i2c_par_set_speed(SOFT_I2C_PAR_TypeDef par,SOFT_I2C_Speed_TypeDef speed);
+uint8_t soft_i2c_par_dev_num(SOFT_I2C_PAR_TypeDef par);
+uint16_t soft_i2c_par_write_dev_one_byte(SOFT_I2C_PAR_TypeDef par,uint8_t addr,uint8_t reg,uint8_t data);
+uint16_t soft_i2c_par_read_dev_len_byte(SOFT_I2C_PAR_TypeDef par,uint8_t addr,uint8_t reg,uint8_t len,uint8_t *buf);
+
+#endif
@@ -1,8 +1,8 @@
 #include "bsp_spi.h"
 
-//SPIģĳʼ룬óģʽSD Card/W25X16/24L01/JF24C
-//SPIڳʼ
-//ǶSPI1ĳʼ
+//以下是SPI模块的初始化代码，配置成主机模式，访问SD Card/W25X16/24L01/JF24C
+//SPI口初始化
+//这里针是对SPI1的初始化
 
 SPI_InitTypeDef  SPI1_InitStructure;
 
@@ -13,34 +13,34 @@ void SPI1_Init(void)
     RCC_APB2PeriphClockCmd(	RCC_APB2Periph_GPIOA|RCC_APB2Periph_SPI1, ENABLE );
 
     GPIO_InitStructure.GPIO_Pin = GPIO_Pin_5 | GPIO_Pin_6 | GPIO_Pin_7;
-    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;  //
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;  //复用推挽输出
     GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
     GPIO_Init(GPIOA, &GPIO_InitStructure);
 
     GPIO_SetBits(GPIOA,GPIO_Pin_5|GPIO_Pin_6|GPIO_Pin_7);
 
-    SPI1_InitStructure.SPI_Direction = SPI_Direction_2Lines_FullDuplex;  //SPI˫ģʽ:SPIΪ˫˫ȫ˫
-    SPI1_InitStructure.SPI_Mode = SPI_Mode_Master;		//SPIģʽ:ΪSPI
-    SPI1_InitStructure.SPI_DataSize = SPI_DataSize_8b;		//SPIݴС:SPIͽ8λ֡ṹ
-    SPI1_InitStructure.SPI_CPOL = SPI_CPOL_High;		//ѡ˴ʱӵ̬:ʱո
-    SPI1_InitStructure.SPI_CPHA = SPI_CPHA_2Edge;	//ݲڵڶʱ
-    SPI1_InitStructure.SPI_NSS = SPI_NSS_Soft;		//NSSźӲNSSܽţʹSSIλ:ڲNSSźSSIλ
-    SPI1_InitStructure.SPI_BaudRatePrescaler = SPI_BaudRatePrescaler_256;		//岨ԤƵֵ:ԤƵֵΪ256
-    SPI1_InitStructure.SPI_FirstBit = SPI_FirstBit_MSB;	//ָݴMSBλLSBλʼ:ݴMSBλʼ
-    SPI1_InitStructure.SPI_CRCPolynomial = 7;	//CRCֵĶʽ
-    SPI_Init(SPI1, &SPI1_InitStructure);  //SPI_InitStructָĲʼSPIxĴ
-
-    SPI_Cmd(SPI1, ENABLE); //ʹSPI
-
-    SPI1_ReadWriteByte(0xff);//
-    SPI1_SetSpeed(SPI_BaudRatePrescaler_4);	//Ϊ18Mʱ,ģʽ
+    SPI1_InitStructure.SPI_Direction = SPI_Direction_2Lines_FullDuplex;  //设置SPI单向或者双向的数据模式:SPI设置为双线双向全双工
+    SPI1_InitStructure.SPI_Mode = SPI_Mode_Master;		//设置SPI工作模式:设置为主SPI
+    SPI1_InitStructure.SPI_DataSize = SPI_DataSize_8b;		//设置SPI的数据大小:SPI发送接收8位帧结构
+    SPI1_InitStructure.SPI_CPOL = SPI_CPOL_High;		//选择了串行时钟的稳态:时钟悬空高
+    SPI1_InitStructure.SPI_CPHA = SPI_CPHA_2Edge;	//数据捕获于第二个时钟沿
+    SPI1_InitStructure.SPI_NSS = SPI_NSS_Soft;		//NSS信号由硬件（NSS管脚）还是软件（使用SSI位）管理:内部NSS信号有SSI位控制
+    SPI1_InitStructure.SPI_BaudRatePrescaler = SPI_BaudRatePrescaler_256;		//定义波特率预分频的值:波特率预分频值为256
+    SPI1_InitStructure.SPI_FirstBit = SPI_FirstBit_MSB;	//指定数据传输从MSB位还是LSB位开始:数据传输从MSB位开始
+    SPI1_InitStructure.SPI_CRCPolynomial = 7;	//CRC值计算的多项式
+    SPI_Init(SPI1, &SPI1_InitStructure);  //根据SPI_InitStruct中指定的参数初始化外设SPIx寄存器
+
+    SPI_Cmd(SPI1, ENABLE); //使能SPI外设
+
+    SPI1_ReadWriteByte(0xff);//启动传输
+    SPI1_SetSpeed(SPI_BaudRatePrescaler_4);	//设置为18M时钟,高速模式
 }
-//SPI ٶú
+//SPI 速度设置函数
 //SpeedSet:
-//SPI_BaudRatePrescaler_2   2Ƶ   (SPI 36M@sys 72M)
-//SPI_BaudRatePrescaler_8   8Ƶ   (SPI 9M@sys 72M)
-//SPI_BaudRatePrescaler_16  16Ƶ  (SPI 4.5M@sys 72M)
-//SPI_BaudRatePrescaler_256 256Ƶ (SPI 281.25K@sys 72M)
+//SPI_BaudRatePrescaler_2   2分频   (SPI 36M@sys 72M)
+//SPI_BaudRatePrescaler_8   8分频   (SPI 9M@sys 72M)
+//SPI_BaudRatePrescaler_16  16分频  (SPI 4.5M@sys 72M)
+//SPI_BaudRatePrescaler_256 256分频 (SPI 281.25K@sys 72M)
 
 void SPI1_SetSpeed(uint8_t SpeedSet)
 {
@@ -49,26 +49,26 @@ void SPI1_SetSpeed(uint8_t SpeedSet)
     SPI_Cmd(SPI1,ENABLE);
 }
 
-//SPIx дһֽ
-//TxData:Ҫдֽ
-//ֵ:ȡֽ
+//SPIx 读写一个字节
+//TxData:要写入的字节
+//返回值:读取到的字节
 uint8_t SPI1_ReadWriteByte(uint8_t TxData)
 {
     uint8_t retry=0;
-    while (SPI_I2S_GetFlagStatus(SPI1, SPI_I2S_FLAG_TXE) == RESET) //ָSPI־λ:ͻձ־λ
+    while (SPI_I2S_GetFlagStatus(SPI1, SPI_I2S_FLAG_TXE) == RESET) //检查指定的SPI标志位设置与否:发送缓存空标志位
     {
         retry++;
         if(retry>200)return 0;
     }
-    SPI_I2S_SendData(SPI1, TxData); //ͨSPIxһ
+    SPI_I2S_SendData(SPI1, TxData); //通过外设SPIx发送一个数据
     retry=0;
 
-    while (SPI_I2S_GetFlagStatus(SPI1, SPI_I2S_FLAG_RXNE) == RESET)//ָSPI־λ:ܻǿձ־λ
+    while (SPI_I2S_GetFlagStatus(SPI1, SPI_I2S_FLAG_RXNE) == RESET)//检查指定的SPI标志位设置与否:接受缓存非空标志位
     {
         retry++;
         if(retry>200)return 0;
     }
-    return SPI_I2S_ReceiveData(SPI1); //ͨSPIxյ
+    return SPI_I2S_ReceiveData(SPI1); //返回通过SPIx最近接收的数据
 }
 
 SPI_InitTypeDef  SPI2_InitStructure;
@@ -81,34 +81,34 @@ void SPI2_Init(void)
     RCC_APB1PeriphClockCmd( RCC_APB1Periph_SPI2, ENABLE );
 
     GPIO_InitStructure.GPIO_Pin = GPIO_Pin_13 | GPIO_Pin_14 | GPIO_Pin_15;
-    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;  //
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;  //复用推挽输出
     GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
     GPIO_Init(GPIOB, &GPIO_InitStructure);
 
     GPIO_SetBits(GPIOB,GPIO_Pin_13|GPIO_Pin_14|GPIO_Pin_15);
 
-    SPI2_InitStructure.SPI_Direction = SPI_Direction_2Lines_FullDuplex;  //SPI˫ģʽ:SPIΪ˫˫ȫ˫
-    SPI2_InitStructure.SPI_Mode = SPI_Mode_Master;		//SPIģʽ:ΪSPI
-    SPI2_InitStructure.SPI_DataSize = SPI_DataSize_8b;		//SPIݴС:SPIͽ8λ֡ṹ
-    SPI2_InitStructure.SPI_CPOL = SPI_CPOL_Low;		//ѡ˴ʱӵ̬:ʱո
-    SPI2_InitStructure.SPI_CPHA = SPI_CPHA_1Edge;	//ݲڵڶʱ
-    SPI2_InitStructure.SPI_NSS = SPI_NSS_Soft;		//NSSźӲNSSܽţʹSSIλ:ڲNSSźSSIλ
-    SPI2_InitStructure.SPI_BaudRatePrescaler = SPI_BaudRatePrescaler_8;		//岨ԤƵֵ:ԤƵֵΪ256
-    SPI2_InitStructure.SPI_FirstBit = SPI_FirstBit_MSB;	//ָݴMSBλLSBλʼ:ݴMSBλʼ
-    SPI2_InitStructure.SPI_CRCPolynomial = 7;	//CRCֵĶʽ
-    SPI_Init(SPI2, &SPI2_InitStructure);  //SPI_InitStructָĲʼSPIxĴ
-
-    SPI_Cmd(SPI2, ENABLE); //ʹSPI
-
-    SPI2_ReadWriteByte(0xff);//
-    SPI2_SetSpeed(SPI_BaudRatePrescaler_8);	//Ϊ9Mʱ,ģʽ
+    SPI2_InitStructure.SPI_Direction = SPI_Direction_2Lines_FullDuplex;  //设置SPI单向或者双向的数据模式:SPI设置为双线双向全双工
+    SPI2_InitStructure.SPI_Mode = SPI_Mode_Master;		//设置SPI工作模式:设置为主SPI
+    SPI2_InitStructure.SPI_DataSize = SPI_DataSize_8b;		//设置SPI的数据大小:SPI发送接收8位帧结构
+    SPI2_InitStructure.SPI_CPOL = SPI_CPOL_Low;		//选择了串行时钟的稳态:时钟悬空高
+    SPI2_InitStructure.SPI_CPHA = SPI_CPHA_1Edge;	//数据捕获于第二个时钟沿
+    SPI2_InitStructure.SPI_NSS = SPI_NSS_Soft;		//NSS信号由硬件（NSS管脚）还是软件（使用SSI位）管理:内部NSS信号有SSI位控制
+    SPI2_InitStructure.SPI_BaudRatePrescaler = SPI_BaudRatePrescaler_8;		//定义波特率预分频的值:波特率预分频值为256
+    SPI2_InitStructure.SPI_FirstBit = SPI_FirstBit_MSB;	//指定数据传输从MSB位还是LSB位开始:数据传输从MSB位开始
+    SPI2_InitStructure.SPI_CRCPolynomial = 7;	//CRC值计算的多项式
+    SPI_Init(SPI2, &SPI2_InitStructure);  //根据SPI_InitStruct中指定的参数初始化外设SPIx寄存器
+
+    SPI_Cmd(SPI2, ENABLE); //使能SPI外设
+
+    SPI2_ReadWriteByte(0xff);//启动传输
+    SPI2_SetSpeed(SPI_BaudRatePrescaler_8);	//设置为9M时钟,高速模式
 }
-//SPI ٶú
+//SPI 速度设置函数
 //SpeedSet:
-//SPI_BaudRatePrescaler_2   2Ƶ   (SPI 36M@sys 72M)
-//SPI_BaudRatePrescaler_8   8Ƶ   (SPI 9M@sys 72M)
-//SPI_BaudRatePrescaler_16  16Ƶ  (SPI 4.5M@sys 72M)
-//SPI_BaudRatePrescaler_256 256Ƶ (SPI 281.25K@sys 72M)
+//SPI_BaudRatePrescaler_2   2分频   (SPI 36M@sys 72M)
+//SPI_BaudRatePrescaler_8   8分频   (SPI 9M@sys 72M)
+//SPI_BaudRatePrescaler_16  16分频  (SPI 4.5M@sys 72M)
+//SPI_BaudRatePrescaler_256 256分频 (SPI 281.25K@sys 72M)
 
 void SPI2_SetSpeed(uint8_t SpeedSet)
 {
@@ -117,26 +117,26 @@ void SPI2_SetSpeed(uint8_t SpeedSet)
     SPI_Cmd(SPI2,ENABLE);
 }
 
-//SPIx дһֽ
-//TxData:Ҫдֽ
-//ֵ:ȡֽ
+//SPIx 读写一个字节
+//TxData:要写入的字节
+//返回值:读取到的字节
 uint8_t SPI2_ReadWriteByte(uint8_t TxData)
 {
     uint8_t retry=0;
-    while (SPI_I2S_GetFlagStatus(SPI2, SPI_I2S_FLAG_TXE) == RESET) //ָSPI־λ:ͻձ־λ
+    while (SPI_I2S_GetFlagStatus(SPI2, SPI_I2S_FLAG_TXE) == RESET) //检查指定的SPI标志位设置与否:发送缓存空标志位
     {
         retry++;
         if(retry>200)return 0;
     }
-    SPI_I2S_SendData(SPI1, TxData); //ͨSPIxһ
+    SPI_I2S_SendData(SPI1, TxData); //通过外设SPIx发送一个数据
     retry=0;
 
-    while (SPI_I2S_GetFlagStatus(SPI2, SPI_I2S_FLAG_RXNE) == RESET)//ָSPI־λ:ܻǿձ־λ
+    while (SPI_I2S_GetFlagStatus(SPI2, SPI_I2S_FLAG_RXNE) == RESET)//检查指定的SPI标志位设置与否:接受缓存非空标志位
     {
         retry++;
         if(retry>200)return 0;
     }
-    return SPI_I2S_ReceiveData(SPI2); //ͨSPIxյ
+    return SPI_I2S_ReceiveData(SPI2); //返回通过SPIx最近接收的数据
 }
 
 
@@ -4,18 +4,18 @@ void WFI_SET(void)
 {
     __ASM volatile("wfi");
 }
-//رж
+//关闭所有中断
 void INTX_DISABLE(void)
 {
     __ASM volatile("cpsid i");
 }
-//ж
+//开启所有中断
 void INTX_ENABLE(void)
 {
     __ASM volatile("cpsie i");
 }
-//ջַ
-//addr:ջַ
+//设置栈顶地址
+//addr:栈顶地址
 __asm void MSR_MSP(u32 addr)
 {
     MSR MSP, r0 			//set Main Stack value
@@ -0,0 +1,118 @@
+#include "bsp_timebase.h"
+#include "bsp_delay.h"
+
+static uint32_t tb_last_cyc;     //上次刷新时的DWT计数
+static uint32_t tb_cyc_frac;     //不足1us的剩余周期数
+static uint32_t tb_cyc_per_us;   //每微秒的周期数，0表示未初始化
+static uint32_t tb_us;           //微秒计数
+static uint32_t tb_us_frac;      //不足1ms的剩余微秒数
+static uint32_t tb_ms;           //毫秒计数
+
+/**
+  * @brief  把上次刷新以来的DWT周期数累加到微秒和毫秒计数中
+  * @param  无
+  * @retval 无
+  * @note   调用者负责关中断；余数保留到下次，长时间累加不会产生漂移
+  */
+static void timebase_update(void)
+{
+	uint32_t now = DWT_CYCCNT_REG;
+	uint32_t cyc = now - tb_last_cyc + tb_cyc_frac;
+	uint32_t us = cyc / tb_cyc_per_us;
+	tb_last_cyc = now;
+	tb_cyc_frac = cyc - us * tb_cyc_per_us;
+	tb_us += us;
+	tb_us_frac += us;
+	if(tb_us_frac >= 1000)
+	{
+		tb_ms += tb_us_frac / 1000;
+		tb_us_frac %= 1000;
+	}
+}
+
+/**
+  * @brief  初始化单调时基，重复调用无副作用
+  * @param  无
+  * @retval 无
+  */
+void timebase_init(void)
+{
+#if TIMEBASE_KEEPALIVE
+	TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+#endif
+	if(tb_cyc_per_us)
+		return;
+	delay_cycle_init();
+	tb_cyc_per_us = SystemCoreClock / 1000000;
+	tb_last_cyc = DWT_CYCCNT_REG;
+
+#if TIMEBASE_KEEPALIVE
+	//APB1定时器时钟为72MHz，分频到10kHz
+	RCC_APB1PeriphClockCmd(TIMEBASE_KEEPALIVE_RCC, ENABLE);
+	TIM_TimeBaseStructure.TIM_Period = TIMEBASE_KEEPALIVE_MS * 10 - 1;
+	TIM_TimeBaseStructure.TIM_Prescaler = SystemCoreClock / 10000 - 1;
+	TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+	TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+	TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
+	TIM_TimeBaseInit(TIMEBASE_KEEPALIVE_TIM, &TIM_TimeBaseStructure);
+	TIM_ClearITPendingBit(TIMEBASE_KEEPALIVE_TIM, TIM_IT_Update);
+
+	NVIC_InitStructure.NVIC_IRQChannel = TIMEBASE_KEEPALIVE_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 15;  //最低优先级，只需在59秒内得到执行
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	TIM_ITConfig(TIMEBASE_KEEPALIVE_TIM, TIM_IT_Update, ENABLE);
+	TIM_Cmd(TIMEBASE_KEEPALIVE_TIM, ENABLE);
+#endif
+}
+
+/**
+  * @brief  读取微秒计数
+  * @param  无
+  * @retval 单调递增的32位微秒计数，可在中断中调用
+  * @note   未调用 timebase_init 时在第一次读取时自动初始化（会占用保活定时器）
+  */
+uint32_t timebase_now_us(void)
+{
+	uint32_t primask, us;
+	if(!tb_cyc_per_us)
+		timebase_init();
+	primask = __get_PRIMASK();
+	__disable_irq();
+	timebase_update();
+	us = tb_us;
+	__set_PRIMASK(primask);
+	return us;
+}
+
+/**
+  * @brief  读取毫秒计数
+  * @param  无
+  * @retval 单调递增的32位毫秒计数，可在中断中调用
+  */
+uint32_t timebase_now_ms(void)
+{
+	uint32_t primask, ms;
+	if(!tb_cyc_per_us)
+		timebase_init();
+	primask = __get_PRIMASK();
+	__disable_irq();
+	timebase_update();
+	ms = tb_ms;
+	__set_PRIMASK(primask);
+	return ms;
+}
+
+#if TIMEBASE_KEEPALIVE
+void TIMEBASE_KEEPALIVE_IRQHandler(void)
+{
+	if(TIM_GetITStatus(TIMEBASE_KEEPALIVE_TIM, TIM_IT_Update) != RESET)
+	{
+		TIM_ClearITPendingBit(TIMEBASE_KEEPALIVE_TIM, TIM_IT_Update);
+		(void)timebase_now_us();
+	}
+}
+#endif
@@ -0,0 +1,29 @@
+#ifndef _BSP_TIMEBASE_H
+#define _BSP_TIMEBASE_H
+
+#include <stdint.h>
+#include "stm32f10x.h"
+
+/****************** user port area start ****************/
+/**
+  * 单调时基：由DWT周期计数器扩展得到，微秒和毫秒计数都是完整的32位自由运行计数器
+  * DWT_CYCCNT 在72MHz下约59.6秒回绕一次，两次读取的间隔不能超过这个时间
+  * 开启保活后由一个空闲的定时器周期性中断刷新时基，应用程序不需要关心调用间隔
+  */
+#define TIMEBASE_KEEPALIVE         1              //1: 使用定时器中断保活 0: 由应用程序保证调用间隔
+#define TIMEBASE_KEEPALIVE_TIM     TIM4
+#define TIMEBASE_KEEPALIVE_RCC     RCC_APB1Periph_TIM4
+#define TIMEBASE_KEEPALIVE_IRQn    TIM4_IRQn
+#define TIMEBASE_KEEPALIVE_IRQHandler  TIM4_IRQHandler
+#define TIMEBASE_KEEPALIVE_MS      5000           //保活周期（ms），不超过6553
+/****************** user port area end   ****************/
+
+/**
+  * 时间差直接用无符号减法计算：(uint32_t)(t1 - t0)
+  * timebase_now_us 约71.6分钟回绕一次，timebase_now_ms 约49.7天回绕一次
+  */
+void timebase_init(void);
+uint32_t timebase_now_us(void);
+uint32_t timebase_now_ms(void);
+
+#endif
@@ -1,8 +1,8 @@
-#ifndef _BSP_TIMER_BASIC_H
-#define _BSP_TIMER_BASIC_H
-
-#include "main.h"
-
-
-
-#endif
+#ifndef _BSP_TIMER_BASIC_H
+#define _BSP_TIMER_BASIC_H
+
+#include "main.h"
+
+
+
+#endif
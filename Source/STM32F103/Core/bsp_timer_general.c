@@ -1,242 +1,242 @@
-/**
-  ************************************* Copyright ****************************** 
-  *
-  *                 (C) Copyright 2024,LQH,China, GCU.
-  *                            All Rights Reserved
-  *                              
-  *                                  By LQH
-  *                     
-  *    
-  * FileName   : bsp_timer_general.c   		
-  * Author     : Ǳ(snqx-lgh)			
-  * Date       : 2024-01-04         
-  * Description: CSDNҳ https://blog.csdn.net/wan1234512?type=blog
-			     Giteeַhttps://gitee.com/snqx-lqh  
-				 ļͨöʱĶʱãPWMã벶
-
- * עժҰ˵
- * ע⣺TIM_TimeBaseInitTypeDefṹ5ԱTIM6TIM7ļĴֻ
- * TIM_PrescalerTIM_PeriodʹTIM6TIM7ʱֻʼԱɣ
- * Աͨöʱ͸߼ʱ.
- *-----------------------------------------------------------------------------
- *typedef struct
- *{ TIM_Prescaler            
- *	TIM_CounterMode			 TIMx,x[6,7]ûУ
- *  TIM_Period               
- *  TIM_ClockDivision        TIMx,x[6,7]ûУ
- *  TIM_RepetitionCounter    TIMx,x[1,8,15,16,17]
- *}TIM_TimeBaseInitTypeDef; 
- *-----------------------------------------------------------------------------
- 
-  ******************************************************************************
- */
-
-
-#include "bsp_timer_general.h"
-#include "bsp_led.h"
-
-
-/*
-void TIM3_IRQHandler(void)
-{
-	if (TIM_GetITStatus(TIM3, TIM_IT_Update) != RESET)  //TIM3жϷ
-	{
-
-		TIM_ClearITPendingBit(TIM3, TIM_IT_Update  );   //TIMxжϱ־
-	}
-}
-*/
-
-
-/**
-  * @Name    bsp_timer3_init
-  * @brief   ͨöʱ3Ļʱ
-  * @param   arr: [/] 
-**			 psc: [/] 
-  * @retval
- **/
-
-void bsp_timer3_init(uint16_t arr,uint16_t psc)
-{
-    //ʱӳʼ
-    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3, ENABLE); //ʱʹ
-    //ʱʼ
-    {
-        TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;
-
-        TIM_TimeBaseStructure.TIM_Period    =   arr-1;                      //Զװֵ
-        TIM_TimeBaseStructure.TIM_Prescaler =   psc-1;                    //ԤƵֵ
-        TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;      //ʱӷָ:TDTS = Tck_tim
-        TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;  //TIMϼģʽ
-
-        TIM_TimeBaseInit(TIM3, &TIM_TimeBaseStructure); //ָĲʼTIMxʱλ
-    }
-    //NVICʼ
-    {
-        NVIC_InitTypeDef NVIC_InitStructure;
-
-        NVIC_InitStructure.NVIC_IRQChannel = TIM3_IRQn;              //TIM3ж
-        NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 5;    //ռȼ0
-        NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;           //ȼ3
-        NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;              //IRQͨʹ
-
-        NVIC_Init(&NVIC_InitStructure);  //ʼNVICĴ
-    }
-    //ʱʹԼж
-    {
-        TIM_ITConfig(TIM3,TIM_IT_Update,ENABLE ); //ʹָTIM3ж,ж
-        TIM_Cmd(TIM3, ENABLE);                    //ʹTIMx
-    }
-}
-
-
-/**
-  * @Name    bsp_timer3_pwm_init
-  * @brief   ͨöʱ3PWM TIM3_CH1/2/3/4  A6/A7/B0/B1 
-  * @param   arr: [/] 
-**			 psc: [/] 
-  * @retval
- **/
-
-void bsp_timer3_pwm_init(uint16_t arr,uint16_t psc)
-{
-	//ʱӳʼ
-	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3,  ENABLE);   //
-    RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA, ENABLE);   //ʹGPIOʱʹ
-	//GPIO Init
-	{
-		GPIO_InitTypeDef GPIO_InitStructure;
-		//øΪ,
-		GPIO_InitStructure.GPIO_Pin = GPIO_Pin_6; 
-		GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;  //
-		GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-		
-		GPIO_Init(GPIOA, &GPIO_InitStructure);
-	}
-	//ʱ
-	{
-		TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;
-		TIM_TimeBaseStructure.TIM_Period =     arr-1;  
-		TIM_TimeBaseStructure.TIM_Prescaler =  psc-1; 
-		TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1; //ʱӷָ
-		TIM_TimeBaseStructure.TIM_CounterMode   = TIM_CounterMode_Up;  //TIMϼģʽ
-		TIM_TimeBaseInit(TIM3, &TIM_TimeBaseStructure); 
-	}
-    //ʱȽϹ
-	{
-		TIM_OCInitTypeDef  TIM_OCInitStructure;
-		
-		TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM1; //ѡʱģʽ:TIMȵģʽ1
-		TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Enable; //Ƚʹ
-		TIM_OCInitStructure.TIM_Pulse = 0; //ôװ벶ȽϼĴֵ
-		TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_High; //:TIMȽϼԸ
-		
-		TIM_OC1Init(TIM3, &TIM_OCInitStructure);           //CH1ʼ
-		TIM_OC1PreloadConfig(TIM3, TIM_OCPreload_Enable);  //CH1Ԥװʹ
-	}
-    TIM_Cmd(TIM3, ENABLE);  //ʹTIM1
-}
-
-
-/**
-  * @Name    bsp_timer2_cap_init
-  * @brief   ͨöʱ2벶
-  * @param   : [/] 
-  * @retval
- **/
-
-void bsp_timer2_cap_init(uint16_t arr,uint16_t psc)
-{
-	//ʱ
-	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);	//ʹTIM2ʱ
-    RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA, ENABLE);  //ʹGPIOAʱ
-	//GPIO
-	{
-		GPIO_InitTypeDef GPIO_InitStructure;
-		GPIO_InitStructure.GPIO_Pin  = GPIO_Pin_0;  //PA0 ֮ǰ
-		GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IPD; //PA0 
-		
-		GPIO_Init(GPIOA, &GPIO_InitStructure);
-		GPIO_ResetBits(GPIOA,GPIO_Pin_0);						 //PA0 
-	}
-	//BASE_TIMER
-	{
-		TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;
-		
-		TIM_TimeBaseStructure.TIM_Period = arr-1; //趨Զװֵ
-		TIM_TimeBaseStructure.TIM_Prescaler =psc-1; 	//ԤƵ
-		TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1; //ʱӷָ:TDTS = Tck_tim
-		TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;  //TIMϼģʽ
-		TIM_TimeBaseInit(TIM2, &TIM_TimeBaseStructure); //TIM_TimeBaseInitStructָĲʼTIMxʱλ
-	}
-	//벶
-	{
-		TIM_ICInitTypeDef  TIM2_ICInitStructure;
-		
-		TIM2_ICInitStructure.TIM_Channel = TIM_Channel_1; //ͨ
-		TIM2_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_Rising;	//ز
-		TIM2_ICInitStructure.TIM_ICSelection = TIM_ICSelection_DirectTI; //ͨͲͨӳϵֱͷֱ
-		TIM2_ICInitStructure.TIM_ICPrescaler = TIM_ICPSC_DIV1;	 //Ƶ,Ƶ
-		TIM2_ICInitStructure.TIM_ICFilter = 0x00;//IC1F=0000 ˲ ˲
-		TIM_ICInit(TIM2, &TIM2_ICInitStructure);
-	}
-	//NVIC
-	{
-		NVIC_InitTypeDef NVIC_InitStructure;
-		
-		NVIC_InitStructure.NVIC_IRQChannel = TIM2_IRQn; 
-		NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 5;  
-		NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0; 
-		NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE; //IRQͨʹ
-		NVIC_Init(&NVIC_InitStructure);  //NVIC_InitStructָĲʼNVICĴ
-	}
-	
-	TIM_ITConfig(TIM2,TIM_IT_Update|TIM_IT_CC1,ENABLE);//ж ,CC1IEж
-
-    TIM_Cmd(TIM2,ENABLE ); 	//ʹܶʱ2
-}
-
-u8  TIM2CH1_CAPTURE_STA=0;	//벶״̬
-u16	TIM2CH1_CAPTURE_VAL;	//벶ֵ
-
-//ʱ5жϷ
-void TIM2_IRQHandler(void)
-{
-    if((TIM2CH1_CAPTURE_STA&0X80)==0)//δɹ
-    {
-        if (TIM_GetITStatus(TIM2, TIM_IT_Update) != RESET)
-
-        {
-            if(TIM2CH1_CAPTURE_STA&0X40)//Ѿ񵽸ߵƽ
-            {
-                if((TIM2CH1_CAPTURE_STA&0X3F)==0X3F)//ߵƽ̫
-                {
-                    TIM2CH1_CAPTURE_STA|=0X80;//ǳɹһ
-                    TIM2CH1_CAPTURE_VAL=0XFFFF;
-                } else TIM2CH1_CAPTURE_STA++;
-            }
-        }
-        if (TIM_GetITStatus(TIM2, TIM_IT_CC1) != RESET)//1¼
-        {
-            if(TIM2CH1_CAPTURE_STA&0X40)		//һ½
-            {
-                TIM2CH1_CAPTURE_STA|=0X80;		//ǳɹһ
-                TIM2CH1_CAPTURE_VAL=TIM_GetCapture1(TIM2);
-                TIM_OC1PolarityConfig(TIM2,TIM_ICPolarity_Rising); //CC1P=0 Ϊز
-            } else  								//δʼ,һβ
-            {
-                TIM2CH1_CAPTURE_STA=0;			//
-                TIM2CH1_CAPTURE_VAL=0;
-                TIM_SetCounter(TIM2,0);
-                TIM2CH1_CAPTURE_STA|=0X40;		//ǲ
-                TIM_OC1PolarityConfig(TIM2,TIM_ICPolarity_Falling);		//CC1P=1 Ϊ½ز
-            }
-        }
-    }
-
-    TIM_ClearITPendingBit(TIM2, TIM_IT_CC1|TIM_IT_Update); //жϱ־λ
-
-}
-
-
-
+/**
+  ************************************* Copyright ****************************** 
+  *
+  *                 (C) Copyright 2024,LQH,China, GCU.
+  *                            All Rights Reserved
+  *                              
+  *                                  By LQH
+  *                     
+  *    
+  * FileName   : bsp_timer_general.c   		
+  * Author     : 少年潜行(snqx-lgh)			
+  * Date       : 2024-01-04         
+  * Description: CSDN主页： https://blog.csdn.net/wan1234512?type=blog
+			     Gitee地址：https://gitee.com/snqx-lqh  
+				 该文件将包含通用定时器的定时配置，PWM输出配置，输入捕获配置
+
+ * 下面注释摘自野火说明
+ * 注意：TIM_TimeBaseInitTypeDef结构体里面有5个成员，TIM6和TIM7的寄存器里面只有
+ * TIM_Prescaler和TIM_Period，所以使用TIM6和TIM7的时候只需初始化这两个成员即可，
+ * 另外三个成员是通用定时器和高级定时器才有.
+ *-----------------------------------------------------------------------------
+ *typedef struct
+ *{ TIM_Prescaler            都有
+ *	TIM_CounterMode			 TIMx,x[6,7]没有，其他都有
+ *  TIM_Period               都有
+ *  TIM_ClockDivision        TIMx,x[6,7]没有，其他都有
+ *  TIM_RepetitionCounter    TIMx,x[1,8,15,16,17]才有
+ *}TIM_TimeBaseInitTypeDef; 
+ *-----------------------------------------------------------------------------
+ 
+  ******************************************************************************
+ */
+
+
+#include "bsp_timer_general.h"
+#include "bsp_led.h"
+
+
+/*
+void TIM3_IRQHandler(void)
+{
+	if (TIM_GetITStatus(TIM3, TIM_IT_Update) != RESET)  //检查TIM3更新中断发生与否
+	{
+
+		TIM_ClearITPendingBit(TIM3, TIM_IT_Update  );   //清除TIMx更新中断标志
+	}
+}
+*/
+
+
+/**
+  * @Name    bsp_timer3_init
+  * @brief   通用定时器3的基本定时配置
+  * @param   arr: [输入/出] 
+**			 psc: [输入/出] 
+  * @retval
+ **/
+
+void bsp_timer3_init(uint16_t arr,uint16_t psc)
+{
+    //时钟初始化
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3, ENABLE); //时钟使能
+    //定时器初始化
+    {
+        TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;
+
+        TIM_TimeBaseStructure.TIM_Period    =   arr-1;                      //设置自动重装载值
+        TIM_TimeBaseStructure.TIM_Prescaler =   psc-1;                    //设置预分频值
+        TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;      //设置时钟分割:TDTS = Tck_tim
+        TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;  //TIM向上计数模式
+
+        TIM_TimeBaseInit(TIM3, &TIM_TimeBaseStructure); //根据指定的参数初始化TIMx的时间基数单位
+    }
+    //NVIC初始化
+    {
+        NVIC_InitTypeDef NVIC_InitStructure;
+
+        NVIC_InitStructure.NVIC_IRQChannel = TIM3_IRQn;              //TIM3中断
+        NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 5;    //先占优先级0级
+        NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;           //从优先级3级
+        NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;              //IRQ通道被使能
+
+        NVIC_Init(&NVIC_InitStructure);  //初始化NVIC寄存器
+    }
+    //定时器使能以及开启中断
+    {
+        TIM_ITConfig(TIM3,TIM_IT_Update,ENABLE ); //使能指定的TIM3中断,允许更新中断
+        TIM_Cmd(TIM3, ENABLE);                    //使能TIMx
+    }
+}
+
+
+/**
+  * @Name    bsp_timer3_pwm_init
+  * @brief   通用定时器3的PWM输出配置 TIM3_CH1/2/3/4  A6/A7/B0/B1 
+  * @param   arr: [输入/出] 
+**			 psc: [输入/出] 
+  * @retval
+ **/
+
+void bsp_timer3_pwm_init(uint16_t arr,uint16_t psc)
+{
+	//时钟初始化
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3,  ENABLE);   //
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA, ENABLE);   //使能GPIO外设时钟使能
+	//GPIO Init
+	{
+		GPIO_InitTypeDef GPIO_InitStructure;
+		//设置该引脚为复用输出功能,
+		GPIO_InitStructure.GPIO_Pin = GPIO_Pin_6; 
+		GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;  //复用推挽输出
+		GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+		
+		GPIO_Init(GPIOA, &GPIO_InitStructure);
+	}
+	//定时器基础配置
+	{
+		TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;
+		TIM_TimeBaseStructure.TIM_Period =     arr-1;  
+		TIM_TimeBaseStructure.TIM_Prescaler =  psc-1; 
+		TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1; //设置时钟分割
+		TIM_TimeBaseStructure.TIM_CounterMode   = TIM_CounterMode_Up;  //TIM向上计数模式
+		TIM_TimeBaseInit(TIM3, &TIM_TimeBaseStructure); 
+	}
+    //定时器输出比较功能配置
+	{
+		TIM_OCInitTypeDef  TIM_OCInitStructure;
+		
+		TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM1; //选择定时器模式:TIM脉冲宽度调制模式1
+		TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Enable; //比较输出使能
+		TIM_OCInitStructure.TIM_Pulse = 0; //设置待装入捕获比较寄存器的脉冲值
+		TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_High; //输出极性:TIM输出比较极性高
+		
+		TIM_OC1Init(TIM3, &TIM_OCInitStructure);           //CH1初始化
+		TIM_OC1PreloadConfig(TIM3, TIM_OCPreload_Enable);  //CH1预装载使能
+	}
+    TIM_Cmd(TIM3, ENABLE);  //使能TIM1
+}
+
+
+/**
+  * @Name    bsp_timer2_cap_init
+  * @brief   通用定时器2的输入捕获配置
+  * @param   : [输入/出] 
+  * @retval
+ **/
+
+void bsp_timer2_cap_init(uint16_t arr,uint16_t psc)
+{
+	//时钟
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);	//使能TIM2时钟
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA, ENABLE);  //使能GPIOA时钟
+	//GPIO
+	{
+		GPIO_InitTypeDef GPIO_InitStructure;
+		GPIO_InitStructure.GPIO_Pin  = GPIO_Pin_0;  //PA0 清除之前设置
+		GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IPD; //PA0 输入
+		
+		GPIO_Init(GPIOA, &GPIO_InitStructure);
+		GPIO_ResetBits(GPIOA,GPIO_Pin_0);						 //PA0 下拉
+	}
+	//BASE_TIMER
+	{
+		TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;
+		
+		TIM_TimeBaseStructure.TIM_Period = arr-1; //设定计数器自动重装值
+		TIM_TimeBaseStructure.TIM_Prescaler =psc-1; 	//预分频器
+		TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1; //设置时钟分割:TDTS = Tck_tim
+		TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;  //TIM向上计数模式
+		TIM_TimeBaseInit(TIM2, &TIM_TimeBaseStructure); //根据TIM_TimeBaseInitStruct中指定的参数初始化TIMx的时间基数单位
+	}
+	//输入捕获配置
+	{
+		TIM_ICInitTypeDef  TIM2_ICInitStructure;
+		
+		TIM2_ICInitStructure.TIM_Channel = TIM_Channel_1; //通道
+		TIM2_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_Rising;	//上升沿捕获
+		TIM2_ICInitStructure.TIM_ICSelection = TIM_ICSelection_DirectTI; //输入通道和捕获通道的映射关系，有直连和非直连两种
+		TIM2_ICInitStructure.TIM_ICPrescaler = TIM_ICPSC_DIV1;	 //配置输入分频,不分频
+		TIM2_ICInitStructure.TIM_ICFilter = 0x00;//IC1F=0000 配置输入滤波器 不滤波
+		TIM_ICInit(TIM2, &TIM2_ICInitStructure);
+	}
+	//NVIC
+	{
+		NVIC_InitTypeDef NVIC_InitStructure;
+		
+		NVIC_InitStructure.NVIC_IRQChannel = TIM2_IRQn; 
+		NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 5;  
+		NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0; 
+		NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE; //IRQ通道被使能
+		NVIC_Init(&NVIC_InitStructure);  //根据NVIC_InitStruct中指定的参数初始化外设NVIC寄存器
+	}
+	
+	TIM_ITConfig(TIM2,TIM_IT_Update|TIM_IT_CC1,ENABLE);//允许更新中断 ,允许CC1IE捕获中断
+
+    TIM_Cmd(TIM2,ENABLE ); 	//使能定时器2
+}
+
+u8  TIM2CH1_CAPTURE_STA=0;	//输入捕获状态
+u16	TIM2CH1_CAPTURE_VAL;	//输入捕获值
+
+//定时器5中断服务程序
+void TIM2_IRQHandler(void)
+{
+    if((TIM2CH1_CAPTURE_STA&0X80)==0)//还未成功捕获
+    {
+        if (TIM_GetITStatus(TIM2, TIM_IT_Update) != RESET)
+
+        {
+            if(TIM2CH1_CAPTURE_STA&0X40)//已经捕获到高电平了
+            {
+                if((TIM2CH1_CAPTURE_STA&0X3F)==0X3F)//高电平太长了
+                {
+                    TIM2CH1_CAPTURE_STA|=0X80;//标记成功捕获了一次
+                    TIM2CH1_CAPTURE_VAL=0XFFFF;
+                } else TIM2CH1_CAPTURE_STA++;
+            }
+        }
+        if (TIM_GetITStatus(TIM2, TIM_IT_CC1) != RESET)//捕获1发生捕获事件
+        {
+            if(TIM2CH1_CAPTURE_STA&0X40)		//捕获到一个下降沿
+            {
+                TIM2CH1_CAPTURE_STA|=0X80;		//标记成功捕获到一次上升沿
+                TIM2CH1_CAPTURE_VAL=TIM_GetCapture1(TIM2);
+                TIM_OC1PolarityConfig(TIM2,TIM_ICPolarity_Rising); //CC1P=0 设置为上升沿捕获
+            } else  								//还未开始,第一次捕获上升沿
+            {
+                TIM2CH1_CAPTURE_STA=0;			//清空
+                TIM2CH1_CAPTURE_VAL=0;
+                TIM_SetCounter(TIM2,0);
+                TIM2CH1_CAPTURE_STA|=0X40;		//标记捕获到了上升沿
+                TIM_OC1PolarityConfig(TIM2,TIM_ICPolarity_Falling);		//CC1P=1 设置为下降沿捕获
+            }
+        }
+    }
+
+    TIM_ClearITPendingBit(TIM2, TIM_IT_CC1|TIM_IT_Update); //清除中断标志位
+
+}
+
+
+
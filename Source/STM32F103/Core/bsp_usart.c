@@ -17,22 +17,22 @@ void USART1_IRQHandler(void)
     }
 }
 
-//ضc⺯printfڣضʹprintf
+//重定向c库函数printf到串口，重定向后可使用printf函数
 int fputc(int ch, FILE *f)
 {
-    /* һֽݵ */
+    /* 发送一个字节数据到串口 */
     USART_SendData(USART1, (uint8_t) ch);
 
-    /* ȴ */
+    /* 等待发送完毕 */
     while (USART_GetFlagStatus(USART1, USART_FLAG_TXE) == RESET);
 
     return (ch);
 }
 
-///ضc⺯scanfڣдʹscanfgetcharȺ
+///重定向c库函数scanf到串口，重写向后可使用scanf、getchar等函数
 int fgetc(FILE *f)
 {
-    /* ȴ */
+    /* 等待串口输入数据 */
     while (USART_GetFlagStatus(USART1, USART_FLAG_RXNE) == RESET);
 
     return (int)USART_ReceiveData(USART1);
@@ -41,8 +41,8 @@ int fgetc(FILE *f)
 void bsp_usart1_init(u32 bound)
 {
     RCC_APB2PeriphClockCmd(RCC_APB2Periph_USART1|
-                           RCC_APB2Periph_GPIOA,  ENABLE);	//ʹUSART1GPIOAʱ
-    //GPIO˿
+                           RCC_APB2Periph_GPIOA,  ENABLE);	//使能USART1，GPIOA时钟
+    //GPIO端口设置
     {
         GPIO_InitTypeDef GPIO_InitStructure;
         //USART1_TX   GPIOA.9
@@ -51,34 +51,34 @@ void bsp_usart1_init(u32 bound)
         GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
         GPIO_Init(GPIOA, &GPIO_InitStructure);
 
-        //USART1_RX	  GPIOA.10ʼ
+        //USART1_RX	  GPIOA.10初始化
         GPIO_InitStructure.GPIO_Pin = GPIO_Pin_10;
         GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
         GPIO_Init(GPIOA, &GPIO_InitStructure);
     }
-    //Usart1 NVIC 
+    //Usart1 NVIC 配置
     {
         NVIC_InitTypeDef NVIC_InitStructure;
 
         NVIC_InitStructure.NVIC_IRQChannel = USART1_IRQn;
-        NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority=5 ;//ռȼ5
-        NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;		//ȼ0
-        NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;			//IRQͨʹ
-        NVIC_Init(&NVIC_InitStructure);	//ָĲʼNVICĴ
+        NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority=5 ;//抢占优先级5
+        NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;		//子优先级0
+        NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;			//IRQ通道使能
+        NVIC_Init(&NVIC_InitStructure);	//根据指定的参数初始化NVIC寄存器
     }
-    //USART ʼ
+    //USART 初始化设置
     {
         USART_InitTypeDef USART_InitStructure;
-        USART_InitStructure.USART_BaudRate = bound;//ڲ
-        USART_InitStructure.USART_WordLength = USART_WordLength_8b;//ֳΪ8λݸʽ
-        USART_InitStructure.USART_StopBits = USART_StopBits_1;//һֹͣλ
-        USART_InitStructure.USART_Parity = USART_Parity_No;//żУλ
-        USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;//Ӳ
-        USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;	//շģʽ
+        USART_InitStructure.USART_BaudRate = bound;//串口波特率
+        USART_InitStructure.USART_WordLength = USART_WordLength_8b;//字长为8位数据格式
+        USART_InitStructure.USART_StopBits = USART_StopBits_1;//一个停止位
+        USART_InitStructure.USART_Parity = USART_Parity_No;//无奇偶校验位
+        USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;//无硬件数据流控制
+        USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;	//收发模式
 
-        USART_Init(USART1, &USART_InitStructure); //ʼ1
-        USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);//ڽж
-        USART_Cmd(USART1, ENABLE);                    //ʹܴ1
+        USART_Init(USART1, &USART_InitStructure); //初始化串口1
+        USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);//开启串口接受中断
+        USART_Cmd(USART1, ENABLE);                    //使能串口1
     }
 }
 
@@ -4,7 +4,7 @@
 #include "main.h"
 
 /*
-ں    ûӳ    ӳ   ȫӳ
+串口号    没有重映像    部分重映像   全部重映像
 1			A9/A10	                    B6/B7
 2           A2/A3                       D5/D6
 3           B10/B11       C10/C11       D8/D9
@@ -0,0 +1,178 @@
+/**
+  ******************************************************************************
+  * @file    ahrs_check.c
+  * @brief   У飺 Mahony/Madgwick ں븡ο̬
+  *
+  * @details
+  *          ȷԵĺϳIMUУҽٶ + ƫ + ٶΪϵ
+  *          һξֹͬʱں˺ͶںˣߵԪ
+  *          ˫ȻΪŷǺȽϣͷ1Ρͷļʱ
+  *          ط0ο invSqrt ʹţٵο
+  *
+  *          ڲֿĿ¼ִУ
+  *          gcc -O2 -DSTM32F10X_MD -DUSE_STDPERIPH_DRIVER -DINV_SQRT_NEWTON_STEPS=2 \
+  *              -IExample/01_MPU6050 -ISource/STM32F103/CMSIS -ISource/STM32F103/STM32F10x \
+  *              -ISource/STM32F103/Library/inc -ISource/DeviceLib/MPU6050/Algorithm \
+  *              Tools/host/ahrs_check.c Source/DeviceLib/MPU6050/Algorithm/MahonyAHRS.c \
+  *              Source/DeviceLib/MPU6050/Algorithm/MadgwickAHRS.c Source/DeviceLib/MPU6050/Algorithm/FixedPoint.c \
+  *              Source/DeviceLib/MPU6050/Algorithm/FastInvSqrt.c Source/DeviceLib/MPU6050/Algorithm/FastTrig.c \
+  *              Source/DeviceLib/MPU6050/Algorithm/Quaternion.c -lm -o ahrs_check && ./ahrs_check
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <math.h>
+#include "MahonyAHRS.h"
+#include "MadgwickAHRS.h"
+
+#define RATE_HZ        1000
+#define RUN_S          20
+#define STILL_S        5         //һξֹʱ䣬ƫ
+#define SKIP_S         1         //Σ
+#define GYRO_BIAS      0.01      //ƫrad/s
+#define GYRO_NOISE     0.005
+#define ACC_NOISE      0.05
+#define GRAVITY        9.80665
+#define RAD2DEG        57.29577951308232
+
+static unsigned int rng = 12345;
+
+//ȷԾ [-a, a]
+static double noise(double a)
+{
+	rng = rng * 1103515245u + 12345u;
+	return a * (((rng >> 8) & 0xFFFF) / 32767.5 - 1.0);
+}
+
+static void quat_to_euler(const double *q, double *e)
+{
+	e[0] = atan2(2 * (q[2] * q[3] + q[0] * q[1]), 1 - 2 * (q[1] * q[1] + q[2] * q[2])) * RAD2DEG;
+	e[1] = asin(fmax(-1.0, fmin(1.0, 2 * (q[0] * q[2] - q[1] * q[3])))) * RAD2DEG;
+	e[2] = atan2(2 * (q[0] * q[3] + q[1] * q[2]), q[0] * q[0] + q[1] * q[1] - q[2] * q[2] - q[3] * q[3]) * RAD2DEG;
+}
+
+static double angle_diff(double a, double b)
+{
+	double d = a - b;
+	while(d > 180) d -= 360;
+	while(d < -180) d += 360;
+	return fabs(d);
+}
+
+typedef struct {
+	const char *name;
+	double bound;                //ȣ
+	double max, sum2;
+	long n;
+}result_t;
+
+static void accumulate(result_t *r, const double *qf, const double *qx)
+{
+	double ef[3], ex[3], d;
+	int i;
+
+	quat_to_euler(qf, ef);
+	quat_to_euler(qx, ex);
+	for(i = 0; i < 3; i++)
+	{
+		d = angle_diff(ef[i], ex[i]);
+		if(d > r->max) r->max = d;
+		r->sum2 += d * d;
+		r->n++;
+	}
+}
+
+//ϳʵٶȣ᲻ͬƵʵң STILL_S 뾲ֹ
+static void true_rate(double t, double *w)
+{
+	if(t >= RUN_S - STILL_S)
+	{
+		w[0] = w[1] = w[2] = 0;
+		return;
+	}
+	w[0] = 0.8 * sin(2 * M_PI * 0.31 * t);
+	w[1] = 0.6 * sin(2 * M_PI * 0.17 * t + 1.0);
+	w[2] = 1.0 * sin(2 * M_PI * 0.07 * t + 2.0);
+}
+
+int main(void)
+{
+	mahony_t mf, mf0;
+	mahony_fixed_t mx, mx0;
+	madgwick_t gf;
+	madgwick_fixed_t gx;
+	result_t res[3] = {
+		{ "Mahony   Ki=0.1", MAHONY_FIXED_ERR_DEG, 0, 0, 0 },
+		{ "Mahony   Ki=0  ", MAHONY_FIXED_ERR_DEG, 0, 0, 0 },
+		{ "Madgwick       ", MADGWICK_FIXED_ERR_DEG, 0, 0, 0 },
+	};
+	double q[4] = {1, 0, 0, 0}, w[3], g[3], a[3], gm[3], h[4], qn;
+	double dt = 1.0 / RATE_HZ, t;
+	q30_t dtq = Q30_FROM_US(1000000 / RATE_HZ);
+	float qf[4];
+	double qd[4], qxd[4];
+	long k, steps = (long)RUN_S * RATE_HZ;
+	int i, fail = 0;
+
+	mahony_init(&mf, 2.5f, 0.1f);
+	mahony_fixed_init(&mx, 2.5f, 0.1f);
+	mahony_init(&mf0, 2.5f, 0.0f);
+	mahony_fixed_init(&mx0, 2.5f, 0.0f);
+	madgwick_init(&gf, 0.0f);
+	madgwick_fixed_init(&gx, 0.0f);
+
+	for(k = 0; k < steps; k++)
+	{
+		t = k * dt;
+		true_rate(t, w);
+
+		//ʵ̬֣˫ȣһԪºһ
+		h[0] = -q[1] * w[0] - q[2] * w[1] - q[3] * w[2];
+		h[1] =  q[0] * w[0] + q[2] * w[2] - q[3] * w[1];
+		h[2] =  q[0] * w[1] - q[1] * w[2] + q[3] * w[0];
+		h[3] =  q[0] * w[2] + q[1] * w[1] - q[2] * w[0];
+		for(i = 0; i < 4; i++) q[i] += 0.5 * dt * h[i];
+		qn = sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+		for(i = 0; i < 4; i++) q[i] /= qn;
+
+		//ϵתУ
+		g[0] = 2 * (q[1] * q[3] - q[0] * q[2]);
+		g[1] = 2 * (q[0] * q[1] + q[2] * q[3]);
+		g[2] = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+		for(i = 0; i < 3; i++)
+		{
+			a[i] = g[i] * GRAVITY + noise(ACC_NOISE);
+			gm[i] = w[i] + GYRO_BIAS + noise(GYRO_NOISE);
+		}
+
+		mahony_update_imu(&mf, (float)gm[0], (float)gm[1], (float)gm[2], (float)a[0], (float)a[1], (float)a[2], (float)dt);
+		mahony_update_imu(&mf0, (float)gm[0], (float)gm[1], (float)gm[2], (float)a[0], (float)a[1], (float)a[2], (float)dt);
+		madgwick_update_imu(&gf, (float)gm[0], (float)gm[1], (float)gm[2], (float)a[0], (float)a[1], (float)a[2], (float)dt);
+#define Q16(x) ((q16_t)lround((x) * 65536.0))
+		mahony_update_imu_fixed(&mx, Q16(gm[0]), Q16(gm[1]), Q16(gm[2]), Q16(a[0]), Q16(a[1]), Q16(a[2]), dtq);
+		mahony_update_imu_fixed(&mx0, Q16(gm[0]), Q16(gm[1]), Q16(gm[2]), Q16(a[0]), Q16(a[1]), Q16(a[2]), dtq);
+		madgwick_update_imu_fixed(&gx, Q16(gm[0]), Q16(gm[1]), Q16(gm[2]), Q16(a[0]), Q16(a[1]), Q16(a[2]), dtq);
+
+		if(t < SKIP_S)
+			continue;
+		mahony_get_quat(&mf, qf);
+		for(i = 0; i < 4; i++) { qd[i] = qf[i]; qxd[i] = mx.q[i] / 1073741824.0; }
+		accumulate(&res[0], qd, qxd);
+		mahony_get_quat(&mf0, qf);
+		for(i = 0; i < 4; i++) { qd[i] = qf[i]; qxd[i] = mx0.q[i] / 1073741824.0; }
+		accumulate(&res[1], qd, qxd);
+		madgwick_get_quat(&gf, qf);
+		for(i = 0; i < 4; i++) { qd[i] = qf[i]; qxd[i] = gx.q[i] / 1073741824.0; }
+		accumulate(&res[2], qd, qxd);
+	}
+
+	printf("%d Hz, %d s (last %d s still), Euler error of fixed vs float kernel (deg)\n", RATE_HZ, RUN_S, STILL_S);
+	printf("kernel            max        rms        bound\n");
+	for(i = 0; i < 3; i++)
+	{
+		printf("%s  %.5f    %.5f    %.3f %s\n", res[i].name, res[i].max, sqrt(res[i].sum2 / res[i].n),
+		       res[i].bound, res[i].max <= res[i].bound ? "ok" : "FAIL");
+		if(res[i].max > res[i].bound)
+			fail = 1;
+	}
+	return fail;
+}
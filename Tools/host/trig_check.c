@@ -0,0 +1,127 @@
+/**
+  ******************************************************************************
+  * @file    trig_check.c
+  * @brief   У飺FastTrig ȵλ汾ͺʱ
+  *
+  * @details
+  *          atan21e6 Χڵȷԣķ֮һᡢķ֮һΪ 64 ڵСֵ
+  *          Լ 1024 ڵȫԣasin[-1, 1] Ͼȡ㡣οֵΪ˫ atan2/asin
+  *          汾Ĳοֵ㣬뱾롣
+  *          ÿʵٶͬһʱϵ ns/ΣֻڱȽԿSTM32ϵ
+  *          汾 FastTrig.h е FAST_TRIG_Q16_ERR_DEG ʱط0
+  *
+  *          λΪѡÿλһΣڲֿĿ¼ִУ
+  *          for n in 0 1 2; do gcc -O2 -DFAST_TRIG_ACCURACY=$n -DSTM32F10X_MD -DUSE_STDPERIPH_DRIVER \
+  *              -IExample/01_MPU6050 -ISource/STM32F103/CMSIS -ISource/STM32F103/STM32F10x \
+  *              -ISource/STM32F103/Library/inc -ISource/DeviceLib/MPU6050/Algorithm \
+  *              Tools/host/trig_check.c Source/DeviceLib/MPU6050/Algorithm/FastTrig.c \
+  *              Source/DeviceLib/MPU6050/Algorithm/FixedPoint.c Source/DeviceLib/MPU6050/Algorithm/FastInvSqrt.c \
+  *              -lm -o trig_check && ./trig_check || break; done
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "FastTrig.h"
+
+#define ATAN2_N        2000000
+#define ATAN2_RANGE    1000000
+#define GRID           1024
+#define ASIN_N         2000001
+#define RAD2DEG        57.29577951308232
+
+static int32_t in_y[ATAN2_N], in_x[ATAN2_N];
+static float   in_s[ASIN_N];
+static q30_t   in_q[ASIN_N];
+static volatile float  sink_f;
+static volatile q16_t  sink_q;
+
+static unsigned int rng = 12345;
+
+//ȷԾ [-a, a]
+static int32_t rand_int(int32_t a)
+{
+	rng = rng * 1103515245u + 12345u;
+	return (int32_t)(((rng >> 1) % (2u * (uint32_t)a + 1)) - (uint32_t)a);
+}
+
+static double angle_diff(double a, double b)
+{
+	double d = fabs(a - b);
+	return d > 180 ? 360 - d : d;
+}
+
+//Եʵֵֵ
+static void atan2_err(int32_t y, int32_t x, double *ef, double *eq)
+{
+	double ref, e;
+
+	if(x == 0 && y == 0)
+		return;
+	ref = atan2((double)(float)y, (double)(float)x) * RAD2DEG;
+	e = angle_diff(fast_atan2f((float)y, (float)x) * RAD2DEG, ref);
+	if(e > *ef) *ef = e;
+	ref = atan2((double)y, (double)x) * RAD2DEG;
+	e = angle_diff(fast_atan2_deg_q16(y, x) / 65536.0, ref);
+	if(e > *eq) *eq = e;
+}
+
+//ʱns/
+static double elapsed_ns(clock_t t0, long n)
+{
+	return (double)(clock() - t0) / CLOCKS_PER_SEC * 1e9 / n;
+}
+
+int main(void)
+{
+	double atan2_f = 0, atan2_q = 0, asin_f = 0, asin_q = 0, ref, e;
+	double t_atan2_f, t_atan2_q, t_asin_f, t_asin_q;
+	clock_t t0;
+	long i;
+	int32_t y, x;
+	int fail;
+
+	for(i = 0; i < ATAN2_N; i++)
+	{
+		in_y[i] = rand_int(ATAN2_RANGE);
+		in_x[i] = rand_int(ATAN2_RANGE);
+		if(i % 4 == 1) in_y[i] /= 1000;                          //
+		if(i % 4 == 2) { in_y[i] = rand_int(64); in_x[i] = rand_int(64); }
+		atan2_err(in_y[i], in_x[i], &atan2_f, &atan2_q);
+	}
+	for(y = -GRID; y <= GRID; y++)
+		for(x = -GRID; x <= GRID; x++)
+			atan2_err(y, x, &atan2_f, &atan2_q);
+
+	for(i = 0; i < ASIN_N; i++)
+	{
+		ref = -1.0 + 2.0 * i / (ASIN_N - 1);
+		in_s[i] = (float)ref;
+		in_q[i] = (q30_t)lrint(ref * 1073741824.0);
+		e = fabs(fast_asinf(in_s[i]) * RAD2DEG - asin((double)in_s[i]) * RAD2DEG);
+		if(e > asin_f) asin_f = e;
+		e = fabs(fast_asin_deg_q16(in_q[i]) / 65536.0 - asin(in_q[i] / 1073741824.0) * RAD2DEG);
+		if(e > asin_q) asin_q = e;
+	}
+
+	t0 = clock();
+	for(i = 0; i < ATAN2_N; i++) sink_f = fast_atan2f((float)in_y[i], (float)in_x[i]);
+	t_atan2_f = elapsed_ns(t0, ATAN2_N);
+	t0 = clock();
+	for(i = 0; i < ATAN2_N; i++) sink_q = fast_atan2_deg_q16(in_y[i], in_x[i]);
+	t_atan2_q = elapsed_ns(t0, ATAN2_N);
+	t0 = clock();
+	for(i = 0; i < ASIN_N; i++) sink_f = fast_asinf(in_s[i]);
+	t_asin_f = elapsed_ns(t0, ASIN_N);
+	t0 = clock();
+	for(i = 0; i < ASIN_N; i++) sink_q = fast_asin_deg_q16(in_q[i]);
+	t_asin_q = elapsed_ns(t0, ASIN_N);
+
+	printf("| impl      | atan2 max err (deg) | asin max err (deg) | atan2 ns | asin ns |\n");
+	printf("| float %d   | %-19.2e | %-18.2e | %-8.1f | %-7.1f |\n", FAST_TRIG_ACCURACY, atan2_f, asin_f, t_atan2_f, t_asin_f);
+	printf("| fixed Q16 | %-19.2e | %-18.2e | %-8.1f | %-7.1f |\n", atan2_q, asin_q, t_atan2_q, t_asin_q);
+
+	fail = atan2_q > FAST_TRIG_Q16_ERR_DEG || asin_q > FAST_TRIG_Q16_ERR_DEG;
+	printf("%s (fixed bound %.1e deg)\n", fail ? "FAIL" : "PASS", FAST_TRIG_Q16_ERR_DEG);
+	return fail;
+}